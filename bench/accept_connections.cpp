@@ -0,0 +1,180 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "sockutils.h"
+#include "utils.h"
+
+namespace {
+
+// The pre-accept4() per-call path: accept(), then two fcntl() round trips and peer formatting.
+void BM_AcceptFcntl(benchmark::State& state)
+{
+    const auto batch = static_cast<std::size_t>(state.range(0));
+    const loopback_listener listener;
+    std::vector<int> clients;
+    std::vector<int> accepted;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        listener.connect_clients(batch, clients);
+        state.ResumeTiming();
+
+        for (std::size_t i = 0; i < batch; ++i) {
+            sockaddr_storage addr{};
+            socklen_t len = sizeof(addr);
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            const auto sock = accept(listener.sock(), reinterpret_cast<sockaddr*>(&addr), &len);
+            psb::make_nonblocking(sock);
+            psb::make_close_on_exec(sock);
+            benchmark::DoNotOptimize(psb::get_socket_info(addr, len));
+            accepted.push_back(sock);
+        }
+
+        state.PauseTiming();
+        close_all(accepted);
+        close_all(clients);
+        state.ResumeTiming();
+    }
+
+    set_counters(state, batch);
+}
+
+// Current per-call path: accept_connection() until the queue is drained (which ends with an exception).
+void BM_AcceptConnection(benchmark::State& state)
+{
+    const auto batch = static_cast<std::size_t>(state.range(0));
+    const loopback_listener listener;
+    std::vector<int> clients;
+    std::vector<int> accepted;
+    accepted.reserve(batch);
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        listener.connect_clients(batch, clients);
+        state.ResumeTiming();
+
+        const auto start = allocation_count();
+        try {
+            for (;;) {
+                accepted.push_back(psb::accept_connection(listener.sock()).sock);
+            }
+        }
+        catch (const std::system_error&) {  // NOLINT(bugprone-empty-catch)
+        }
+
+        allocations += allocation_count() - start;
+
+        state.PauseTiming();
+        close_all(accepted);
+        close_all(clients);
+        state.ResumeTiming();
+    }
+
+    set_counters(state, batch);
+    report_allocations(state, allocations, batch);
+}
+
+// Batch path: a single accept_connections() call drains the queue.
+void BM_AcceptConnections(benchmark::State& state)
+{
+    const auto batch = static_cast<std::size_t>(state.range(0));
+    const loopback_listener listener;
+    std::vector<int> clients;
+    std::vector<psb::accepted_socket_t> accepted(batch + 1);
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        listener.connect_clients(batch, clients);
+        state.ResumeTiming();
+
+        const auto start  = allocation_count();
+        const auto result = psb::accept_connections(listener.sock(), accepted, accepted.size());
+        allocations += allocation_count() - start;
+
+        state.PauseTiming();
+        for (std::size_t i = 0; i < result.count; ++i) {
+            close(accepted[i].sock);
+        }
+
+        close_all(clients);
+        state.ResumeTiming();
+    }
+
+    set_counters(state, batch);
+    report_allocations(state, allocations, batch);
+}
+
+// Allocation-free batch path: peer addresses are kept raw and never formatted.
+void BM_AcceptRawConnections(benchmark::State& state)
+{
+    const auto batch = static_cast<std::size_t>(state.range(0));
+    const loopback_listener listener;
+    std::vector<int> clients;
+    std::vector<psb::raw_accepted_socket_t> accepted(batch + 1);
+    std::size_t allocations = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        listener.connect_clients(batch, clients);
+        state.ResumeTiming();
+
+        const auto start  = allocation_count();
+        const auto result = psb::accept_connections(listener.sock(), accepted, accepted.size());
+        allocations += allocation_count() - start;
+
+        state.PauseTiming();
+        for (std::size_t i = 0; i < result.count; ++i) {
+            close(accepted[i].sock);
+        }
+
+        close_all(clients);
+        state.ResumeTiming();
+    }
+
+    set_counters(state, batch);
+    report_allocations(state, allocations, batch);
+}
+
+// Cost of reporting a routine EAGAIN: the throwing API against the error_code one.
+void BM_AcceptEmptyQueueThrow(benchmark::State& state)
+{
+    const loopback_listener listener;
+    for (auto _ : state) {
+        try {
+            benchmark::DoNotOptimize(psb::accept_raw_connection(listener.sock()));
+        }
+        catch (const std::system_error& e) {
+            benchmark::DoNotOptimize(e.code());
+        }
+    }
+}
+
+void BM_AcceptEmptyQueueErrorCode(benchmark::State& state)
+{
+    const loopback_listener listener;
+    std::error_code ec;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(psb::accept_raw_connection(listener.sock(), ec));
+        benchmark::DoNotOptimize(ec);
+    }
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
+BENCHMARK(BM_AcceptFcntl)->RangeMultiplier(4)->Range(4, 256);
+BENCHMARK(BM_AcceptConnection)->RangeMultiplier(4)->Range(4, 256);
+BENCHMARK(BM_AcceptConnections)->RangeMultiplier(4)->Range(4, 256);
+BENCHMARK(BM_AcceptRawConnections)->RangeMultiplier(4)->Range(4, 256);
+BENCHMARK(BM_AcceptEmptyQueueThrow);
+BENCHMARK(BM_AcceptEmptyQueueErrorCode);
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "sockutils.h"
+#include "utils.h"
+
+namespace {
+
+constexpr std::size_t accepts_per_iteration = 64;
+
+/**
+ * Accepts/sec over loopback with `state.range(0)` client threads connecting (and resetting) as fast as they can,
+ * the listener being drained by the benchmark thread with poll() and accept_connections().
+ */
+void BM_AcceptThroughput(benchmark::State& state)
+{
+    const auto concurrency = static_cast<std::size_t>(state.range(0));
+    const loopback_listener listener;
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> clients;
+    clients.reserve(concurrency);
+    for (std::size_t i = 0; i < concurrency; ++i) {
+        clients.emplace_back([&listener, &done]() {
+            while (!done.load(std::memory_order_relaxed)) {
+                try {
+                    close(listener.connect_client());
+                }
+                catch (const std::system_error&) {
+                    // The listener has been shut down
+                    break;
+                }
+            }
+        });
+    }
+
+    std::array<psb::raw_accepted_socket_t, accepts_per_iteration> sockets{};
+    pollfd pfd{.fd = listener.sock(), .events = POLLIN, .revents = 0};
+
+    for (auto _ : state) {
+        std::size_t accepted = 0;
+        while (accepted < accepts_per_iteration) {
+            poll(&pfd, 1, -1);
+            const auto wanted = accepts_per_iteration - accepted;
+            const auto result = psb::accept_connections(listener.sock(), std::span(sockets).first(wanted), wanted);
+            for (std::size_t i = 0; i < result.count; ++i) {
+                close(sockets.at(i).sock);
+            }
+
+            accepted += result.count;
+        }
+    }
+
+    done.store(true, std::memory_order_relaxed);
+    // Clients blocked in connect() because of a full accept queue get ECONNREFUSED
+    shutdown(listener.sock(), SHUT_RD);
+    for (auto& client : clients) {
+        client.join();
+    }
+
+    set_counters(state, accepts_per_iteration);
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
+BENCHMARK(BM_AcceptThroughput)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
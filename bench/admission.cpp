@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+#include "admission.h"
+
+namespace {
+
+std::unique_ptr<psb::admission_controller> controller;  // NOLINT(*-avoid-non-const-global-variables)
+
+// Admission check and release of one connection with both limits on, from `state.threads()` accept threads
+void BM_Admit(benchmark::State& state)
+{
+    if (state.thread_index() == 0) {
+        // Limits high enough never to be hit, so that every call takes the full path
+        controller = std::make_unique<psb::admission_controller>(psb::admission_options_t{
+            .rate = 1e12, .burst = 1U << 30U, .max_inflight = 1U << 30U, .reset_on_overload = 0
+        });
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(controller->admit(1));
+        controller->release();
+    }
+
+    if (state.thread_index() == 0) {
+        controller.reset();
+    }
+}
+
+// The same for a batch of `state.range(0)` connections, as accept_connections() does; time is per connection
+void BM_AdmitBatch(benchmark::State& state)
+{
+    psb::admission_controller ctl(
+        {.rate = 1e12, .burst = 1U << 30U, .max_inflight = 1U << 30U, .reset_on_overload = 0}
+    );
+    const auto batch = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ctl.admit(batch));
+        ctl.release(batch);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Clock reads: the coarse clock used for admission and steady_clock
+void BM_AdmissionClock(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(psb::admission_controller::now());
+    }
+}
+
+void BM_SteadyClock(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::chrono::steady_clock::now());
+    }
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
+BENCHMARK(BM_Admit)->ThreadRange(1, 8);
+BENCHMARK(BM_AdmitBatch)->Arg(1)->Arg(16)->Arg(64);
+BENCHMARK(BM_AdmissionClock);
+BENCHMARK(BM_SteadyClock);
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
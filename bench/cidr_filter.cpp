@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "cidr_filter.h"
+
+namespace {
+
+constexpr std::size_t address_count = 4096;
+
+/**
+ * Random prefixes, half IPv4 (/16 to /32) and half IPv6 (/32 to /64) in 2001::/16; the same seed gives the same
+ * set every run.
+ */
+psb::cidr_set make_set(std::size_t n, std::mt19937& rng)
+{
+    std::uniform_int_distribution<std::uint32_t> word;
+    std::uniform_int_distribution<unsigned int> v4_len(16, 32);
+    std::uniform_int_distribution<unsigned int> v6_len(32, 64);
+
+    psb::cidr_set set;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i % 2 == 0) {
+            set.add(in_addr{.s_addr = word(rng)}, v4_len(rng));
+        }
+        else {
+            in6_addr addr{};
+            addr.s6_addr32[0] = htonl(0x2001'0000U | (word(rng) & 0xFFFFU));
+            addr.s6_addr32[1] = word(rng);
+            set.add(addr, v6_len(rng));
+        }
+    }
+
+    return set;
+}
+
+std::vector<sockaddr_storage> make_addresses(int family, std::mt19937& rng)
+{
+    std::uniform_int_distribution<std::uint32_t> word;
+    std::vector<sockaddr_storage> addresses(address_count);
+    for (auto& ss : addresses) {
+        // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (family == AF_INET) {
+            auto& sin           = reinterpret_cast<sockaddr_in&>(ss);
+            sin.sin_family      = AF_INET;
+            sin.sin_addr.s_addr = word(rng);
+        }
+        else {
+            auto& sin6                  = reinterpret_cast<sockaddr_in6&>(ss);
+            sin6.sin6_family            = AF_INET6;
+            sin6.sin6_addr.s6_addr32[0] = htonl(0x2001'0000U | (word(rng) & 0xFFFFU));
+            sin6.sin6_addr.s6_addr32[1] = word(rng);
+            sin6.sin6_addr.s6_addr32[2] = word(rng);
+            sin6.sin6_addr.s6_addr32[3] = word(rng);
+        }
+        // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+
+    return addresses;
+}
+
+// Lookup of random addresses in a set of `state.range(0)` random prefixes; `state.range(1)` is the address family
+void BM_CidrLookup(benchmark::State& state)
+{
+    std::mt19937 rng(1);  // NOLINT(cert-msc32-c,cert-msc51-cpp)
+    const auto set       = make_set(static_cast<std::size_t>(state.range(0)), rng);
+    const auto addresses = make_addresses(static_cast<int>(state.range(1)), rng);
+
+    std::size_t i       = 0;
+    std::size_t matches = 0;
+    for (auto _ : state) {
+        const auto& ss = addresses[i++ % address_count];
+        matches += set.contains(ss, sizeof(ss)) ? 1 : 0;
+    }
+
+    benchmark::DoNotOptimize(matches);
+    state.SetItemsProcessed(state.iterations());
+    state.counters["hits"] = benchmark::Counter(static_cast<double>(matches) / static_cast<double>(state.iterations()));
+}
+
+// Building the set
+void BM_CidrInsert(benchmark::State& state)
+{
+    for (auto _ : state) {
+        std::mt19937 rng(1);  // NOLINT(cert-msc32-c,cert-msc51-cpp)
+        benchmark::DoNotOptimize(make_set(static_cast<std::size_t>(state.range(0)), rng));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
+BENCHMARK(BM_CidrLookup)->ArgsProduct({{1000, 100'000}, {AF_INET, AF_INET6}});
+BENCHMARK(BM_CidrInsert)->Arg(100'000)->Unit(benchmark::kMillisecond);
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
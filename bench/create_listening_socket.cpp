@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include <unistd.h>
+
+#include "socket_profile.h"
+#include "sockutils.h"
+#include "utils.h"
+
+namespace {
+
+// Full setup of a listener on an ephemeral port: parse, socket(), fcntl(), setsockopt()s, bind(), listen().
+void BM_CreateListeningSocket(benchmark::State& state)
+{
+    const auto start = allocation_count();
+    for (auto _ : state) {
+        const auto ls = psb::create_listening_socket("127.0.0.1", 0, listener_options);
+        state.PauseTiming();
+        close(ls.sock);
+        state.ResumeTiming();
+    }
+
+    report_allocations(state, allocation_count() - start);
+}
+
+// The same with the address parsed at compile time.
+void BM_CreateListeningSocketSockaddr(benchmark::State& state)
+{
+    constexpr auto addr = psb::make_sockaddr_in("127.0.0.1", 0);
+
+    const auto start = allocation_count();
+    for (auto _ : state) {
+        const auto ls = psb::create_listening_socket(addr, listener_options);
+        state.PauseTiming();
+        close(ls.sock);
+        state.ResumeTiming();
+    }
+
+    report_allocations(state, allocation_count() - start);
+}
+
+// The same with the options fixed at compile time as well: socket(SOCK_CLOEXEC), setsockopt(), bind(), listen().
+void BM_CreateListeningSocketProfile(benchmark::State& state)
+{
+    using profile       = psb::socket_profile<listener_options>;
+    constexpr auto addr = psb::make_sockaddr_in("127.0.0.1", 0);
+
+    const auto start = allocation_count();
+    for (auto _ : state) {
+        const auto ls = profile::create_listening_socket(addr);
+        state.PauseTiming();
+        close(ls.sock);
+        state.ResumeTiming();
+    }
+
+    report_allocations(state, allocation_count() - start);
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
+BENCHMARK(BM_CreateListeningSocket);
+BENCHMARK(BM_CreateListeningSocketSockaddr);
+BENCHMARK(BM_CreateListeningSocketProfile);
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
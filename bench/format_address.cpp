@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "sockutils.h"
+
+namespace {
+
+sockaddr_storage make_address(int family, const char* address)
+{
+    sockaddr_storage ss{};
+    ss.ss_family = static_cast<sa_family_t>(family);
+    if (family == AF_INET) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        inet_pton(family, address, &reinterpret_cast<sockaddr_in&>(ss).sin_addr);
+    }
+    else {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        inet_pton(family, address, &reinterpret_cast<sockaddr_in6&>(ss).sin6_addr);
+    }
+
+    return ss;
+}
+
+void BM_InetNtop(benchmark::State& state, int family, const char* address)
+{
+    const auto ss   = make_address(family, address);
+    const void* src = nullptr;
+    if (family == AF_INET) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        src = &reinterpret_cast<const sockaddr_in&>(ss).sin_addr;
+    }
+    else {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        src = &reinterpret_cast<const sockaddr_in6&>(ss).sin6_addr;
+    }
+
+    std::array<char, INET6_ADDRSTRLEN> buf{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(inet_ntop(family, src, buf.data(), buf.size()));
+        benchmark::ClobberMemory();
+    }
+}
+
+void BM_FormatAddress(benchmark::State& state, int family, const char* address)
+{
+    const auto ss       = make_address(family, address);
+    const socklen_t len = family == AF_INET ? sizeof(sockaddr_in) : sizeof(sockaddr_in6);
+
+    psb::address_buffer_t buf{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(psb::format_address(ss, len, buf));
+        benchmark::ClobberMemory();
+    }
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
+BENCHMARK_CAPTURE(BM_InetNtop, ipv4, AF_INET, "192.168.100.254");
+BENCHMARK_CAPTURE(BM_FormatAddress, ipv4, AF_INET, "192.168.100.254");
+BENCHMARK_CAPTURE(BM_InetNtop, ipv6, AF_INET6, "2001:db8:0:0:1:0:0:ab");
+BENCHMARK_CAPTURE(BM_FormatAddress, ipv6, AF_INET6, "2001:db8:0:0:1:0:0:ab");
+BENCHMARK_CAPTURE(BM_InetNtop, mapped, AF_INET6, "::ffff:10.1.2.3");
+BENCHMARK_CAPTURE(BM_FormatAddress, mapped, AF_INET6, "::ffff:10.1.2.3");
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "sockutils.h"
+#include "utils.h"
+
+namespace {
+
+psb::raw_accepted_socket_t make_peer(int family, const char* address)
+{
+    psb::raw_accepted_socket_t peer{};
+    peer.addr.ss_family = static_cast<sa_family_t>(family);
+    if (family == AF_INET) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        auto& sin = reinterpret_cast<sockaddr_in&>(peer.addr);
+        inet_pton(family, address, &sin.sin_addr);
+        sin.sin_port  = htons(54321);  // NOLINT(readability-magic-numbers)
+        peer.addr_len = sizeof(sockaddr_in);
+    }
+    else {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        auto& sin6 = reinterpret_cast<sockaddr_in6&>(peer.addr);
+        inet_pton(family, address, &sin6.sin6_addr);
+        sin6.sin6_port = htons(54321);  // NOLINT(readability-magic-numbers)
+        peer.addr_len  = sizeof(sockaddr_in6);
+    }
+
+    return peer;
+}
+
+// Per-call cost of turning a raw peer address into socket_info_t (what accept_connection() does for every peer).
+void BM_GetSocketInfo(benchmark::State& state, int family, const char* address)
+{
+    const auto peer  = make_peer(family, address);
+    const auto start = allocation_count();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(psb::get_socket_info(peer.addr, peer.addr_len));
+    }
+
+    report_allocations(state, allocation_count() - start);
+}
+
+// The allocation-free alternative: formatting into a caller-provided buffer.
+void BM_FormatPeer(benchmark::State& state, int family, const char* address)
+{
+    const auto peer  = make_peer(family, address);
+    const auto start = allocation_count();
+    psb::peer_buffer_t buf{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(psb::format_peer(peer, buf));
+        benchmark::ClobberMemory();
+    }
+
+    report_allocations(state, allocation_count() - start);
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
+BENCHMARK_CAPTURE(BM_GetSocketInfo, ipv4, AF_INET, "192.168.100.254");
+BENCHMARK_CAPTURE(BM_FormatPeer, ipv4, AF_INET, "192.168.100.254");
+BENCHMARK_CAPTURE(BM_GetSocketInfo, ipv6, AF_INET6, "2001:db8:0:0:1:0:0:ab");
+BENCHMARK_CAPTURE(BM_FormatPeer, ipv6, AF_INET6, "2001:db8:0:0:1:0:0:ab");
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+
+#include <exception>
+#include <string_view>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "parse_address.h"
+#include "sockutils.h"
+#include "utils.h"
+
+namespace {
+
+void BM_LibcInetPton(benchmark::State& state, int family, const char* address)
+{
+    in6_addr addr{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(inet_pton(family, address, &addr));
+        benchmark::ClobberMemory();
+    }
+}
+
+void BM_InetPton(benchmark::State& state, int family, const char* address)
+{
+    const std::string_view input(address);
+    const auto start = allocation_count();
+    in_addr addr4{};
+    in6_addr addr6{};
+    for (auto _ : state) {
+        if (family == AF_INET) {
+            psb::inet_pton(input, addr4);
+        }
+        else {
+            psb::inet_pton(input, addr6);
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    report_allocations(state, allocation_count() - start);
+}
+
+// Rejecting bad input: the throwing inet_pton() against the error-returning parsers.
+void BM_InetPtonInvalid(benchmark::State& state)
+{
+    const std::string_view input("192.168.1.256");
+    in_addr addr{};
+    for (auto _ : state) {
+        try {
+            psb::inet_pton(input, addr);
+        }
+        catch (const std::exception& e) {
+            benchmark::DoNotOptimize(e.what());
+        }
+    }
+}
+
+void BM_ParseIPv4Invalid(benchmark::State& state)
+{
+    const std::string_view input("192.168.1.256");
+    in_addr addr{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(psb::parse_ipv4(input, addr));
+    }
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
+BENCHMARK_CAPTURE(BM_LibcInetPton, ipv4, AF_INET, "192.168.100.254");
+BENCHMARK_CAPTURE(BM_InetPton, ipv4, AF_INET, "192.168.100.254");
+BENCHMARK_CAPTURE(BM_LibcInetPton, ipv6, AF_INET6, "2001:db8::1:0:0:ab");
+BENCHMARK_CAPTURE(BM_InetPton, ipv6, AF_INET6, "2001:db8::1:0:0:ab");
+BENCHMARK(BM_InetPtonInvalid);
+BENCHMARK(BM_ParseIPv4Invalid);
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
@@ -0,0 +1,128 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "sockutils.h"
+
+namespace {
+
+constexpr psb::socket_options_t listener_options{
+    .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+};
+
+constexpr std::size_t connections_per_iteration = 256;
+
+/**
+ * Accepts connections on @a sock until @a accepted reaches @a total.
+ */
+void acceptor(int sock, std::atomic<std::size_t>& accepted, std::size_t total)
+{
+    std::array<psb::raw_accepted_socket_t, 64U> sockets{};
+    pollfd pfd{.fd = sock, .events = POLLIN, .revents = 0};
+
+    while (accepted.load(std::memory_order_relaxed) < total) {
+        if (poll(&pfd, 1, 1) <= 0) {
+            continue;
+        }
+
+        const auto result = psb::accept_connections(sock, sockets, sockets.size());
+        for (std::size_t i = 0; i < result.count; ++i) {
+            close(sockets.at(i).sock);
+        }
+
+        accepted.fetch_add(result.count, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Runs one acceptor thread per element of @a socks while the calling thread opens the connections.
+ */
+void run(const std::vector<int>& socks)
+{
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (getsockname(socks.front(), reinterpret_cast<sockaddr*>(&ss), &len) == -1) {
+        throw std::system_error(errno, std::system_category(), "getsockname");
+    }
+
+    std::atomic<std::size_t> accepted{0};
+    std::vector<std::jthread> threads;
+    threads.reserve(socks.size());
+    for (const auto sock : socks) {
+        threads.emplace_back(acceptor, sock, std::ref(accepted), connections_per_iteration);
+    }
+
+    constexpr linger no_linger{.l_onoff = 1, .l_linger = 0};
+    std::vector<int> clients;
+    clients.reserve(connections_per_iteration);
+    for (std::size_t i = 0; i < connections_per_iteration; ++i) {
+        const auto sock = socket(ss.ss_family, SOCK_STREAM, 0);
+        setsockopt(sock, SOL_SOCKET, SO_LINGER, &no_linger, sizeof(no_linger));
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        connect(sock, reinterpret_cast<const sockaddr*>(&ss), len);
+        clients.push_back(sock);
+    }
+
+    threads.clear();
+    for (const auto sock : clients) {
+        close(sock);
+    }
+}
+
+// All acceptor threads contend on a single listener.
+void BM_SingleListener(benchmark::State& state)
+{
+    const auto ls = psb::create_listening_socket("127.0.0.1", 0, listener_options);
+    const std::vector<int> socks(static_cast<std::size_t>(state.range(0)), ls.sock);
+
+    for (auto _ : state) {
+        run(socks);
+    }
+
+    close(ls.sock);
+    state.counters["accepts"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * connections_per_iteration), benchmark::Counter::kIsRate
+    );
+}
+
+// Every acceptor thread has its own SO_REUSEPORT shard.
+void BM_ListeningGroup(benchmark::State& state)
+{
+    const auto group = psb::create_listening_group(
+        "127.0.0.1", 0, listener_options, static_cast<std::size_t>(state.range(0)), false
+    );
+
+    std::vector<int> socks;
+    for (const auto& ls : group) {
+        socks.push_back(ls.sock);
+    }
+
+    for (auto _ : state) {
+        run(socks);
+    }
+
+    for (const auto sock : socks) {
+        close(sock);
+    }
+
+    state.counters["accepts"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * connections_per_iteration), benchmark::Counter::kIsRate
+    );
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
+BENCHMARK(BM_SingleListener)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK(BM_ListeningGroup)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
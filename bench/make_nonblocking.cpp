@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include <system_error>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "sockutils.h"
+
+namespace {
+
+class tcp_socket {
+public:
+    tcp_socket() : m_sock(socket(AF_INET, SOCK_STREAM, 0))
+    {
+        if (this->m_sock == -1) {
+            throw std::system_error(errno, std::system_category(), "socket");
+        }
+    }
+
+    tcp_socket(const tcp_socket&)            = delete;
+    tcp_socket(tcp_socket&&)                 = delete;
+    tcp_socket& operator=(const tcp_socket&) = delete;
+    tcp_socket& operator=(tcp_socket&&)      = delete;
+
+    ~tcp_socket() { close(this->m_sock); }
+
+    [[nodiscard]] int sock() const noexcept { return this->m_sock; }
+
+private:
+    int m_sock;
+};
+
+// Each call is an F_GETFL/F_SETFL round trip, even when the flag is already set.
+void BM_MakeNonblocking(benchmark::State& state)
+{
+    const tcp_socket sock;
+    for (auto _ : state) {
+        psb::make_nonblocking(sock.sock());
+    }
+}
+
+void BM_MakeCloseOnExec(benchmark::State& state)
+{
+    const tcp_socket sock;
+    for (auto _ : state) {
+        psb::make_close_on_exec(sock.sock());
+    }
+}
+
+void BM_SetSocketOption(benchmark::State& state)
+{
+    const tcp_socket sock;
+    std::error_code ec;
+    for (auto _ : state) {
+        psb::set_socket_option(sock.sock(), SOL_SOCKET, SO_KEEPALIVE, 1, ec);
+        benchmark::DoNotOptimize(ec);
+    }
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
+BENCHMARK(BM_MakeNonblocking);
+BENCHMARK(BM_MakeCloseOnExec);
+BENCHMARK(BM_SetSocketOption);
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
@@ -0,0 +1,552 @@
+/**
+ * psb-sockbench: loopback connection-storm generator.
+ *
+ * Client threads open connections at a target rate against a server built on `create_listening_socket()` and
+ * `accept_connection()`. Every client sends the time it started connecting as the first 8 bytes, which lets the
+ * server measure the connect-to-accept latency, and resets the connection right away. With a target rate, the
+ * clients run an open loop: connections start on schedule however many are still connecting.
+ *
+ * Reported: connections per second, accept latency percentiles, server and process CPU time per connection, and the
+ * kernel's listen-queue overflow counters (TcpExt in /proc/net/netstat; they are namespace-wide).
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "sockutils.h"
+
+namespace {
+
+using steady_clock = std::chrono::steady_clock;
+
+struct config_t {
+    bool ipv6            = false;
+    int defer_accept     = 0;          // TCP_DEFER_ACCEPT timeout, seconds; 0 disables it
+    int backlog          = SOMAXCONN;  // listen() backlog
+    unsigned int threads = 4;          // Client threads
+    double rate          = 0;          // Target connections per second over all threads; 0 means unthrottled
+    double duration      = 5;          // Seconds
+    int connect_timeout  = 1000;       // Milliseconds
+};
+
+struct client_stats_t {
+    std::atomic<std::uint64_t> attempted{0};
+    std::atomic<std::uint64_t> established{0};
+    std::atomic<std::uint64_t> failed{0};
+    std::atomic<std::uint64_t> timed_out{0};
+};
+
+struct server_stats_t {
+    std::uint64_t accepted{};
+    std::uint64_t accept_errors{};
+    std::uint64_t unstamped{};            // Connections which did not send a timestamp within connect_timeout
+    std::vector<std::int64_t> latencies;  // Nanoseconds
+    std::chrono::microseconds cpu{};
+};
+
+constexpr std::string_view usage = R"(Usage: psb-sockbench [options]
+
+Options:
+  --ipv6                   Listen on and connect to ::1 instead of 127.0.0.1
+  --defer-accept=SECONDS   Enable TCP_DEFER_ACCEPT on the listener
+  --backlog=N              listen() backlog (default: SOMAXCONN)
+  --threads=N              Number of client threads (default: 4)
+  --rate=N                 Target connections per second, over all threads (default: 0, as fast as possible)
+  --duration=SECONDS       Duration of the run (default: 5)
+  --connect-timeout=MS     Client connect() timeout, and how long the server waits for the timestamp (default: 1000)
+  --help                   Show this help
+)";
+
+template<typename T>
+T parse_value(std::string_view name, std::string_view value)
+{
+    T result{};
+    const auto* end      = value.data() + value.size();  // NOLINT(*-pointer-arithmetic)
+    const auto [ptr, ec] = std::from_chars(value.data(), end, result);
+    if (ec != std::errc{} || ptr != end) {
+        throw std::invalid_argument(std::format("Invalid value for {}: '{}'", name, value));
+    }
+
+    return result;
+}
+
+config_t parse_args(std::span<char*> args)
+{
+    config_t config;
+    for (std::string_view arg : args.subspan(1)) {
+        const auto eq    = arg.find('=');
+        const auto name  = arg.substr(0, eq);
+        const auto value = eq == std::string_view::npos ? std::string_view{} : arg.substr(eq + 1);
+
+        if (name == "--help" || name == "-h") {
+            std::cout << usage;
+            std::exit(EXIT_SUCCESS);  // NOLINT(concurrency-mt-unsafe)
+        }
+
+        if (name == "--ipv6") {
+            config.ipv6 = true;
+        }
+        else if (name == "--defer-accept") {
+            config.defer_accept = parse_value<int>(name, value);
+        }
+        else if (name == "--backlog") {
+            config.backlog = parse_value<int>(name, value);
+        }
+        else if (name == "--threads") {
+            config.threads = std::max(parse_value<unsigned int>(name, value), 1U);
+        }
+        else if (name == "--rate") {
+            config.rate = parse_value<double>(name, value);
+        }
+        else if (name == "--duration") {
+            config.duration = parse_value<double>(name, value);
+        }
+        else if (name == "--connect-timeout") {
+            config.connect_timeout = parse_value<int>(name, value);
+        }
+        else {
+            throw std::invalid_argument(std::format("Unknown option: '{}'", arg));
+        }
+    }
+
+    return config;
+}
+
+/**
+ * Reads the TcpExt counters from /proc/net/netstat; returns an empty map if they are not available.
+ */
+std::map<std::string, std::uint64_t> read_tcp_ext()
+{
+    std::map<std::string, std::uint64_t> result;
+    std::ifstream netstat("/proc/net/netstat");
+
+    std::string names;
+    std::string values;
+    while (std::getline(netstat, names) && std::getline(netstat, values)) {
+        if (names.starts_with("TcpExt:")) {
+            std::istringstream n(names.substr(names.find(' ') + 1));
+            std::istringstream v(values.substr(values.find(' ') + 1));
+            std::string name;
+            std::uint64_t value{};
+            while (n >> name && v >> value) {
+                result[name] = value;
+            }
+
+            break;
+        }
+    }
+
+    return result;
+}
+
+std::chrono::microseconds thread_cpu_time()
+{
+    rusage usage{};
+    getrusage(RUSAGE_THREAD, &usage);
+    return std::chrono::seconds(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           std::chrono::microseconds(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+std::chrono::microseconds process_cpu_time()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return std::chrono::seconds(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           std::chrono::microseconds(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+/**
+ * Converts the time left until @a deadline into a timeout for `ppoll()`.
+ */
+timespec timeout_until(steady_clock::time_point deadline, steady_clock::time_point now)
+{
+    const auto left =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::max(deadline - now, steady_clock::duration::zero()));
+    const auto secs = std::chrono::duration_cast<std::chrono::seconds>(left);
+    return {.tv_sec = secs.count(), .tv_nsec = (left - secs).count()};
+}
+
+/**
+ * Removes element @a idx from @a items by moving the last one into its place.
+ */
+template<typename T>
+void swap_remove(std::vector<T>& items, std::size_t idx)
+{
+    items[idx] = items.back();
+    items.pop_back();
+}
+
+/**
+ * Accepted connection whose timestamp has not arrived yet.
+ */
+struct unstamped_connection_t {
+    int sock;
+    steady_clock::time_point accepted;
+};
+
+/**
+ * Reads the client's timestamp from @a sock without blocking and records the latency.
+ */
+bool read_stamp(int sock, steady_clock::time_point accepted, server_stats_t& stats)
+{
+    std::int64_t stamp{};
+    if (recv(sock, &stamp, sizeof(stamp), MSG_DONTWAIT) != sizeof(stamp)) {
+        return false;
+    }
+
+    stats.latencies.push_back(std::chrono::nanoseconds(accepted.time_since_epoch()).count() - stamp);
+    return true;
+}
+
+void server_loop(int sock, const config_t& config, const std::atomic<bool>& stop, server_stats_t& stats)
+{
+    const auto cpu_start     = thread_cpu_time();
+    const auto stamp_timeout = std::chrono::milliseconds(config.connect_timeout);
+
+    // The listener comes first, followed by the accepted sockets waiting for their timestamps (one per element of
+    // `unstamped`), so that a slow client never holds up the accept loop
+    std::vector<pollfd> pfds{{.fd = sock, .events = POLLIN, .revents = 0}};
+    std::vector<unstamped_connection_t> unstamped;
+    std::error_code ec;
+    while (!stop.load(std::memory_order_relaxed)) {
+        if (poll(pfds.data(), pfds.size(), 100) == -1) {  // NOLINT(readability-magic-numbers)
+            continue;
+        }
+
+        const auto now = steady_clock::now();
+        for (std::size_t i = 1; i < pfds.size();) {
+            auto& conn = unstamped[i - 1];
+            if (pfds[i].revents == 0 && now - conn.accepted < stamp_timeout) {
+                ++i;
+                continue;
+            }
+
+            if (pfds[i].revents == 0 || !read_stamp(conn.sock, conn.accepted, stats)) {
+                ++stats.unstamped;
+            }
+
+            close(conn.sock);
+            swap_remove(pfds, i);
+            swap_remove(unstamped, i - 1);
+        }
+
+        if ((pfds[0].revents & POLLIN) == 0) {
+            continue;
+        }
+
+        for (;;) {
+            const auto accepted = psb::accept_connection(sock, ec);
+            if (ec) {
+                if (ec != std::errc::resource_unavailable_try_again && ec != std::errc::operation_would_block) {
+                    ++stats.accept_errors;
+                }
+
+                break;
+            }
+
+            const auto accepted_at = steady_clock::now();
+            ++stats.accepted;
+
+            if (read_stamp(accepted.sock, accepted_at, stats)) {
+                close(accepted.sock);
+            }
+            else {
+                pfds.push_back({.fd = accepted.sock, .events = POLLIN, .revents = 0});
+                unstamped.push_back({.sock = accepted.sock, .accepted = accepted_at});
+            }
+        }
+    }
+
+    for (const auto& conn : unstamped) {
+        close(conn.sock);
+    }
+
+    stats.unstamped += unstamped.size();
+    stats.cpu = thread_cpu_time() - cpu_start;
+}
+
+/**
+ * Connection whose non-blocking `connect()` is in progress.
+ */
+struct pending_connection_t {
+    int sock;
+    std::int64_t stamp;  // Nanoseconds, steady clock
+    steady_clock::time_point deadline;
+};
+
+/**
+ * Completes the connection @a conn: sends the timestamp and resets the connection.
+ */
+void finish_connect(const pending_connection_t& conn, client_stats_t& stats)
+{
+    int error{};
+    socklen_t len = sizeof(error);
+    if (getsockopt(conn.sock, SOL_SOCKET, SO_ERROR, &error, &len) == 0 && error == 0) {
+        ++stats.established;
+        send(conn.sock, &conn.stamp, sizeof(conn.stamp), MSG_NOSIGNAL | MSG_DONTWAIT);
+    }
+    else {
+        ++stats.failed;
+    }
+
+    close(conn.sock);
+}
+
+/**
+ * Starts a non-blocking connection to @a addr; returns `false` if it is already finished (or failed).
+ */
+bool start_connect(
+    const sockaddr_storage& addr, socklen_t len, const config_t& config, client_stats_t& stats,
+    pending_connection_t& conn
+)
+{
+    // Reset instead of FIN, so that a storm does not run out of ephemeral ports because of TIME_WAIT
+    constexpr linger no_linger{.l_onoff = 1, .l_linger = 0};
+
+    conn.sock = socket(addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (conn.sock == -1) {
+        ++stats.failed;
+        return false;
+    }
+
+    setsockopt(conn.sock, SOL_SOCKET, SO_LINGER, &no_linger, sizeof(no_linger));
+
+    ++stats.attempted;
+    const auto now = steady_clock::now();
+    conn.stamp     = std::chrono::nanoseconds(now.time_since_epoch()).count();
+    conn.deadline  = now + std::chrono::milliseconds(config.connect_timeout);
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (connect(conn.sock, reinterpret_cast<const sockaddr*>(&addr), len) == 0) {
+        finish_connect(conn, stats);
+        return false;
+    }
+
+    if (errno != EINPROGRESS) {
+        ++stats.failed;
+        close(conn.sock);
+        return false;
+    }
+
+    return true;
+}
+
+void client_loop(
+    const sockaddr_storage& addr, socklen_t len, const config_t& config, const std::atomic<bool>& stop,
+    client_stats_t& stats
+)
+{
+    const auto interval = config.rate > 0 ? std::chrono::duration_cast<steady_clock::duration>(
+                                                std::chrono::duration<double>(config.threads / config.rate)
+                                            )
+                                          : steady_clock::duration::zero();
+
+    const bool throttled = interval != steady_clock::duration::zero();
+
+    // Open loop when throttled: a slow connect() does not lower the offered rate, as the next connection starts on
+    // schedule anyway. Unthrottled, every thread keeps one connection in progress.
+    std::vector<pollfd> pfds;
+    std::vector<pending_connection_t> pending;
+    auto next = steady_clock::now();
+    for (;;) {
+        const bool stopping = stop.load(std::memory_order_relaxed);
+        if (stopping && pending.empty()) {
+            break;
+        }
+
+        auto now = steady_clock::now();
+        if (!stopping && (throttled ? now >= next : pending.empty())) {
+            next += interval;
+            if (pending_connection_t conn{}; start_connect(addr, len, config, stats, conn)) {
+                pfds.push_back({.fd = conn.sock, .events = POLLOUT, .revents = 0});
+                pending.push_back(conn);
+            }
+        }
+
+        auto wake = stopping || !throttled ? steady_clock::time_point::max() : next;
+        for (const auto& conn : pending) {
+            wake = std::min(wake, conn.deadline);
+        }
+
+        if (wake == steady_clock::time_point::max()) {
+            continue;
+        }
+
+        const auto timeout = timeout_until(wake, now);
+        if (ppoll(pfds.data(), pfds.size(), &timeout, nullptr) == -1) {
+            continue;
+        }
+
+        now = steady_clock::now();
+        for (std::size_t i = 0; i < pending.size();) {
+            if (pfds[i].revents != 0) {
+                finish_connect(pending[i], stats);
+            }
+            else if (now >= pending[i].deadline) {
+                ++stats.timed_out;
+                close(pending[i].sock);
+            }
+            else {
+                ++i;
+                continue;
+            }
+
+            swap_remove(pfds, i);
+            swap_remove(pending, i);
+        }
+    }
+}
+
+std::int64_t percentile(const std::vector<std::int64_t>& sorted, double p)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+
+    const auto idx = static_cast<std::size_t>(p / 100.0 * static_cast<double>(sorted.size() - 1));
+    return sorted.at(idx);
+}
+
+void report(
+    const config_t& config, const client_stats_t& clients, server_stats_t& server,
+    std::chrono::duration<double> elapsed, std::chrono::microseconds process_cpu,
+    const std::map<std::string, std::uint64_t>& before, const std::map<std::string, std::uint64_t>& after
+)
+{
+    auto& latencies = server.latencies;
+    std::ranges::sort(latencies);
+
+    const auto accepted = static_cast<double>(std::max<std::uint64_t>(server.accepted, 1));
+    const auto us       = [](std::int64_t ns) { return static_cast<double>(ns) / 1000.0; };
+
+    std::cout << std::format(
+        "psb-sockbench: {}, backlog {}, TCP_DEFER_ACCEPT {}, {} client threads, target rate {}, {:.1f} s\n\n",
+        config.ipv6 ? "IPv6" : "IPv4", config.backlog,
+        config.defer_accept != 0 ? std::format("{} s", config.defer_accept) : std::string("off"), config.threads,
+        config.rate > 0 ? std::format("{:.0f}/s", config.rate) : std::string("unthrottled"), elapsed.count()
+    );
+
+    std::cout << std::format(
+        "connections     attempted {}, established {}, accepted {}, timed out {}, failed {}, accept errors {}, "
+        "without timestamp {}\n",
+        clients.attempted.load(), clients.established.load(), server.accepted, clients.timed_out.load(),
+        clients.failed.load(), server.accept_errors, server.unstamped
+    );
+
+    std::cout << std::format(
+        "rate            {:.0f} accepted connections/s\n", static_cast<double>(server.accepted) / elapsed.count()
+    );
+
+    std::cout << std::format(
+        "accept latency  p50 {:.1f} us, p90 {:.1f} us, p99 {:.1f} us, p99.9 {:.1f} us, max {:.1f} us\n",
+        us(percentile(latencies, 50)), us(percentile(latencies, 90)), us(percentile(latencies, 99)),  // NOLINT
+        us(percentile(latencies, 99.9)), us(percentile(latencies, 100))                               // NOLINT
+    );
+
+    std::cout << std::format(
+        "CPU             server {:.2f} us/conn, process (clients included) {:.2f} us/conn\n",
+        static_cast<double>(server.cpu.count()) / accepted, static_cast<double>(process_cpu.count()) / accepted
+    );
+
+    std::cout << "listen queue   ";
+    for (const char* name : {"ListenOverflows", "ListenDrops", "TCPReqQFullDrop", "TCPReqQFullDoCookies"}) {
+        const auto b = before.find(name);
+        const auto a = after.find(name);
+        if (a != after.end() && b != before.end()) {
+            std::cout << std::format(" {} +{}", name, a->second - b->second);
+        }
+    }
+
+    std::cout << '\n';
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    try {
+        const auto config = parse_args(std::span(argv, static_cast<std::size_t>(argc)));
+
+        const psb::socket_options_t opts{
+            .close_on_exec        = 1,
+            .reuse_addr           = 1,
+            .free_bind            = 0,
+            .defer_accept_timeout = config.defer_accept,
+            .listen_backlog       = config.backlog,
+        };
+
+        const auto ls = psb::create_listening_socket(config.ipv6 ? "::1" : "127.0.0.1", 0, opts);
+
+        sockaddr_storage addr{};
+        socklen_t len = sizeof(addr);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (getsockname(ls.sock, reinterpret_cast<sockaddr*>(&addr), &len) == -1) {
+            throw std::system_error(errno, std::generic_category(), "getsockname() failed");
+        }
+
+        client_stats_t client_stats;
+        server_stats_t server_stats;
+        std::atomic<bool> stop_clients{false};
+        std::atomic<bool> stop_server{false};
+
+        const auto netstat_before = read_tcp_ext();
+        const auto cpu_before     = process_cpu_time();
+        const auto start          = steady_clock::now();
+
+        std::thread server([&]() { server_loop(ls.sock, config, stop_server, server_stats); });
+
+        std::vector<std::thread> clients;
+        clients.reserve(config.threads);
+        for (unsigned int i = 0; i < config.threads; ++i) {
+            clients.emplace_back([&]() { client_loop(addr, len, config, stop_clients, client_stats); });
+        }
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(config.duration));
+        stop_clients.store(true);
+        for (auto& client : clients) {
+            client.join();
+        }
+
+        stop_server.store(true);
+        server.join();
+
+        const std::chrono::duration<double> elapsed = steady_clock::now() - start;
+        const auto cpu                              = process_cpu_time() - cpu_before;
+        const auto netstat_after                    = read_tcp_ext();
+        close(ls.sock);
+
+        report(config, client_stats, server_stats, elapsed, cpu, netstat_before, netstat_after);
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "psb-sockbench: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,169 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <system_error>
+#include <vector>
+
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "sockutils.h"
+#include "udp_receiver.h"
+#include "utils.h"
+
+namespace {
+
+constexpr std::size_t datagrams_per_iteration = 64;
+constexpr std::size_t datagram_size           = 256;
+
+/**
+ * A UDP server socket and a client connected to it.
+ */
+class udp_pair {
+public:
+    udp_pair() : m_server(psb::create_udp_socket("127.0.0.1", 0, listener_options))
+    {
+        sockaddr_storage ss{};
+        socklen_t len = sizeof(ss);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        getsockname(this->m_server.sock, reinterpret_cast<sockaddr*>(&ss), &len);
+
+        this->m_client = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (connect(this->m_client, reinterpret_cast<const sockaddr*>(&ss), len) == -1) {
+            const auto err = errno;
+            close(this->m_client);
+            close(this->m_server.sock);
+            throw std::system_error(err, std::system_category(), "connect");
+        }
+    }
+
+    udp_pair(const udp_pair&)            = delete;
+    udp_pair(udp_pair&&)                 = delete;
+    udp_pair& operator=(const udp_pair&) = delete;
+    udp_pair& operator=(udp_pair&&)      = delete;
+
+    ~udp_pair()
+    {
+        close(this->m_client);
+        close(this->m_server.sock);
+    }
+
+    [[nodiscard]] int server() const noexcept { return this->m_server.sock; }
+    [[nodiscard]] int client() const noexcept { return this->m_client; }
+
+    /// Queues `datagrams_per_iteration` datagrams on the server socket.
+    void send_batch() const
+    {
+        static const std::vector<char> payload(datagram_size * datagrams_per_iteration, 'x');
+        if (this->m_segmented) {
+            // One GSO send: the datagrams reach a GRO socket as one message
+            send(this->m_client, payload.data(), payload.size(), 0);
+            return;
+        }
+
+        for (std::size_t i = 0; i < datagrams_per_iteration; ++i) {
+            send(this->m_client, payload.data(), datagram_size, 0);
+        }
+    }
+
+    /// Makes the client send with UDP_SEGMENT; returns false if the kernel does not support it.
+    bool segment()
+    {
+        constexpr int size = datagram_size;
+        this->m_segmented  = setsockopt(this->m_client, SOL_UDP, UDP_SEGMENT, &size, sizeof(size)) == 0;
+        return this->m_segmented;
+    }
+
+private:
+    psb::listening_socket_t m_server;
+    int m_client = -1;
+    bool m_segmented = false;
+};
+
+void set_datagram_counters(benchmark::State& state)
+{
+    const auto received = static_cast<double>(state.iterations()) * static_cast<double>(datagrams_per_iteration);
+    state.counters["datagrams"] = benchmark::Counter(received, benchmark::Counter::kIsRate);
+}
+
+// Baseline: one recvfrom() per datagram.
+void BM_RecvFrom(benchmark::State& state)
+{
+    const udp_pair pair;
+    std::array<char, datagram_size> buf{};
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        pair.send_batch();
+        state.ResumeTiming();
+
+        for (std::size_t i = 0; i < datagrams_per_iteration; ++i) {
+            sockaddr_storage ss{};
+            socklen_t len = sizeof(ss);
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            const auto res = recvfrom(pair.server(), buf.data(), buf.size(), 0, reinterpret_cast<sockaddr*>(&ss), &len);
+            benchmark::DoNotOptimize(res);
+        }
+    }
+
+    set_datagram_counters(state);
+}
+
+// recvmmsg() batches of `state.range(0)` messages.
+void BM_UdpReceiver(benchmark::State& state)
+{
+    const udp_pair pair;
+    psb::udp_receiver receiver(
+        pair.server(),
+        {.batch_size = static_cast<std::size_t>(state.range(0)), .buffer_size = datagram_size, .gro = false}
+    );
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        pair.send_batch();
+        state.ResumeTiming();
+
+        for (std::size_t received = 0; received < datagrams_per_iteration;) {
+            received += receiver.receive().size();
+        }
+    }
+
+    set_datagram_counters(state);
+}
+
+// UDP_GRO with a UDP_SEGMENT sender: the batch arrives as one message, split by the receiver.
+void BM_UdpReceiverGro(benchmark::State& state)
+{
+    udp_pair pair;
+    if (!pair.segment()) {
+        state.SkipWithError("UDP_SEGMENT not supported");
+        return;
+    }
+
+    psb::udp_receiver receiver(pair.server(), {.batch_size = 8, .buffer_size = 0, .gro = true});
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        pair.send_batch();
+        state.ResumeTiming();
+
+        for (std::size_t received = 0; received < datagrams_per_iteration;) {
+            received += receiver.receive().size();
+        }
+    }
+
+    set_datagram_counters(state);
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
+BENCHMARK(BM_RecvFrom);
+BENCHMARK(BM_UdpReceiver)->Arg(8)->Arg(64);
+BENCHMARK(BM_UdpReceiverGro);
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
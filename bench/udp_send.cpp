@@ -0,0 +1,129 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "sockutils.h"
+#include "udp_sender.h"
+#include "utils.h"
+
+namespace {
+
+constexpr std::size_t datagrams_per_iteration = 64;
+constexpr std::size_t datagram_size           = 256;
+constexpr std::size_t peer_count              = 4;
+
+/**
+ * A sending socket and `peer_count` bound UDP sockets which are never read: once their buffers are full, the
+ * kernel drops the datagrams, so the benchmarks measure the sending side only.
+ */
+class udp_fanout {
+public:
+    udp_fanout() : m_sender(psb::create_udp_socket("127.0.0.1", 0, listener_options))
+    {
+        for (std::size_t i = 0; i < peer_count; ++i) {
+            this->m_peers.at(i) = psb::create_udp_socket("127.0.0.1", 0, listener_options).sock;
+            this->m_lens.at(i)  = sizeof(sockaddr_storage);
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            getsockname(this->m_peers.at(i), reinterpret_cast<sockaddr*>(&this->m_addrs.at(i)), &this->m_lens.at(i));
+        }
+    }
+
+    udp_fanout(const udp_fanout&)            = delete;
+    udp_fanout(udp_fanout&&)                 = delete;
+    udp_fanout& operator=(const udp_fanout&) = delete;
+    udp_fanout& operator=(udp_fanout&&)      = delete;
+
+    ~udp_fanout()
+    {
+        close(this->m_sender.sock);
+        for (const auto sock : this->m_peers) {
+            close(sock);
+        }
+    }
+
+    [[nodiscard]] int sender() const noexcept { return this->m_sender.sock; }
+    [[nodiscard]] const sockaddr_storage& addr(std::size_t i) const { return this->m_addrs.at(i % peer_count); }
+    [[nodiscard]] socklen_t len(std::size_t i) const { return this->m_lens.at(i % peer_count); }
+
+private:
+    psb::listening_socket_t m_sender;
+    std::array<int, peer_count> m_peers{};
+    std::array<sockaddr_storage, peer_count> m_addrs{};
+    std::array<socklen_t, peer_count> m_lens{};
+};
+
+const std::vector<std::byte> payload(datagram_size * datagrams_per_iteration, std::byte{'x'});
+
+void set_packet_counters(benchmark::State& state)
+{
+    const auto sent = static_cast<double>(state.iterations()) * static_cast<double>(datagrams_per_iteration);
+    state.counters["packets"] = benchmark::Counter(sent, benchmark::Counter::kIsRate);
+}
+
+// Baseline: one sendto() per datagram, the same payload fanned out to the peers.
+void BM_SendTo(benchmark::State& state)
+{
+    const udp_fanout fanout;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < datagrams_per_iteration; ++i) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            const auto* addr = reinterpret_cast<const sockaddr*>(&fanout.addr(i));
+            benchmark::DoNotOptimize(sendto(fanout.sender(), payload.data(), datagram_size, 0, addr, fanout.len(i)));
+        }
+    }
+
+    set_packet_counters(state);
+}
+
+// The same with sendmmsg() batches of `state.range(0)` messages.
+void BM_UdpSender(benchmark::State& state)
+{
+    const udp_fanout fanout;
+    const auto data = std::span(payload).first(datagram_size);
+    psb::udp_sender sender(fanout.sender(), {.batch_size = static_cast<std::size_t>(state.range(0))});
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < datagrams_per_iteration; ++i) {
+            if (!sender.add(fanout.addr(i), fanout.len(i), data)) {
+                benchmark::DoNotOptimize(sender.flush());
+                sender.add(fanout.addr(i), fanout.len(i), data);
+            }
+        }
+
+        benchmark::DoNotOptimize(sender.flush());
+    }
+
+    set_packet_counters(state);
+}
+
+// All datagrams to one peer as a single UDP_SEGMENT message.
+void BM_UdpSenderGso(benchmark::State& state)
+{
+    const udp_fanout fanout;
+    psb::udp_sender sender(fanout.sender(), {.batch_size = 1});
+
+    for (auto _ : state) {
+        sender.add_segmented(fanout.addr(0), fanout.len(0), payload, static_cast<std::uint16_t>(datagram_size));
+        if (const auto results = sender.flush(); results.front().error) {
+            state.SkipWithError("UDP_SEGMENT not supported");
+            return;
+        }
+    }
+
+    set_packet_counters(state);
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
+BENCHMARK(BM_SendTo);
+BENCHMARK(BM_UdpSender)->Arg(8)->Arg(64);
+BENCHMARK(BM_UdpSenderGso);
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
@@ -0,0 +1,163 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "sockutils.h"
+#include "utils.h"
+
+namespace {
+
+enum transport : std::int64_t { tcp, unix_stream };
+
+/**
+ * A connected client and server, over loopback TCP or an abstract UNIX stream socket.
+ */
+class connection {
+public:
+    explicit connection(transport kind)
+    {
+        const auto address = kind == tcp ? std::string("127.0.0.1") : std::format("@psb-sockutils-bench-{}", getpid());
+        const auto ls      = psb::create_listening_socket(address, 0, listener_options);
+
+        sockaddr_storage ss{};
+        socklen_t len = sizeof(ss);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        getsockname(ls.sock, reinterpret_cast<sockaddr*>(&ss), &len);
+
+        this->m_client = socket(ss.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (connect(this->m_client, reinterpret_cast<const sockaddr*>(&ss), len) == -1) {
+            const auto err = errno;
+            close(this->m_client);
+            close(ls.sock);
+            throw std::system_error(err, std::system_category(), "connect");
+        }
+
+        if (kind == tcp) {
+            psb::set_socket_option(this->m_client, IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY");
+        }
+
+        this->m_server = psb::accept_raw_connection(ls.sock).sock;
+        close(ls.sock);
+    }
+
+    connection(const connection&)            = delete;
+    connection(connection&&)                 = delete;
+    connection& operator=(const connection&) = delete;
+    connection& operator=(connection&&)      = delete;
+
+    ~connection()
+    {
+        close(this->m_client);
+        close(this->m_server);
+    }
+
+    [[nodiscard]] int client() const noexcept { return this->m_client; }
+    [[nodiscard]] int server() const noexcept { return this->m_server; }
+
+private:
+    int m_client = -1;
+    int m_server = -1;
+};
+
+/**
+ * Writes all of @a buf to @a fd; the socket buffer is expected to have room for it.
+ */
+void write_all(int fd, std::span<const char> buf)
+{
+    while (!buf.empty()) {
+        const auto res = write(fd, buf.data(), buf.size());
+        if (res == -1) {
+            throw std::system_error(errno, std::system_category(), "write");
+        }
+
+        buf = buf.subspan(static_cast<std::size_t>(res));
+    }
+}
+
+/**
+ * Reads exactly @a buf.size() bytes from @a fd, waiting for them if the socket is non-blocking.
+ */
+void read_all(int fd, std::span<char> buf)
+{
+    while (!buf.empty()) {
+        const auto res = read(fd, buf.data(), buf.size());
+        if (res > 0) {
+            buf = buf.subspan(static_cast<std::size_t>(res));
+        }
+        else if (res == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            pollfd pfd{.fd = fd, .events = POLLIN, .revents = 0};
+            poll(&pfd, 1, -1);
+        }
+        else if (res == 0 || errno != EINTR) {
+            throw std::system_error(res == 0 ? ECONNRESET : errno, std::system_category(), "read");
+        }
+    }
+}
+
+const char* label(transport kind)
+{
+    return kind == tcp ? "tcp" : "unix";
+}
+
+/**
+ * Request/response round trips of `state.range(1)` bytes, the server echoing every message back.
+ */
+void BM_PingPong(benchmark::State& state)
+{
+    const auto kind = static_cast<transport>(state.range(0));
+    const connection conn(kind);
+
+    std::vector<char> buf(static_cast<std::size_t>(state.range(1)), 'x');
+    for (auto _ : state) {
+        write_all(conn.client(), buf);
+        read_all(conn.server(), buf);
+        write_all(conn.server(), buf);
+        read_all(conn.client(), buf);
+    }
+
+    state.SetLabel(label(kind));
+    state.SetBytesProcessed(state.iterations() * state.range(1) * 2);
+    state.counters["round_trips"] =
+        benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+
+/**
+ * One-way streaming in chunks of `state.range(1)` bytes.
+ */
+void BM_Stream(benchmark::State& state)
+{
+    const auto kind = static_cast<transport>(state.range(0));
+    const connection conn(kind);
+
+    std::vector<char> out(static_cast<std::size_t>(state.range(1)), 'x');
+    std::vector<char> in(out.size());
+    for (auto _ : state) {
+        write_all(conn.client(), out);
+        read_all(conn.server(), in);
+    }
+
+    state.SetLabel(label(kind));
+    state.SetBytesProcessed(state.iterations() * state.range(1));
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
+BENCHMARK(BM_PingPong)->ArgsProduct({{tcp, unix_stream}, {64, 4096}});
+BENCHMARK(BM_Stream)->ArgsProduct({{tcp, unix_stream}, {4096, 65536}});
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
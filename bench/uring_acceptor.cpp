@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+#include <unistd.h>
+
+#include "sockutils.h"
+#include "uring_acceptor.h"
+#include "utils.h"
+
+namespace {
+
+/**
+ * Establishes and accepts `state.range(0)` connections per iteration: with io_uring multishot accept when
+ * @a multishot is set, with a single accept_connections() call otherwise.
+ *
+ * Connecting is part of the measurement: multishot accept works in the background while the clients connect,
+ * so timing only the collection of the accepted sockets would flatter it.
+ */
+void run_acceptor(benchmark::State& state, bool multishot)
+{
+    const auto batch = static_cast<std::size_t>(state.range(0));
+    const loopback_listener listener;
+
+    std::vector<int> clients;
+    std::vector<psb::raw_accepted_socket_t> accepted(batch);
+
+    if (!multishot) {
+        // An idle io_uring is not free; keep the comparison fair by not creating one
+        for (auto _ : state) {
+            listener.connect_clients(batch, clients);
+            const auto result = psb::accept_connections(listener.sock(), accepted, accepted.size());
+
+            state.PauseTiming();
+            for (std::size_t i = 0; i < result.count; ++i) {
+                close(accepted[i].sock);
+            }
+
+            close_all(clients);
+            state.ResumeTiming();
+        }
+
+        set_counters(state, batch);
+        return;
+    }
+
+    psb::uring_acceptor acceptor(listener.sock(), {.queue_depth = 4096, .direct_descriptors = 0, .peer_address = 0});
+    if (!acceptor.is_multishot()) {
+        state.SkipWithError("io_uring multishot accept is not available");
+        return;
+    }
+
+    for (auto _ : state) {
+        listener.connect_clients(batch, clients);
+
+        std::size_t count = 0;
+        while (count < batch) {
+            count += acceptor.accept_connections(std::span(accepted).subspan(count), -1).count;
+        }
+
+        state.PauseTiming();
+        for (const auto& sock : accepted) {
+            close(sock.sock);
+        }
+
+        close_all(clients);
+        state.ResumeTiming();
+    }
+
+    set_counters(state, batch);
+}
+
+void BM_AcceptBatch(benchmark::State& state)
+{
+    run_acceptor(state, false);
+}
+
+void BM_UringMultishotAccept(benchmark::State& state)
+{
+    run_acceptor(state, true);
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
+BENCHMARK(BM_AcceptBatch)->RangeMultiplier(4)->Range(4, 256);
+BENCHMARK(BM_UringMultishotAccept)->RangeMultiplier(4)->Range(4, 256);
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
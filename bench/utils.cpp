@@ -0,0 +1,62 @@
+#include "utils.h"
+
+#include <cerrno>
+#include <system_error>
+
+#include <unistd.h>
+
+loopback_listener::loopback_listener() : m_ls(psb::create_listening_socket("127.0.0.1", 0, listener_options))
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (getsockname(this->m_ls.sock, reinterpret_cast<sockaddr*>(&this->m_addr), &this->m_len) == -1) {
+        throw std::system_error(errno, std::system_category(), "getsockname");
+    }
+}
+
+loopback_listener::~loopback_listener()
+{
+    close(this->m_ls.sock);
+}
+
+int loopback_listener::connect_client() const
+{
+    // Reset instead of FIN on close, so that the benchmark does not run out of ephemeral ports because of TIME_WAIT
+    constexpr linger no_linger{.l_onoff = 1, .l_linger = 0};
+
+    const auto sock = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock == -1) {
+        throw std::system_error(errno, std::system_category(), "socket");
+    }
+
+    setsockopt(sock, SOL_SOCKET, SO_LINGER, &no_linger, sizeof(no_linger));
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (connect(sock, reinterpret_cast<const sockaddr*>(&this->m_addr), this->m_len) == -1) {
+        const auto err = errno;
+        close(sock);
+        throw std::system_error(err, std::system_category(), "connect");
+    }
+
+    return sock;
+}
+
+void loopback_listener::connect_clients(std::size_t n, std::vector<int>& clients) const
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        clients.push_back(this->connect_client());
+    }
+}
+
+void close_all(std::vector<int>& fds)
+{
+    for (const auto fd : fds) {
+        close(fd);
+    }
+
+    fds.clear();
+}
+
+void set_counters(benchmark::State& state, std::size_t batch)
+{
+    const auto accepted = static_cast<double>(state.iterations()) * static_cast<double>(batch);
+    state.counters["accepts"] = benchmark::Counter(accepted, benchmark::Counter::kIsRate);
+}
@@ -0,0 +1,50 @@
+#ifndef EA41B14E_65BE_4DE6_BA86_AB3AFC3EFED4
+#define EA41B14E_65BE_4DE6_BA86_AB3AFC3EFED4
+
+#include <cstddef>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <sys/socket.h>
+
+#include "sockutils.h"
+
+constexpr psb::socket_options_t listener_options{
+    .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+};
+
+class loopback_listener {
+public:
+    loopback_listener();
+
+    loopback_listener(const loopback_listener&)            = delete;
+    loopback_listener(loopback_listener&&)                 = delete;
+    loopback_listener& operator=(const loopback_listener&) = delete;
+    loopback_listener& operator=(loopback_listener&&)      = delete;
+
+    ~loopback_listener();
+
+    [[nodiscard]] int sock() const noexcept { return this->m_ls.sock; }
+
+    /// Establishes a connection (reset rather than closed gracefully); it sits in the accept queue until accepted.
+    [[nodiscard]] int connect_client() const;
+
+    /// Establishes @a n connections with `connect_client()`.
+    void connect_clients(std::size_t n, std::vector<int>& clients) const;
+
+private:
+    psb::listening_socket_t m_ls;
+    sockaddr_storage m_addr{};
+    socklen_t m_len = sizeof(m_addr);
+};
+
+void close_all(std::vector<int>& fds);
+void set_counters(benchmark::State& state, std::size_t batch);
+
+/// Number of heap allocations made by the process so far.
+std::size_t allocation_count() noexcept;
+
+/// Reports @a allocations heap allocations as the "allocs" counter, averaged over iterations and @a per_iteration.
+void report_allocations(benchmark::State& state, std::size_t allocations, std::size_t per_iteration = 1);
+
+#endif /* EA41B14E_65BE_4DE6_BA86_AB3AFC3EFED4 */
@@ -0,0 +1,128 @@
+#include <benchmark/benchmark.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <system_error>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "sockutils.h"
+#include "utils.h"
+#include "zerocopy_receiver.h"
+
+namespace {
+
+/**
+ * A connected pair of TCP sockets over loopback; the client sends, the server receives.
+ */
+class tcp_pair {
+public:
+    tcp_pair() : m_client(m_listener.connect_client()), m_server(psb::accept_raw_connection(m_listener.sock()).sock) {}
+
+    tcp_pair(const tcp_pair&)            = delete;
+    tcp_pair(tcp_pair&&)                 = delete;
+    tcp_pair& operator=(const tcp_pair&) = delete;
+    tcp_pair& operator=(tcp_pair&&)      = delete;
+
+    ~tcp_pair()
+    {
+        close(this->m_client);
+        close(this->m_server);
+    }
+
+    [[nodiscard]] int client() const noexcept { return this->m_client; }
+    [[nodiscard]] int server() const noexcept { return this->m_server; }
+
+private:
+    loopback_listener m_listener;
+    int m_client;
+    int m_server;
+};
+
+/**
+ * Sends as much of the @a payload as the socket takes; returns false on error.
+ */
+bool send_some(int sock, const std::vector<std::byte>& payload, std::size_t& offset)
+{
+    const auto res = send(sock, payload.data() + offset, payload.size() - offset, MSG_DONTWAIT);
+    if (res > 0) {
+        offset += static_cast<std::size_t>(res);
+        return true;
+    }
+
+    return errno == EAGAIN;
+}
+
+// Streams `state.range(0)` bytes per iteration and reads them with recv() into a 64 KiB buffer.
+void BM_Recv(benchmark::State& state)
+{
+    tcp_pair pair;
+    const std::vector<std::byte> payload(static_cast<std::size_t>(state.range(0)), std::byte{'x'});
+    std::vector<std::byte> buf(64U << 10U);
+
+    for (auto _ : state) {
+        std::size_t sent     = 0;
+        std::size_t received = 0;
+        while (received < payload.size()) {
+            if (sent < payload.size() && !send_some(pair.client(), payload, sent)) {
+                state.SkipWithError("send() failed");
+                return;
+            }
+
+            const auto res = recv(pair.server(), buf.data(), buf.size(), MSG_DONTWAIT);
+            if (res > 0) {
+                received += static_cast<std::size_t>(res);
+            }
+            else if (res == 0 || errno != EAGAIN) {
+                state.SkipWithError("recv() failed");
+                return;
+            }
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// The same with zerocopy_receiver, which maps whole pages of payload and copies the rest.
+void BM_ZerocopyReceive(benchmark::State& state)
+{
+    tcp_pair pair;
+    const std::vector<std::byte> payload(static_cast<std::size_t>(state.range(0)), std::byte{'x'});
+    psb::zerocopy_receiver receiver(pair.server(), {.map_size = 0, .copy_size = 64U << 10U});
+
+    std::size_t mapped = 0;
+    for (auto _ : state) {
+        std::size_t sent     = 0;
+        std::size_t received = 0;
+        while (received < payload.size()) {
+            if (sent < payload.size() && !send_some(pair.client(), payload, sent)) {
+                state.SkipWithError("send() failed");
+                return;
+            }
+
+            std::error_code ec;
+            const auto result = receiver.receive(ec);
+            if (ec || result.eof) {
+                state.SkipWithError("receive() failed");
+                return;
+            }
+
+            benchmark::DoNotOptimize(result.mapped.data());
+            mapped += result.mapped.size();
+            received += result.mapped.size() + result.copied.size();
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    // Share of mapped bytes: loopback payload is never page-aligned, so it is 0 unless a suitable NIC is used
+    state.counters["mapped"] = static_cast<double>(mapped) / static_cast<double>(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
+BENCHMARK(BM_Recv)->RangeMultiplier(4)->Range(64 << 10, 4 << 20);
+BENCHMARK(BM_ZerocopyReceive)->RangeMultiplier(4)->Range(64 << 10, 4 << 20);
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
@@ -0,0 +1,118 @@
+#include <benchmark/benchmark.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <system_error>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "sockutils.h"
+#include "utils.h"
+#include "zerocopy_sender.h"
+
+namespace {
+
+/**
+ * A connected pair of TCP sockets over loopback.
+ */
+class tcp_pair {
+public:
+    tcp_pair() : m_client(m_listener.connect_client()), m_server(psb::accept_raw_connection(m_listener.sock()).sock) {}
+
+    tcp_pair(const tcp_pair&)            = delete;
+    tcp_pair(tcp_pair&&)                 = delete;
+    tcp_pair& operator=(const tcp_pair&) = delete;
+    tcp_pair& operator=(tcp_pair&&)      = delete;
+
+    ~tcp_pair()
+    {
+        close(this->m_client);
+        close(this->m_server);
+    }
+
+    [[nodiscard]] int client() const noexcept { return this->m_client; }
+    [[nodiscard]] int server() const noexcept { return this->m_server; }
+
+    /// Reads and discards everything the client has received.
+    void drain()
+    {
+        while (recv(this->m_client, this->m_buf.data(), this->m_buf.size(), MSG_DONTWAIT) > 0) {
+        }
+    }
+
+private:
+    loopback_listener m_listener;
+    int m_client;
+    int m_server;
+    std::vector<char> m_buf = std::vector<char>(1U << 20U);
+};
+
+// Ordinary send() of a `state.range(0)` byte response, read by the peer.
+void BM_Send(benchmark::State& state)
+{
+    tcp_pair pair;
+    const std::vector<std::byte> payload(static_cast<std::size_t>(state.range(0)), std::byte{'x'});
+
+    for (auto _ : state) {
+        for (std::span<const std::byte> rest(payload); !rest.empty();) {
+            const auto res = send(pair.server(), rest.data(), rest.size(), MSG_DONTWAIT);
+            if (res > 0) {
+                rest = rest.subspan(static_cast<std::size_t>(res));
+            }
+            else if (errno != EAGAIN) {
+                state.SkipWithError("send() failed");
+                return;
+            }
+
+            pair.drain();
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// The same with zerocopy_sender; the buffer is reused only after its completions have been reported.
+void BM_ZerocopySend(benchmark::State& state)
+{
+    tcp_pair pair;
+    const std::vector<std::byte> payload(static_cast<std::size_t>(state.range(0)), std::byte{'x'});
+    psb::zerocopy_sender sender(pair.server(), {.copy_threshold = 0});
+
+    std::size_t copied = 0;
+    const auto on_complete = [&copied](std::uint64_t /*tag*/, bool was_copied) { copied += was_copied ? 1 : 0; };
+
+    for (auto _ : state) {
+        for (std::span<const std::byte> rest(payload); !rest.empty();) {
+            std::error_code ec;
+            const auto result = sender.send(rest, 0, ec);
+            if (!ec) {
+                rest = rest.subspan(result.bytes);
+            }
+            else if (ec != std::errc::resource_unavailable_try_again) {
+                state.SkipWithError("send() failed");
+                return;
+            }
+
+            pair.drain();
+        }
+
+        while (sender.pending() != 0) {
+            sender.process_completions(on_complete);
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    // Loopback makes the kernel copy the data after all; on a NIC this should be zero
+    state.counters["copied"] = static_cast<double>(copied);
+}
+
+}  // namespace
+
+// NOLINTBEGIN(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
+BENCHMARK(BM_Send)->RangeMultiplier(4)->Range(4 << 10, 1 << 20);
+BENCHMARK(BM_ZerocopySend)->RangeMultiplier(4)->Range(4 << 10, 1 << 20);
+// NOLINTEND(cert-err58-cpp,cppcoreguidelines-avoid-non-const-global-variables)
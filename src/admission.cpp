@@ -0,0 +1,182 @@
+#include "admission.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <span>
+#include <system_error>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr double nanoseconds_per_second = 1e9;
+
+std::int64_t to_nanoseconds(psb::admission_controller::time_point tp) noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+}
+
+}  // namespace
+
+namespace psb {
+
+admission_controller::admission_controller(const admission_options_t& opts) noexcept
+    : m_interval(
+          opts.rate > 0 ? std::max<std::int64_t>(std::llround(nanoseconds_per_second / opts.rate), 1) : 0
+      ),
+      m_tolerance(0), m_max_inflight(opts.max_inflight), m_reset_on_overload(opts.reset_on_overload != 0)
+{
+    if (this->m_interval != 0) {
+        const auto burst = opts.burst != 0 ? static_cast<std::int64_t>(opts.burst)
+                                           : std::max<std::int64_t>(std::llround(opts.rate / 10), 1);
+        this->m_tolerance = (burst - 1) * this->m_interval;
+    }
+}
+
+std::size_t admission_controller::admit(std::size_t wanted, time_point now) noexcept
+{
+    std::size_t granted = wanted;
+    if (wanted == 0) {
+        return 0;
+    }
+
+    if (this->m_max_inflight != 0) {
+        auto current = this->m_inflight.load(std::memory_order_relaxed);
+        do {
+            if (current >= this->m_max_inflight) {
+                return 0;
+            }
+
+            granted = std::min<std::size_t>(wanted, this->m_max_inflight - current);
+        } while (!this->m_inflight.compare_exchange_weak(
+            current, current + static_cast<std::uint32_t>(granted), std::memory_order_relaxed
+        ));
+    }
+
+    if (this->m_interval != 0) {
+        // GCRA: a connection conforms if it arrives no earlier than its theoretical arrival time minus the tolerance
+        const auto t   = to_nanoseconds(now);
+        auto tat       = this->m_tat.load(std::memory_order_relaxed);
+        std::size_t n  = 0;
+        std::int64_t next{};
+        do {
+            const auto base  = std::max(tat, t);
+            const auto slack = t + this->m_tolerance - base;
+            n = slack < 0 ? 0 : std::min<std::size_t>(granted, static_cast<std::size_t>(slack / this->m_interval) + 1);
+            if (n == 0) {
+                break;
+            }
+
+            next = base + static_cast<std::int64_t>(n) * this->m_interval;
+        } while (!this->m_tat.compare_exchange_weak(tat, next, std::memory_order_relaxed));
+
+        if (n < granted && this->m_max_inflight != 0) {
+            this->m_inflight.fetch_sub(static_cast<std::uint32_t>(granted - n), std::memory_order_relaxed);
+        }
+
+        granted = n;
+    }
+
+    return granted;
+}
+
+std::size_t admission_controller::admit(std::size_t wanted) noexcept
+{
+    return this->admit(wanted, now());
+}
+
+void admission_controller::cancel(std::size_t count) noexcept
+{
+    if (count == 0) {
+        return;
+    }
+
+    if (this->m_interval != 0) {
+        this->m_tat.fetch_sub(static_cast<std::int64_t>(count) * this->m_interval, std::memory_order_relaxed);
+    }
+
+    this->release(count);
+}
+
+void admission_controller::release(std::size_t count) noexcept
+{
+    if (this->m_max_inflight != 0) {
+        this->m_inflight.fetch_sub(static_cast<std::uint32_t>(count), std::memory_order_relaxed);
+    }
+}
+
+void admission_controller::shed(int sock) noexcept
+{
+    // With a zero linger time, close() sends a reset and frees the socket at once, without TIME_WAIT
+    const linger lng{.l_onoff = 1, .l_linger = 0};
+    setsockopt(sock, SOL_SOCKET, SO_LINGER, &lng, sizeof(lng));
+    close(sock);
+    this->m_reset.fetch_add(1, std::memory_order_relaxed);
+}
+
+accept_batch_result_t
+admission_controller::accept_connections(int fd, std::span<accepted_socket_t> sockets, std::size_t budget)
+{
+    const auto limit = std::min(sockets.size(), budget);
+
+    if (!this->m_reset_on_overload) {
+        const auto admitted = this->admit(limit);
+        if (admitted == 0 && limit != 0) {
+            this->m_paused.fetch_add(1, std::memory_order_relaxed);
+            return {.count = 0, .error = std::make_error_code(std::errc::resource_unavailable_try_again)};
+        }
+
+        const auto result = psb::accept_connections(fd, sockets, admitted);
+        this->cancel(admitted - result.count);
+        return result;
+    }
+
+    auto result         = psb::accept_connections(fd, sockets, limit);
+    const auto admitted = this->admit(result.count);
+    for (const auto& s : sockets.subspan(admitted, result.count - admitted)) {
+        this->shed(s.sock);
+    }
+
+    result.count = admitted;
+    return result;
+}
+
+std::chrono::nanoseconds admission_controller::retry_after(time_point now) const noexcept
+{
+    if (this->m_interval == 0) {
+        return {};
+    }
+
+    const auto wait = this->m_tat.load(std::memory_order_relaxed) - this->m_tolerance - to_nanoseconds(now);
+    return std::chrono::nanoseconds(std::max<std::int64_t>(wait, 0));
+}
+
+std::chrono::nanoseconds admission_controller::retry_after() const noexcept
+{
+    return this->retry_after(now());
+}
+
+admission_stats_t admission_controller::stats() const noexcept
+{
+    return {
+        .inflight = this->m_inflight.load(std::memory_order_relaxed),
+        .paused   = this->m_paused.load(std::memory_order_relaxed),
+        .reset    = this->m_reset.load(std::memory_order_relaxed),
+    };
+}
+
+admission_controller::time_point admission_controller::now() noexcept
+{
+    // The same clock as steady_clock, read from the vDSO without the hardware counter; ticks every jiffy
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return time_point(std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec));
+}
+
+}  // namespace psb
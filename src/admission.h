@@ -0,0 +1,149 @@
+#ifndef D9BDF4B9_5D55_4578_A2E3_A65FDA6F7C8C
+#define D9BDF4B9_5D55_4578_A2E3_A65FDA6F7C8C
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "export.h"
+#include "sockutils.h"
+
+namespace psb {
+
+struct admission_options_t {
+    double rate;                 // Connections admitted per second on average; 0 disables the rate limit
+    std::uint32_t burst;         // Connections admitted at once above the rate; 0 selects a tenth of a second's worth
+    std::uint32_t max_inflight;  // Admitted connections not yet released; 0 disables the limit
+    int reset_on_overload;       // Accept and reset excess connections instead of leaving them in the accept queue
+};
+
+struct admission_stats_t {
+    std::uint64_t inflight{};  // Admitted connections not yet released; tracked only with max_inflight
+    std::uint64_t paused{};    // Times accepting was paused because no connection could be admitted
+    std::uint64_t reset{};     // Connections accepted and reset because they could not be admitted
+};
+
+/**
+ * @brief Limits the rate of accepted connections (token bucket) and the number of connections being served.
+ *
+ * On overload, the controller either stops accepting, leaving connections in the kernel's accept queue (where they
+ * are eventually dropped, or make clients retry, once the queue is full), or with `reset_on_overload` accepts them
+ * and closes them with `SO_LINGER` 0 so that clients get a reset at once instead of waiting for a timeout.
+ *
+ * The token bucket is implemented as GCRA on a single atomic with a coarse monotonic clock (a few milliseconds of
+ * resolution, but only a few nanoseconds per reading), so the admission check costs two uncontended atomic
+ * operations and is amortised over the batch by `accept_connections()`. The controller may be shared by all accept
+ * threads; `release()` may be called from any thread.
+ */
+class PSB_SOCKUTILS_EXPORT admission_controller {
+public:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    /**
+     * @brief Creates the controller with a full token bucket.
+     *
+     * @param opts Admission options.
+     */
+    explicit admission_controller(const admission_options_t& opts) noexcept;
+
+    admission_controller(const admission_controller&)            = delete;
+    admission_controller(admission_controller&&)                 = delete;
+    admission_controller& operator=(const admission_controller&) = delete;
+    admission_controller& operator=(admission_controller&&)      = delete;
+    ~admission_controller() noexcept                             = default;
+
+    /**
+     * @brief Admits up to @a wanted connections, taking a token and an in-flight slot for each.
+     *
+     * @param wanted Number of connections to admit.
+     * @return Number of connections admitted.
+     */
+    std::size_t admit(std::size_t wanted) noexcept;
+
+    /**
+     * @brief Admits up to @a wanted connections at the time @a now.
+     *
+     * @param wanted Number of connections to admit.
+     * @param now Current time.
+     * @return Number of connections admitted.
+     */
+    std::size_t admit(std::size_t wanted, time_point now) noexcept;
+
+    /**
+     * @brief Returns the tokens and slots of @a count admitted connections which were not accepted after all.
+     *
+     * @param count Number of connections.
+     */
+    void cancel(std::size_t count) noexcept;
+
+    /**
+     * @brief Releases the in-flight slots of @a count admitted connections once they have been served.
+     *
+     * @param count Number of connections.
+     */
+    void release(std::size_t count = 1) noexcept;
+
+    /**
+     * @brief Closes the accepted socket @a sock with a reset (`SO_LINGER` 0) and counts it in `reset`.
+     *
+     * @param sock Accepted socket.
+     */
+    void shed(int sock) noexcept;
+
+    /**
+     * @brief Accepts up to @a budget connections on @a fd, as far as they are admitted.
+     *
+     * If no connection can be admitted and `reset_on_overload` is not set, nothing is accepted and the error is
+     * `std::errc::resource_unavailable_try_again`: the caller should stop polling @a fd for `retry_after()`.
+     * With `reset_on_overload`, the connections which cannot be admitted are accepted and shed.
+     *
+     * Every connection stored in @a sockets must be `release()`d when it has been served.
+     *
+     * @param fd Listening socket.
+     * @param sockets Storage for the accepted sockets; the first `count` elements are filled in.
+     * @param budget Maximum number of connections to accept, including the shed ones.
+     * @return Number of admitted sockets and the error which stopped the batch, if any.
+     */
+    accept_batch_result_t accept_connections(int fd, std::span<accepted_socket_t> sockets, std::size_t budget);
+
+    /**
+     * @brief Gets the time until a token becomes available; zero if one is available now.
+     *
+     * When the in-flight limit is what blocks admission, there is no telling when a slot is released; callers should
+     * then poll at an interval of their choice.
+     */
+    [[nodiscard]] std::chrono::nanoseconds retry_after() const noexcept;
+
+    /**
+     * @brief Gets the time until a token becomes available at the time @a now.
+     */
+    [[nodiscard]] std::chrono::nanoseconds retry_after(time_point now) const noexcept;
+
+    /**
+     * @brief Gets the counters.
+     */
+    [[nodiscard]] admission_stats_t stats() const noexcept;
+
+    /**
+     * @brief Reads the clock used for admission: `CLOCK_MONOTONIC_COARSE`, in the epoch of `steady_clock`.
+     */
+    static time_point now() noexcept;
+
+private:
+    std::int64_t m_interval;   // Nanoseconds per token; 0 if the rate is unlimited
+    std::int64_t m_tolerance;  // Burst as a time span: (burst - 1) * interval
+    std::uint32_t m_max_inflight;
+    bool m_reset_on_overload;
+
+    // Theoretical arrival time of the next connection, nanoseconds since the steady_clock epoch
+    alignas(64) std::atomic<std::int64_t> m_tat{0};
+    std::atomic<std::uint32_t> m_inflight{0};
+    alignas(64) std::atomic<std::uint64_t> m_paused{0};
+    std::atomic<std::uint64_t> m_reset{0};
+};
+
+}  // namespace psb
+
+#endif /* D9BDF4B9_5D55_4578_A2E3_A65FDA6F7C8C */
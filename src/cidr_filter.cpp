@@ -0,0 +1,447 @@
+#include "cidr_filter.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "parse_address.h"
+
+namespace {
+
+constexpr unsigned int key_bits      = 128;
+constexpr unsigned int half_bits     = 64;
+constexpr unsigned int mapped_prefix = 96;                     // ::ffff:0:0/96
+constexpr std::uint64_t mapped_lo    = 0x0000'FFFF'0000'0000;  // Low half of ::ffff:0.0.0.0
+
+struct bits_t {
+    std::uint64_t hi;
+    std::uint64_t lo;
+};
+
+constexpr bits_t mask(bits_t key, unsigned int len) noexcept
+{
+    constexpr auto ones = ~std::uint64_t{0};
+    const auto hi_mask  = len >= half_bits ? ones : len == 0 ? 0 : ones << (half_bits - len);
+    const auto lo_mask  = len <= half_bits ? 0 : len >= key_bits ? ones : ones << (key_bits - len);
+    return {.hi = key.hi & hi_mask, .lo = key.lo & lo_mask};
+}
+
+constexpr unsigned int bit(bits_t key, unsigned int pos) noexcept
+{
+    return pos < half_bits ? static_cast<unsigned int>(key.hi >> (half_bits - 1 - pos)) & 1U
+                           : static_cast<unsigned int>(key.lo >> (key_bits - 1 - pos)) & 1U;
+}
+
+constexpr unsigned int common_prefix(bits_t a, bits_t b) noexcept
+{
+    if (const auto x = a.hi ^ b.hi; x != 0) {
+        return static_cast<unsigned int>(std::countl_zero(x));
+    }
+
+    return half_bits + static_cast<unsigned int>(std::countl_zero(a.lo ^ b.lo));
+}
+
+constexpr bool has_prefix(bits_t key, bits_t prefix, unsigned int len) noexcept
+{
+    const auto masked = mask(key, len);
+    return masked.hi == prefix.hi && masked.lo == prefix.lo;
+}
+
+bits_t from_bytes(const std::uint8_t* bytes) noexcept
+{
+    bits_t key{};
+    for (std::size_t i = 0; i < sizeof(in6_addr) / 2; ++i) {
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        key.hi = (key.hi << 8U) | bytes[i];
+        key.lo = (key.lo << 8U) | bytes[i + sizeof(in6_addr) / 2];
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+    return key;
+}
+
+in6_addr to_addr(bits_t key) noexcept
+{
+    in6_addr addr{};
+    for (std::size_t i = 0; i < sizeof(in6_addr) / 2; ++i) {
+        const auto shift                       = half_bits - 8 * (i + 1);
+        addr.s6_addr[i]                        = static_cast<std::uint8_t>(key.hi >> shift);
+        addr.s6_addr[i + sizeof(in6_addr) / 2] = static_cast<std::uint8_t>(key.lo >> shift);
+    }
+
+    return addr;
+}
+
+bits_t from_ipv4(std::uint32_t host_order) noexcept
+{
+    return {.hi = 0, .lo = mapped_lo | host_order};
+}
+
+/**
+ * Builds the classic BPF program of `attach_cidr_filter()`.
+ */
+class filter_builder {
+public:
+    explicit filter_builder(bool allowlist) noexcept
+        : m_match(allowlist ? accept : drop), m_nomatch(allowlist ? drop : accept)
+    {
+    }
+
+    std::vector<sock_filter> build(const std::vector<std::pair<in6_addr, unsigned int>>& prefixes)
+    {
+        // Only SYNs are filtered; skb->data points to the TCP header
+        this->emit(BPF_LD | BPF_B | BPF_ABS, tcp_flags_offset);
+        this->jump(BPF_JSET | BPF_K, tcp_syn, 1, 0);
+        this->emit(BPF_RET | BPF_K, accept);
+
+        this->emit(BPF_LD | BPF_H | BPF_ABS, static_cast<std::uint32_t>(SKF_AD_OFF + SKF_AD_PROTOCOL));
+        this->jump(BPF_JEQ | BPF_K, ETH_P_IP, 1, 0);
+        const auto skip_ipv4 = this->m_code.size();
+        this->emit(BPF_JMP | BPF_JA, 0);
+
+        for (const auto& [addr, len] : prefixes) {
+            const auto key = from_bytes(std::data(addr.s6_addr));
+            if (len <= mapped_prefix && has_prefix(from_ipv4(0), key, len)) {
+                // Covers all of the IPv4-mapped space
+                this->emit(BPF_RET | BPF_K, this->m_match);
+                break;
+            }
+
+            if (len > mapped_prefix && has_prefix(key, from_ipv4(0), mapped_prefix)) {
+                this->test_words(key, len - mapped_prefix, ipv4_source_offset);
+            }
+        }
+
+        this->emit(BPF_RET | BPF_K, this->m_nomatch);
+        this->m_code[skip_ipv4].k = static_cast<std::uint32_t>(this->m_code.size() - skip_ipv4 - 1);
+
+        this->emit(BPF_LD | BPF_H | BPF_ABS, static_cast<std::uint32_t>(SKF_AD_OFF + SKF_AD_PROTOCOL));
+        this->jump(BPF_JEQ | BPF_K, ETH_P_IPV6, 1, 0);
+        this->emit(BPF_RET | BPF_K, accept);
+
+        for (const auto& [addr, len] : prefixes) {
+            const auto key = from_bytes(std::data(addr.s6_addr));
+            if (len == 0) {
+                this->emit(BPF_RET | BPF_K, this->m_match);
+                break;
+            }
+
+            // Prefixes inside the IPv4-mapped space never match the source of an IPv6 packet
+            if (len <= mapped_prefix || !has_prefix(key, from_ipv4(0), mapped_prefix)) {
+                this->test_words(key, len, ipv6_source_offset);
+            }
+        }
+
+        this->emit(BPF_RET | BPF_K, this->m_nomatch);
+        return std::move(this->m_code);
+    }
+
+private:
+    static constexpr std::uint32_t accept            = 0xFFFF'FFFF;
+    static constexpr std::uint32_t drop              = 0;
+    static constexpr std::uint32_t tcp_flags_offset  = 13;
+    static constexpr std::uint32_t tcp_syn           = 0x02;
+    static constexpr std::int32_t ipv4_source_offset = SKF_NET_OFF + 12;
+    static constexpr std::int32_t ipv6_source_offset = SKF_NET_OFF + 8;
+    static constexpr unsigned int word_bits          = 32;
+
+    void emit(std::uint16_t code, std::uint32_t k) { this->m_code.push_back({.code = code, .jt = 0, .jf = 0, .k = k}); }
+
+    void jump(std::uint16_t op, std::uint32_t k, std::uint8_t jt, std::uint8_t jf)
+    {
+        this->m_code.push_back({.code = static_cast<std::uint16_t>(BPF_JMP | op), .jt = jt, .jf = jf, .k = k});
+    }
+
+    /**
+     * Emits the comparison of the first @a len bits of the address at @a offset with the low bits of @a key (the IPv4
+     * address for IPv4, all of it for IPv6), followed by `ret match`; a mismatch jumps past the `ret`.
+     */
+    void test_words(bits_t key, unsigned int len, std::int32_t offset)
+    {
+        const auto total   = offset == ipv4_source_offset ? word_bits : key_bits;
+        const auto words   = (len + word_bits - 1) / word_bits;
+        const auto word_at = [key, total](unsigned int w) {
+            const auto pos  = key_bits - total + w * word_bits;
+            const auto half = pos < half_bits ? key.hi : key.lo;
+            return static_cast<std::uint32_t>(half >> (half_bits - word_bits - pos % half_bits));
+        };
+
+        // Instructions per word: ld, [and,] jeq
+        const auto cost = [len, words](unsigned int w) { return w + 1 == words && len % word_bits != 0 ? 3U : 2U; };
+        for (unsigned int w = 0; w < words; ++w) {
+            unsigned int rest = 1;  // The ret
+            for (auto v = w + 1; v < words; ++v) {
+                rest += cost(v);
+            }
+
+            this->emit(BPF_LD | BPF_W | BPF_ABS, static_cast<std::uint32_t>(offset + static_cast<std::int32_t>(4 * w)));
+            auto value = word_at(w);
+            if (cost(w) == 3) {
+                const auto word_mask = ~std::uint32_t{0} << (word_bits - len % word_bits);
+                this->emit(BPF_ALU | BPF_AND | BPF_K, word_mask);
+                value &= word_mask;
+            }
+
+            this->jump(BPF_JEQ | BPF_K, value, 0, static_cast<std::uint8_t>(rest));
+        }
+
+        this->emit(BPF_RET | BPF_K, this->m_match);
+    }
+
+    std::uint32_t m_match;
+    std::uint32_t m_nomatch;
+    std::vector<sock_filter> m_code;
+};
+
+}  // namespace
+
+namespace psb {
+
+void cidr_set::insert(key_t key, unsigned int len)
+{
+    const auto make_node = [](key_t prefix, unsigned int prefix_len, bool terminal) {
+        return node_t{
+            .key = prefix, .child = {0, 0}, .len = static_cast<std::uint8_t>(prefix_len), .terminal = terminal
+        };
+    };
+
+    if (this->m_nodes.empty()) {
+        this->m_nodes.push_back(make_node({0, 0}, 0, false));
+    }
+
+    const auto masked = mask({key.hi, key.lo}, len);
+    key               = {masked.hi, masked.lo};
+
+    std::uint32_t idx = 0;
+    for (;;) {
+        if (this->m_nodes[idx].len == len) {
+            if (!this->m_nodes[idx].terminal) {
+                this->m_nodes[idx].terminal = true;
+                ++this->m_size;
+            }
+
+            return;
+        }
+
+        const auto b     = bit({key.hi, key.lo}, this->m_nodes[idx].len);
+        const auto child = this->m_nodes[idx].child.at(b);
+        const auto next  = static_cast<std::uint32_t>(this->m_nodes.size());
+        if (child == 0) {
+            this->m_nodes.push_back(make_node(key, len, true));
+            this->m_nodes[idx].child.at(b) = next;
+            ++this->m_size;
+            return;
+        }
+
+        const auto& cn = this->m_nodes[child];
+        const auto cpl = std::min({common_prefix({key.hi, key.lo}, {cn.key.hi, cn.key.lo}), len, unsigned{cn.len}});
+        if (cpl == cn.len) {
+            idx = child;
+            continue;
+        }
+
+        // The new prefix branches off (or ends) between the node and its child: split the edge
+        const auto child_bit = bit({cn.key.hi, cn.key.lo}, cpl);
+        if (cpl == len) {
+            auto split                = make_node(key, len, true);
+            split.child.at(child_bit) = child;
+            this->m_nodes.push_back(split);
+        }
+        else {
+            const auto prefix             = mask({key.hi, key.lo}, cpl);
+            auto split                    = make_node({prefix.hi, prefix.lo}, cpl, false);
+            split.child.at(child_bit)     = child;
+            split.child.at(1 - child_bit) = next + 1;
+            this->m_nodes.push_back(split);
+            this->m_nodes.push_back(make_node(key, len, true));
+        }
+
+        this->m_nodes[idx].child.at(b) = next;
+        ++this->m_size;
+        return;
+    }
+}
+
+void cidr_set::add(const in_addr& addr, unsigned int prefix_len)
+{
+    this->insert({0, from_ipv4(ntohl(addr.s_addr)).lo}, mapped_prefix + std::min(prefix_len, key_bits - mapped_prefix));
+}
+
+void cidr_set::add(const in6_addr& addr, unsigned int prefix_len)
+{
+    const auto key = from_bytes(std::data(addr.s6_addr));
+    this->insert({key.hi, key.lo}, std::min(prefix_len, key_bits));
+}
+
+void cidr_set::add(std::string_view cidr, std::error_code& ec)
+{
+    ec.clear();
+
+    const auto slash   = cidr.find('/');
+    const auto address = cidr.substr(0, slash);
+    const auto is_ipv6 = address.find(':') != std::string_view::npos;
+    const auto max_len = is_ipv6 ? key_bits : key_bits - mapped_prefix;
+
+    unsigned int len = max_len;
+    if (slash != std::string_view::npos) {
+        const auto digits     = cidr.substr(slash + 1);
+        const auto [ptr, err] = std::from_chars(digits.data(), digits.data() + digits.size(), len);
+        if (digits.empty() || err != std::errc{} || ptr != digits.data() + digits.size() || len > max_len) {
+            ec = std::make_error_code(std::errc::invalid_argument);
+            return;
+        }
+    }
+
+    if (is_ipv6) {
+        in6_addr addr{};
+        if (parse_ipv6(address, addr) != std::errc{}) {
+            ec = std::make_error_code(std::errc::invalid_argument);
+            return;
+        }
+
+        this->add(addr, len);
+    }
+    else {
+        in_addr addr{};
+        if (parse_ipv4(address, addr) != std::errc{}) {
+            ec = std::make_error_code(std::errc::invalid_argument);
+            return;
+        }
+
+        this->add(addr, len);
+    }
+}
+
+void cidr_set::add(std::string_view cidr)
+{
+    std::error_code ec;
+    this->add(cidr, ec);
+    if (ec) [[unlikely]] {
+        throw std::invalid_argument(std::format("Invalid CIDR prefix: {}", cidr));
+    }
+}
+
+bool cidr_set::contains(const sockaddr_storage& ss, socklen_t len) const noexcept
+{
+    bits_t key{};
+    if (ss.ss_family == AF_INET && len >= sizeof(sockaddr_in)) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        key = from_ipv4(ntohl(reinterpret_cast<const sockaddr_in&>(ss).sin_addr.s_addr));
+    }
+    else if (ss.ss_family == AF_INET6 && len >= sizeof(sockaddr_in6)) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        key = from_bytes(std::data(reinterpret_cast<const sockaddr_in6&>(ss).sin6_addr.s6_addr));
+    }
+    else {
+        return false;
+    }
+
+    if (this->m_nodes.empty()) {
+        return false;
+    }
+
+    // The root (length 0) matches every address; every other node is checked on the way down
+    const auto* node = this->m_nodes.data();
+    for (;;) {
+        if (node->terminal) {
+            return true;
+        }
+
+        if (node->len == key_bits) {
+            return false;
+        }
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        const auto child = node->child[bit(key, node->len)];
+        if (child == 0) {
+            return false;
+        }
+
+        node = &this->m_nodes[child];
+        if (!has_prefix(key, {node->key.hi, node->key.lo}, node->len)) {
+            return false;
+        }
+    }
+}
+
+bool cidr_set::contains(const raw_accepted_socket_t& sock) const noexcept
+{
+    return this->contains(sock.addr, std::min(sock.addr_len, static_cast<socklen_t>(sizeof(sock.addr))));
+}
+
+std::size_t cidr_set::size() const noexcept
+{
+    return this->m_size;
+}
+
+std::vector<std::pair<in6_addr, unsigned int>> cidr_set::minimal_prefixes() const
+{
+    std::vector<std::pair<in6_addr, unsigned int>> result;
+    if (this->m_nodes.empty()) {
+        return result;
+    }
+
+    std::vector<std::uint32_t> stack{0};
+    while (!stack.empty()) {
+        const auto& node = this->m_nodes[stack.back()];
+        stack.pop_back();
+
+        if (node.terminal) {
+            result.emplace_back(to_addr({node.key.hi, node.key.lo}), node.len);
+            continue;
+        }
+
+        // Child 1 first, so that child 0 is visited first
+        for (const auto child : {node.child[1], node.child[0]}) {
+            if (child != 0) {
+                stack.push_back(child);
+            }
+        }
+    }
+
+    return result;
+}
+
+void attach_cidr_filter(int sock, const cidr_set& set, bool allowlist, std::error_code& ec)
+{
+    ec.clear();
+
+    filter_builder builder(allowlist);
+    auto code = builder.build(set.minimal_prefixes());
+    if (code.size() > max_filter_instructions) [[unlikely]] {
+        ec = std::make_error_code(std::errc::argument_list_too_long);
+        return;
+    }
+
+    const sock_fprog prog{.len = static_cast<unsigned short>(code.size()), .filter = code.data()};
+    if (setsockopt(sock, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) != 0) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
+    }
+}
+
+void attach_cidr_filter(int sock, const cidr_set& set, bool allowlist)
+{
+    std::error_code ec;
+    attach_cidr_filter(sock, set, allowlist, ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, "attach_cidr_filter() failed");
+    }
+}
+
+}  // namespace psb
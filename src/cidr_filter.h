@@ -0,0 +1,143 @@
+#ifndef A2A90025_5CF3_4331_94A8_DFAAFB49C2C7
+#define A2A90025_5CF3_4331_94A8_DFAAFB49C2C7
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "export.h"
+#include "sockutils.h"
+
+namespace psb {
+
+/// Maximum length of a classic BPF program (`BPF_MAXINSNS`).
+inline constexpr std::size_t max_filter_instructions = 4096;
+
+/**
+ * @brief Set of IPv4 and IPv6 prefixes (CIDR blocks) which matches raw socket addresses.
+ *
+ * The prefixes are kept in a path-compressed binary radix trie over 128-bit keys; IPv4 prefixes are stored as
+ * IPv4-mapped IPv6 prefixes (`::ffff:0:0/96`), so IPv4 peers of dual-stack sockets match them as well. A lookup
+ * compares at most one node per distinct branching bit and stops at the first prefix covering the address, without
+ * formatting the address or allocating memory.
+ *
+ * The set is not thread-safe for modification; concurrent lookups are fine.
+ */
+class PSB_SOCKUTILS_EXPORT cidr_set {
+public:
+    /**
+     * @brief Adds the prefix @a cidr, e.g., `192.0.2.0/24`, `2001:db8::/32`, or a single address.
+     *
+     * @param cidr Address with an optional prefix length.
+     * @throw std::invalid_argument @a cidr is not a valid prefix.
+     */
+    void add(std::string_view cidr);
+
+    /**
+     * @brief Adds the prefix @a cidr; variant which does not throw on invalid input.
+     *
+     * @param cidr Address with an optional prefix length.
+     * @param ec Set to `std::errc::invalid_argument` if @a cidr is not a valid prefix, cleared otherwise.
+     */
+    void add(std::string_view cidr, std::error_code& ec);
+
+    /**
+     * @brief Adds the IPv4 prefix @a addr/@a prefix_len.
+     *
+     * @param addr Network address; bits beyond the prefix length are ignored.
+     * @param prefix_len Prefix length, up to 32.
+     */
+    void add(const in_addr& addr, unsigned int prefix_len);
+
+    /**
+     * @brief Adds the IPv6 prefix @a addr/@a prefix_len.
+     *
+     * @param addr Network address; bits beyond the prefix length are ignored.
+     * @param prefix_len Prefix length, up to 128.
+     */
+    void add(const in6_addr& addr, unsigned int prefix_len);
+
+    /**
+     * @brief Tells whether the IP address in @a ss is covered by a prefix of the set.
+     *
+     * @param ss Socket address; addresses other than IPv4 and IPv6 never match.
+     * @param len Length of the socket address.
+     * @return Whether the address matches.
+     */
+    [[nodiscard]] bool contains(const sockaddr_storage& ss, socklen_t len) const noexcept;
+
+    /**
+     * @brief Tells whether the peer address of the accepted socket @a sock is covered by a prefix of the set.
+     */
+    [[nodiscard]] bool contains(const raw_accepted_socket_t& sock) const noexcept;
+
+    /**
+     * @brief Gets the number of distinct prefixes added.
+     */
+    [[nodiscard]] std::size_t size() const noexcept;
+
+    /**
+     * @brief Gets the prefixes not covered by shorter ones: the ones a filter has to test.
+     *
+     * @return The prefixes, as IPv6 addresses (IPv4 ones mapped) and prefix lengths, in address order.
+     */
+    [[nodiscard]] std::vector<std::pair<in6_addr, unsigned int>> minimal_prefixes() const;
+
+private:
+    struct key_t {
+        std::uint64_t hi;
+        std::uint64_t lo;
+    };
+
+    struct node_t {
+        key_t key;                           // Prefix bits, zero beyond `len`
+        std::array<std::uint32_t, 2> child;  // Indices into m_nodes by the bit after the prefix; 0 for none
+        std::uint8_t len;                    // Prefix length; a child's is greater than its parent's
+        bool terminal;                       // Whether the prefix itself is in the set
+    };
+
+    void insert(key_t key, unsigned int len);
+
+    std::vector<node_t> m_nodes;
+    std::size_t m_size = 0;
+};
+
+/**
+ * @brief Attaches a classic BPF socket filter to the listening TCP socket @a sock which drops SYNs by source address.
+ *
+ * With @a allowlist, only connections from the prefixes of @a set are let through; otherwise, connections from
+ * them are dropped. Dropped SYNs never reach the accept queue; the client retransmits them until it gives up.
+ * Packets other than SYNs are let through after three instructions, so the filter, which accepted sockets inherit,
+ * costs next to nothing on established connections.
+ *
+ * The program tests the prefixes one after another, so it suits rule sets of up to a few thousand prefixes; use
+ * `cidr_set::contains()` after accepting for larger ones. Attaching a new filter replaces the previous one.
+ *
+ * @param sock Listening TCP socket (IPv4, IPv6 or dual-stack).
+ * @param set Prefixes.
+ * @param allowlist Whether @a set lists the allowed networks rather than the denied ones.
+ * @throw std::system_error The program would exceed `max_filter_instructions` (`std::errc::argument_list_too_long`),
+ * or `setsockopt(SO_ATTACH_FILTER)` failed.
+ */
+PSB_SOCKUTILS_EXPORT void attach_cidr_filter(int sock, const cidr_set& set, bool allowlist);
+
+/**
+ * @brief Attaches a classic BPF socket filter which drops SYNs by source address; non-throwing variant.
+ *
+ * @param sock Listening TCP socket.
+ * @param set Prefixes.
+ * @param allowlist Whether @a set lists the allowed networks rather than the denied ones.
+ * @param ec Set to the error if the call failed, cleared otherwise.
+ */
+PSB_SOCKUTILS_EXPORT void attach_cidr_filter(int sock, const cidr_set& set, bool allowlist, std::error_code& ec);
+
+}  // namespace psb
+
+#endif /* A2A90025_5CF3_4331_94A8_DFAAFB49C2C7 */
@@ -0,0 +1,223 @@
+#include "epoll_acceptor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "admission.h"
+#include "fd_reserve.h"
+
+namespace {
+
+constexpr std::size_t default_accept_budget = 64;
+constexpr std::chrono::milliseconds min_pause{1};
+// How long to stop watching a listener when the fd reserve could not drop any of its connections
+constexpr std::chrono::milliseconds reserve_pause{10};
+
+class [[nodiscard]] fd_closer {
+public:
+    explicit fd_closer(int fd) noexcept : m_fd(fd) {}
+
+    fd_closer(const fd_closer&)            = delete;
+    fd_closer(fd_closer&&)                 = delete;
+    fd_closer& operator=(const fd_closer&) = delete;
+    fd_closer& operator=(fd_closer&&)      = delete;
+
+    ~fd_closer() noexcept { close(this->m_fd); }
+
+private:
+    int m_fd;
+};
+
+void add_to_epoll(int epfd, int fd, std::uint32_t events)
+{
+    epoll_event event{};
+    event.events  = events;
+    event.data.fd = fd;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &event) == -1) [[unlikely]] {
+        throw std::system_error(errno, std::generic_category(), "epoll_ctl(EPOLL_CTL_ADD) failed");
+    }
+}
+
+}  // namespace
+
+namespace psb {
+
+epoll_acceptor::epoll_acceptor(
+    std::span<const int> listeners, const epoll_acceptor_options_t& opts, accept_callback_t on_accept,
+    error_callback_t on_error
+)
+    : m_listeners(listeners.begin(), listeners.end()),
+      m_budget(opts.accept_budget != 0 ? opts.accept_budget : default_accept_budget), m_admission(opts.admission),
+      m_reserve(opts.reserve),
+      m_socket_options(opts.socket_options != nullptr ? *opts.socket_options : socket_options_t{}),
+      m_on_accept(std::move(on_accept)), m_on_error(std::move(on_error)),
+      m_event_fd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+{
+    if (this->m_event_fd == -1) [[unlikely]] {
+        throw std::system_error(errno, std::generic_category(), "eventfd() failed");
+    }
+}
+
+epoll_acceptor::~epoll_acceptor() noexcept
+{
+    close(this->m_event_fd);
+}
+
+void epoll_acceptor::run()
+{
+    const auto epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd == -1) [[unlikely]] {
+        throw std::system_error(errno, std::generic_category(), "epoll_create1() failed");
+    }
+
+    const fd_closer closer(epfd);
+
+    // The eventfd is never read, so once signalled it wakes up every thread, and keeps doing so
+    add_to_epoll(epfd, this->m_event_fd, EPOLLIN);
+    for (const auto sock : this->m_listeners) {
+        add_to_epoll(epfd, sock, EPOLLIN | EPOLLEXCLUSIVE);
+    }
+
+    std::vector<accepted_socket_t> sockets(this->m_budget);
+    std::vector<epoll_event> events(this->m_listeners.size() + 1);
+
+    // Listeners this thread has stopped watching because admission control paused accepting or the fd reserve could
+    // not drop connections, and when to resume
+    std::vector<int> paused;
+    admission_controller::time_point resume_at{};
+
+    // The listener stays readable, so stop watching it for now
+    const auto pause = [epfd, &paused, &resume_at](int sock, std::chrono::nanoseconds delay) {
+        if (epoll_ctl(epfd, EPOLL_CTL_DEL, sock, nullptr) == -1) [[unlikely]] {
+            throw std::system_error(errno, std::generic_category(), "epoll_ctl(EPOLL_CTL_DEL) failed");
+        }
+
+        paused.push_back(sock);
+        resume_at = admission_controller::now() + delay;
+    };
+
+    while (!this->m_stopped.load(std::memory_order_relaxed)) {
+        int timeout = -1;
+        if (!paused.empty()) {
+            const auto wait = std::chrono::ceil<std::chrono::milliseconds>(resume_at - admission_controller::now());
+            timeout         = static_cast<int>(std::max<std::chrono::milliseconds::rep>(wait.count(), 0));
+        }
+
+        const auto n = epoll_wait(epfd, events.data(), static_cast<int>(events.size()), timeout);
+        if (n == -1) [[unlikely]] {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            throw std::system_error(errno, std::generic_category(), "epoll_wait() failed");
+        }
+
+        if (!paused.empty() && admission_controller::now() >= resume_at) {
+            for (const auto sock : paused) {
+                add_to_epoll(epfd, sock, EPOLLIN | EPOLLEXCLUSIVE);
+            }
+
+            paused.clear();
+        }
+
+        for (const auto& event : std::span(events).first(static_cast<std::size_t>(n))) {
+            const auto sock = event.data.fd;
+            if (sock == this->m_event_fd || this->m_stopped.load(std::memory_order_relaxed)) {
+                return;
+            }
+
+            const auto result = this->m_admission != nullptr
+                                    ? this->m_admission->accept_connections(sock, sockets, this->m_budget)
+                                    : accept_connections(sock, sockets, this->m_budget);
+
+            if (result.error == std::errc::resource_unavailable_try_again) {
+                // Admission control has paused accepting
+                pause(sock, std::max<std::chrono::nanoseconds>(this->m_admission->retry_after(), min_pause));
+                continue;
+            }
+
+            const auto accepted = std::span(sockets).first(result.count);
+
+            std::error_code option_error;
+            if (this->m_socket_options.quick_ack != 0) {
+                for (const auto& conn : accepted) {
+                    std::error_code ec;
+                    set_accepted_socket_options(conn.sock, this->m_socket_options, ec);
+                    if (ec && !option_error) [[unlikely]] {
+                        option_error = ec;
+                    }
+                }
+            }
+
+            for (std::size_t i = 0; i < accepted.size(); ++i) {
+                try {
+                    this->m_on_accept(sock, accepted[i]);
+                }
+                catch (...) {
+                    // The sockets not yet handed over are still ours
+                    for (const auto& rest : accepted.subspan(i + 1)) {
+                        close(rest.sock);
+                    }
+
+                    if (this->m_admission != nullptr) {
+                        this->m_admission->release(accepted.size() - i - 1);
+                    }
+
+                    throw;
+                }
+            }
+
+            if ((result.error == std::errc::too_many_files_open ||
+                 result.error == std::errc::too_many_files_open_in_system) &&
+                this->m_reserve != nullptr) {
+                if (this->m_reserve->drain(sock, this->m_budget) == 0) {
+                    // Another thread is draining, or the spare descriptor could not be reopened after the last drain:
+                    // retry later rather than spin on the readable listener
+                    pause(sock, reserve_pause);
+                }
+            }
+            else if (result.error) {
+                if (!this->m_on_error) {
+                    throw std::system_error(result.error, "accept4() failed");
+                }
+
+                this->m_on_error(sock, result.error);
+            }
+
+            if (option_error) [[unlikely]] {
+                if (!this->m_on_error) {
+                    throw std::system_error(option_error, "setsockopt(TCP_QUICKACK) failed");
+                }
+
+                this->m_on_error(sock, option_error);
+            }
+        }
+    }
+}
+
+void epoll_acceptor::stop() noexcept
+{
+    this->m_stopped.store(true, std::memory_order_relaxed);
+
+    const std::uint64_t value = 1;
+    [[maybe_unused]] const auto res = write(this->m_event_fd, &value, sizeof(value));
+}
+
+int epoll_acceptor::event_fd() const noexcept
+{
+    return this->m_event_fd;
+}
+
+}  // namespace psb
@@ -0,0 +1,116 @@
+#ifndef A731F5C6_19CF_4AB1_B5E2_D53E89AE5835
+#define A731F5C6_19CF_4AB1_B5E2_D53E89AE5835
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <system_error>
+#include <vector>
+
+#include "export.h"
+#include "sockutils.h"
+
+namespace psb {
+
+class admission_controller;
+class fd_reserve;
+
+struct epoll_acceptor_options_t {
+    std::size_t accept_budget;                 // Connections accepted from one listener per wakeup at most; 0: default
+    admission_controller* admission{};         // Admission control; the accept callback must release() every connection
+    fd_reserve* reserve{};                     // Spare descriptor for dropping connections on EMFILE and ENFILE
+    const socket_options_t* socket_options{};  // Options of the listeners; the non-inherited ones are set per socket
+};
+
+/**
+ * @brief Accepts connections on one or more listening sockets from one or more threads.
+ *
+ * Every thread calling `run()` gets its own epoll instance with the listeners registered with `EPOLLEXCLUSIVE`,
+ * so a new connection wakes up one idle thread rather than all of them. The number of connections accepted from a
+ * listener per wakeup is limited by `accept_budget`; listeners that still have pending connections are reported
+ * by epoll again after the others, which keeps a busy listener from starving the rest.
+ *
+ * Accepted sockets are non-blocking and close-on-exec; they are handed over to the accept callback, which becomes
+ * responsible for closing them. The callbacks are invoked on the thread that accepted the connection.
+ *
+ * With an `admission_controller`, connections are accepted through it. When it pauses accepting, the thread stops
+ * watching the listener until `retry_after()` (at least a millisecond) has passed, leaving the connections in the
+ * kernel's accept queue for other threads or for later.
+ *
+ * With an `fd_reserve`, running out of descriptors is not an error: the pending connections (up to the budget) are
+ * dropped with `fd_reserve::drain()` and the loop goes on. If none could be dropped (another thread is draining, or
+ * the spare descriptor has not been reopened yet), the thread stops watching the listener for 10 ms.
+ *
+ * With `socket_options`, the options accepted sockets do not inherit from the listener (`quick_ack`) are set on
+ * every accepted socket before it is handed over, as `set_accepted_socket_options()` does. A socket on which they
+ * cannot be set is still handed over, and the error is reported like an accept error.
+ *
+ * The acceptor does not own the listening sockets; they must outlive it.
+ */
+class PSB_SOCKUTILS_EXPORT epoll_acceptor {
+public:
+    using accept_callback_t = std::function<void(int listener, const accepted_socket_t& sock)>;
+    using error_callback_t  = std::function<void(int listener, const std::error_code& ec)>;
+
+    /**
+     * @brief Creates the acceptor.
+     *
+     * @param listeners Listening sockets.
+     * @param opts Acceptor options.
+     * @param on_accept Callback invoked for every accepted connection.
+     * @param on_error Callback invoked when accepting from a listener fails (e.g., with `EMFILE` if there is no
+     * `reserve`). If empty, `run()` throws `std::system_error` instead.
+     * @throw std::system_error Failed to create the eventfd.
+     */
+    epoll_acceptor(
+        std::span<const int> listeners, const epoll_acceptor_options_t& opts, accept_callback_t on_accept,
+        error_callback_t on_error = {}
+    );
+    ~epoll_acceptor() noexcept;
+
+    epoll_acceptor(const epoll_acceptor&)            = delete;
+    epoll_acceptor(epoll_acceptor&&)                 = delete;
+    epoll_acceptor& operator=(const epoll_acceptor&) = delete;
+    epoll_acceptor& operator=(epoll_acceptor&&)      = delete;
+
+    /**
+     * @brief Runs the accept loop on the calling thread until `stop()` is called.
+     *
+     * May be called from several threads at once. Exceptions thrown by the callbacks propagate out of `run()`.
+     *
+     * @throw std::system_error Call to a system API failed.
+     */
+    void run();
+
+    /**
+     * @brief Makes all current and future `run()` calls return.
+     *
+     * A `run()` call returns once it has handed over the connections it has already accepted, without accepting
+     * any more.
+     *
+     * To change the set of listeners, stop the acceptor, wait for the `run()` calls to return and create a new one.
+     * The function is async-signal-safe.
+     */
+    void stop() noexcept;
+
+    /**
+     * @brief Gets the eventfd used to stop the acceptor; writing to it has the same effect as `stop()`.
+     */
+    [[nodiscard]] int event_fd() const noexcept;
+
+private:
+    std::vector<int> m_listeners;
+    std::size_t m_budget;
+    admission_controller* m_admission;
+    fd_reserve* m_reserve;
+    socket_options_t m_socket_options;
+    accept_callback_t m_on_accept;
+    error_callback_t m_on_error;
+    int m_event_fd;
+    std::atomic<bool> m_stopped{false};
+};
+
+}  // namespace psb
+
+#endif /* A731F5C6_19CF_4AB1_B5E2_D53E89AE5835 */
@@ -0,0 +1,136 @@
+#include "fd_reserve.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+int open_spare() noexcept
+{
+    return open("/dev/null", O_RDONLY | O_CLOEXEC);  // NOLINT(cppcoreguidelines-pro-type-vararg)
+}
+
+}  // namespace
+
+namespace psb {
+
+fd_reserve::fd_reserve() : m_fd(open_spare())
+{
+    if (this->m_fd.load(std::memory_order_relaxed) == -1) [[unlikely]] {
+        throw std::system_error(errno, std::generic_category(), "open(/dev/null) failed");
+    }
+}
+
+fd_reserve::~fd_reserve() noexcept
+{
+    if (const auto fd = this->m_fd.load(std::memory_order_relaxed); fd != -1) {
+        close(fd);
+    }
+}
+
+bool fd_reserve::rearm() noexcept
+{
+    const auto fd = open_spare();
+    if (fd == -1) {
+        return false;
+    }
+
+    if (int expected = -1; !this->m_fd.compare_exchange_strong(expected, fd, std::memory_order_acq_rel)) {
+        close(fd);
+    }
+
+    return true;
+}
+
+std::size_t fd_reserve::drain(int fd, std::size_t limit) noexcept
+{
+    if (const auto spare = this->m_fd.exchange(-1, std::memory_order_acq_rel); spare != -1) {
+        close(spare);
+    }
+    else if (!this->m_rearm_pending.exchange(false, std::memory_order_acq_rel)) {
+        // Another thread is draining; it takes the spare descriptor back when done
+        return 0;
+    }
+
+    // Without the spare descriptor (it could not be reopened after the last drain), accept4() gets whatever
+    // descriptors have been freed since then
+
+    std::size_t dropped = 0;
+    while (dropped < limit) {
+        const auto sock = accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (sock == -1) {
+            if (errno == EINTR || errno == ECONNABORTED || errno == EPROTO) {
+                continue;
+            }
+
+            // EAGAIN: the queue is drained; EMFILE: another thread has taken the spare descriptor
+            break;
+        }
+
+        // With a zero linger time, close() sends a reset and frees the socket at once
+        const linger lng{.l_onoff = 1, .l_linger = 0};
+        setsockopt(sock, SOL_SOCKET, SO_LINGER, &lng, sizeof(lng));
+        close(sock);
+        ++dropped;
+    }
+
+    if (!this->rearm()) [[unlikely]] {
+        this->m_rearm_pending.store(true, std::memory_order_release);
+    }
+
+    this->m_dropped.fetch_add(dropped, std::memory_order_relaxed);
+    return dropped;
+}
+
+bool fd_reserve::armed() const noexcept
+{
+    return this->m_fd.load(std::memory_order_relaxed) != -1;
+}
+
+std::uint64_t fd_reserve::dropped() const noexcept
+{
+    return this->m_dropped.load(std::memory_order_relaxed);
+}
+
+std::uint64_t raise_fd_limit(std::error_code& ec) noexcept
+{
+    ec.clear();
+
+    rlimit lim{};
+    if (getrlimit(RLIMIT_NOFILE, &lim) == -1) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
+        return 0;
+    }
+
+    if (lim.rlim_cur != lim.rlim_max) {
+        const auto old = lim.rlim_cur;
+        lim.rlim_cur   = lim.rlim_max;
+        if (setrlimit(RLIMIT_NOFILE, &lim) == -1) [[unlikely]] {
+            ec.assign(errno, std::generic_category());
+            return old;
+        }
+    }
+
+    return lim.rlim_cur;
+}
+
+std::uint64_t raise_fd_limit()
+{
+    std::error_code ec;
+    const auto result = raise_fd_limit(ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, "raise_fd_limit() failed");
+    }
+
+    return result;
+}
+
+}  // namespace psb
@@ -0,0 +1,91 @@
+#ifndef CCEA7F81_212B_469D_AC1A_8E99FDF073C4
+#define CCEA7F81_212B_469D_AC1A_8E99FDF073C4
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+
+#include "export.h"
+
+namespace psb {
+
+/**
+ * @brief Keeps a spare file descriptor for shedding connections when the process runs out of descriptors.
+ *
+ * When `accept4()` fails with `EMFILE` or `ENFILE`, the connection stays in the accept queue and the listener stays
+ * readable, so an event loop would spin. `drain()` gives up the spare descriptor, accepts the pending connections
+ * one at a time and closes each of them at once with a reset, and then takes the spare descriptor back. The
+ * clients get a reset instead of hanging until the process has descriptors to spare.
+ *
+ * The reserve may be shared by several threads; if they run out of descriptors at the same time, one of them
+ * drains the listener while the others return at once.
+ */
+class PSB_SOCKUTILS_EXPORT fd_reserve {
+public:
+    /**
+     * @brief Opens the spare descriptor (`/dev/null`).
+     *
+     * @throw std::system_error Call to `open()` failed.
+     */
+    fd_reserve();
+    ~fd_reserve() noexcept;
+
+    fd_reserve(const fd_reserve&)            = delete;
+    fd_reserve(fd_reserve&&)                 = delete;
+    fd_reserve& operator=(const fd_reserve&) = delete;
+    fd_reserve& operator=(fd_reserve&&)      = delete;
+
+    /**
+     * @brief Accepts and resets up to @a limit pending connections on @a fd using the spare descriptor.
+     *
+     * Call this when accepting from @a fd has failed with `EMFILE` or `ENFILE`. If the spare descriptor cannot be
+     * reopened afterwards (the descriptors freed in the meantime have been taken again), the next call drains
+     * without it and retries. While another thread is draining, the call returns 0 at once.
+     *
+     * @param fd Listening socket.
+     * @param limit Maximum number of connections to drop.
+     * @return Number of connections dropped.
+     */
+    std::size_t drain(int fd, std::size_t limit = SIZE_MAX) noexcept;
+
+    /**
+     * @brief Tells whether the spare descriptor is held.
+     */
+    [[nodiscard]] bool armed() const noexcept;
+
+    /**
+     * @brief Gets the number of connections dropped by `drain()` so far.
+     */
+    [[nodiscard]] std::uint64_t dropped() const noexcept;
+
+private:
+    bool rearm() noexcept;
+
+    std::atomic<int> m_fd;
+    std::atomic<bool> m_rearm_pending{false};  // The last drain could not reopen the spare descriptor
+    std::atomic<std::uint64_t> m_dropped{0};
+};
+
+/**
+ * @brief Raises the soft `RLIMIT_NOFILE` limit of the process to the hard limit.
+ *
+ * Many distributions set the soft limit to 1024 for compatibility with `select()`, which is far too low for
+ * a server; the hard limit is usually much higher. Call this at startup, before creating threads.
+ *
+ * @return The new soft limit.
+ * @throw std::system_error Call to `getrlimit()` or `setrlimit()` failed.
+ */
+PSB_SOCKUTILS_EXPORT std::uint64_t raise_fd_limit();
+
+/**
+ * @brief Raises the soft `RLIMIT_NOFILE` limit of the process to the hard limit; non-throwing variant.
+ *
+ * @param ec Set to the error if the call failed, cleared otherwise.
+ * @return The new soft limit, or the old one on failure.
+ */
+PSB_SOCKUTILS_EXPORT std::uint64_t raise_fd_limit(std::error_code& ec) noexcept;
+
+}  // namespace psb
+
+#endif /* CCEA7F81_212B_469D_AC1A_8E99FDF073C4 */
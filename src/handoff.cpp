@@ -0,0 +1,412 @@
+#include "handoff.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <opentelemetry/semconv/incubating/network_attributes.h>
+
+#include "metrics_internal.h"
+
+namespace {
+
+using namespace opentelemetry::semconv::network::NetworkTransportValues;
+using namespace opentelemetry::semconv::network::NetworkTypeValues;
+
+constexpr int listen_fds_start = 3;  // SD_LISTEN_FDS_START
+
+// Known values of `listening_socket_t::transport` and `type`; the received names are mapped back to these pointers
+constexpr std::array transports = {kTcp, kUdp, kUnix};
+constexpr std::array types      = {kIpv4, kIpv6};
+
+// One line per socket in the handoff message: "<transport> <type>\n", "-" for no type
+constexpr std::size_t max_line_length = 16;
+
+template<std::size_t N>
+const char* find_name(const std::array<const char*, N>& names, std::string_view name) noexcept
+{
+    const auto* it = std::ranges::find(names, name, [](const char* value) { return std::string_view(value); });
+    return it != names.end() ? *it : nullptr;
+}
+
+void close_all(std::span<const psb::listening_socket_t> sockets) noexcept
+{
+    for (const auto& s : sockets) {
+        close(s.sock);
+    }
+}
+
+/**
+ * Parses the handoff message @a payload into the metadata of @a sockets, whose descriptors are already set.
+ */
+bool parse_payload(std::string_view payload, std::span<psb::listening_socket_t> sockets) noexcept
+{
+    for (auto& s : sockets) {
+        const auto eol   = payload.find('\n');
+        const auto space = payload.find(' ');
+        if (eol == std::string_view::npos || space >= eol) {
+            return false;
+        }
+
+        const auto type = payload.substr(space + 1, eol - space - 1);
+        s.transport     = find_name(transports, payload.substr(0, space));
+        s.type          = type == "-" ? nullptr : find_name(types, type);
+        if (s.transport == nullptr || (s.type == nullptr && type != "-")) {
+            return false;
+        }
+
+        payload.remove_prefix(eol + 1);
+    }
+
+    return payload.empty();
+}
+
+/**
+ * Describes the inherited socket @a fd by its domain and type.
+ */
+psb::listening_socket_t describe_socket(int fd, std::error_code& ec) noexcept
+{
+    int domain{};
+    int type{};
+    socklen_t len = sizeof(domain);
+    if (getsockopt(fd, SOL_SOCKET, SO_DOMAIN, &domain, &len) == -1) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
+        return {.sock = -1};
+    }
+
+    len = sizeof(type);
+    if (getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &len) == -1) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
+        return {.sock = -1};
+    }
+
+    if (domain == AF_UNIX) {
+        return {.sock = fd, .transport = kUnix, .type = nullptr};
+    }
+
+    if (domain != AF_INET && domain != AF_INET6) [[unlikely]] {
+        ec = std::make_error_code(std::errc::address_family_not_supported);
+        return {.sock = -1};
+    }
+
+    return {.sock = fd, .transport = type == SOCK_DGRAM ? kUdp : kTcp, .type = domain == AF_INET6 ? kIpv6 : kIpv4};
+}
+
+/**
+ * Parses the decimal environment variable @a name; returns -1 if it is not set, -2 if it is malformed.
+ */
+long get_env_number(const char* name) noexcept
+{
+    const char* value = std::getenv(name);  // NOLINT(concurrency-mt-unsafe)
+    if (value == nullptr) {
+        return -1;
+    }
+
+    const std::string_view str(value);
+    long result{};
+    const auto [ptr, err] = std::from_chars(str.data(), str.data() + str.size(), result);
+    return err == std::errc{} && ptr == str.data() + str.size() && result >= 0 ? result : -2;
+}
+
+/**
+ * Removes the TCP or UNIX listener bound to @a ss from @a inherited and returns it; `sock` is -1 if there is none.
+ * A zero port in @a ss matches any port.
+ */
+psb::listening_socket_t
+take_inherited(std::vector<psb::listening_socket_t>& inherited, const sockaddr_storage& ss, socklen_t len)
+{
+    const auto wanted = psb::get_socket_info(ss, len);
+    for (auto it = inherited.begin(); it != inherited.end(); ++it) {
+        if (it->transport == nullptr || std::string_view(it->transport) == kUdp) {
+            continue;
+        }
+
+        sockaddr_storage bound{};
+        socklen_t bound_len = sizeof(bound);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (getsockname(it->sock, reinterpret_cast<sockaddr*>(&bound), &bound_len) == -1 ||
+            bound.ss_family != ss.ss_family) {
+            continue;
+        }
+
+        const auto info = psb::get_socket_info(bound, bound_len);
+        if (info.address == wanted.address && (wanted.port == 0 || info.port == wanted.port)) {
+            const auto result = *it;
+            inherited.erase(it);
+            return result;
+        }
+    }
+
+    return {.sock = -1};
+}
+
+}  // namespace
+
+namespace psb {
+
+void send_listeners(int sock, std::span<const listening_socket_t> listeners, std::error_code& ec) noexcept
+{
+    ec.clear();
+
+    if (listeners.empty() || listeners.size() > max_handoff_sockets) [[unlikely]] {
+        ec = std::make_error_code(
+            listeners.empty() ? std::errc::invalid_argument : std::errc::argument_list_too_long
+        );
+        return;
+    }
+
+    std::array<char, max_handoff_sockets * max_line_length> payload{};
+    std::size_t payload_len = 0;
+    for (const auto& s : listeners) {
+        const auto* type = s.type != nullptr ? s.type : "-";
+        if (s.transport == nullptr || find_name(transports, s.transport) == nullptr ||
+            (s.type != nullptr && find_name(types, s.type) == nullptr)) [[unlikely]] {
+            ec = std::make_error_code(std::errc::invalid_argument);
+            return;
+        }
+
+        const auto res = std::format_to_n(
+            std::next(payload.begin(), static_cast<std::ptrdiff_t>(payload_len)), max_line_length, "{} {}\n",
+            s.transport, type
+        );
+        payload_len += static_cast<std::size_t>(res.size);
+    }
+
+    alignas(cmsghdr) std::array<char, CMSG_SPACE(max_handoff_sockets * sizeof(int))> control{};
+    const auto fds_len = listeners.size() * sizeof(int);
+
+    iovec iov{.iov_base = payload.data(), .iov_len = payload_len};
+    msghdr msg{};
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control.data();
+    msg.msg_controllen = CMSG_SPACE(fds_len);
+
+    auto* cmsg       = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type  = SCM_RIGHTS;
+    cmsg->cmsg_len   = CMSG_LEN(fds_len);
+
+    auto* fds = CMSG_DATA(cmsg);
+    for (const auto& s : listeners) {
+        std::memcpy(fds, &s.sock, sizeof(int));
+        fds += sizeof(int);  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+    ssize_t res{};
+    do {
+        res = sendmsg(sock, &msg, MSG_NOSIGNAL);
+    } while (res == -1 && errno == EINTR);
+
+    if (res == -1) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
+    }
+    else if (static_cast<std::size_t>(res) != payload_len) [[unlikely]] {
+        // Only possible with a full non-blocking stream socket; the receiver would reject the partial message
+        ec = std::make_error_code(std::errc::resource_unavailable_try_again);
+    }
+}
+
+void send_listeners(int sock, std::span<const listening_socket_t> listeners)
+{
+    std::error_code ec;
+    send_listeners(sock, listeners, ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, "send_listeners() failed");
+    }
+}
+
+std::vector<listening_socket_t> receive_listeners(int sock, std::error_code& ec)
+{
+    ec.clear();
+
+    std::array<char, max_handoff_sockets * max_line_length> payload{};
+    alignas(cmsghdr) std::array<char, CMSG_SPACE(max_handoff_sockets * sizeof(int))> control{};
+
+    iovec iov{.iov_base = payload.data(), .iov_len = payload.size()};
+    msghdr msg{};
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control.data();
+    msg.msg_controllen = control.size();
+
+    ssize_t res{};
+    do {
+        res = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+    } while (res == -1 && errno == EINTR);
+
+    if (res == -1) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
+        return {};
+    }
+
+    std::vector<listening_socket_t> sockets;
+    for (auto* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            const auto count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            const auto* data = CMSG_DATA(cmsg);
+            for (std::size_t i = 0; i < count; ++i) {
+                int fd{};
+                std::memcpy(&fd, data + i * sizeof(int), sizeof(int));  // NOLINT(*-pro-bounds-pointer-arithmetic)
+                sockets.push_back({.sock = fd});
+            }
+        }
+    }
+
+    if ((msg.msg_flags & (MSG_CTRUNC | MSG_TRUNC)) != 0) [[unlikely]] {
+        ec = std::make_error_code(std::errc::message_size);
+    }
+    else if (sockets.empty() || !parse_payload({payload.data(), static_cast<std::size_t>(res)}, sockets))
+        [[unlikely]] {
+        ec = std::make_error_code(std::errc::protocol_error);
+    }
+
+    if (ec) [[unlikely]] {
+        close_all(sockets);
+        return {};
+    }
+
+    if (psb::detail::metrics_enabled.load(std::memory_order_relaxed)) [[unlikely]] {
+        for (const auto& s : sockets) {
+            psb::detail::record_listener(s.transport, s.type);
+        }
+    }
+
+    return sockets;
+}
+
+std::vector<listening_socket_t> receive_listeners(int sock)
+{
+    std::error_code ec;
+    auto result = receive_listeners(sock, ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, "receive_listeners() failed");
+    }
+
+    return result;
+}
+
+std::vector<listening_socket_t> inherited_listeners(std::error_code& ec)
+{
+    ec.clear();
+
+    const auto pid   = get_env_number("LISTEN_PID");
+    const auto count = get_env_number("LISTEN_FDS");
+    if (pid == -1 || count == -1 || pid != getpid()) {
+        // Not for us: either there are no sockets, or the variables were inherited from our parent
+        return {};
+    }
+
+    // NOLINTBEGIN(concurrency-mt-unsafe)
+    unsetenv("LISTEN_PID");
+    unsetenv("LISTEN_FDS");
+    unsetenv("LISTEN_FDNAMES");
+    // NOLINTEND(concurrency-mt-unsafe)
+
+    if (count < 0 || count > INT32_MAX - listen_fds_start) [[unlikely]] {
+        ec = std::make_error_code(std::errc::invalid_argument);
+        return {};
+    }
+
+    std::vector<listening_socket_t> sockets;
+    sockets.reserve(static_cast<std::size_t>(count));
+    for (int fd = listen_fds_start; fd < listen_fds_start + static_cast<int>(count); ++fd) {
+        const auto s = describe_socket(fd, ec);
+        if (!ec) {
+            make_close_on_exec(fd, ec);
+        }
+
+        if (!ec) {
+            make_nonblocking(fd, ec);
+        }
+
+        if (ec) [[unlikely]] {
+            // The variables are gone, so nobody could find any of the passed descriptors again
+            for (int passed = listen_fds_start; passed < listen_fds_start + static_cast<int>(count); ++passed) {
+                close(passed);
+            }
+
+            return {};
+        }
+
+        sockets.push_back(s);
+    }
+
+    if (psb::detail::metrics_enabled.load(std::memory_order_relaxed)) [[unlikely]] {
+        for (const auto& s : sockets) {
+            psb::detail::record_listener(s.transport, s.type);
+        }
+    }
+
+    return sockets;
+}
+
+std::vector<listening_socket_t> inherited_listeners()
+{
+    std::error_code ec;
+    auto result = inherited_listeners(ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, "inherited_listeners() failed");
+    }
+
+    return result;
+}
+
+listening_socket_t adopt_listening_socket(
+    std::vector<listening_socket_t>& inherited, std::string_view address, std::uint16_t port,
+    const socket_options_t& opts, std::error_code& ec
+)
+{
+    ec.clear();
+
+    sockaddr_storage ss{};
+    socklen_t len{};
+    if (const auto res = make_socket_address(address, port, ss, len); res != std::errc{}) [[unlikely]] {
+        ec = std::make_error_code(res);
+        return {.sock = -1};
+    }
+
+    if (const auto result = take_inherited(inherited, ss, len); result.sock != -1) {
+        return result;
+    }
+
+    return create_listening_socket(ss, len, opts, ec);
+}
+
+listening_socket_t adopt_listening_socket(
+    std::vector<listening_socket_t>& inherited, std::string_view address, std::uint16_t port,
+    const socket_options_t& opts
+)
+{
+    sockaddr_storage ss{};
+    socklen_t len{};
+    if (const auto res = make_socket_address(address, port, ss, len); res != std::errc{}) [[unlikely]] {
+        throw std::invalid_argument(std::format("Invalid address: {}", address));
+    }
+
+    if (const auto result = take_inherited(inherited, ss, len); result.sock != -1) {
+        return result;
+    }
+
+    return create_listening_socket(ss, len, opts);
+}
+
+}  // namespace psb
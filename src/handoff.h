@@ -0,0 +1,129 @@
+#ifndef EB625FEC_31B4_40D5_A0F2_021385D1D9B7
+#define EB625FEC_31B4_40D5_A0F2_021385D1D9B7
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "export.h"
+#include "sockutils.h"
+
+namespace psb {
+
+/// Maximum number of sockets `send_listeners()` passes in one message (the kernel's `SCM_MAX_FD`).
+inline constexpr std::size_t max_handoff_sockets = 253;
+
+/**
+ * @brief Passes the listening sockets @a listeners to another process over the connected UNIX socket @a sock.
+ *
+ * This is the sending half of a zero-downtime restart: the old process hands its listeners to the new one, which
+ * gets them with `receive_listeners()` and starts accepting at once, while the old process stops accepting,
+ * closes its copies and drains its connections. Connections waiting in the accept queues are not lost, because
+ * the sockets are never closed. The descriptors travel as `SCM_RIGHTS`, along with `transport` and `type`.
+ *
+ * @param sock Connected `AF_UNIX` stream or seqpacket socket.
+ * @param listeners Sockets to pass; at most `max_handoff_sockets`.
+ * @throw std::system_error Call to `sendmsg()` failed.
+ */
+PSB_SOCKUTILS_EXPORT void send_listeners(int sock, std::span<const listening_socket_t> listeners);
+
+/**
+ * @brief Passes the listening sockets @a listeners to another process; non-throwing variant.
+ *
+ * @param sock Connected `AF_UNIX` stream or seqpacket socket.
+ * @param listeners Sockets to pass.
+ * @param ec Set to the error if the call failed (`std::errc::argument_list_too_long` for more than
+ * `max_handoff_sockets` sockets), cleared otherwise.
+ */
+PSB_SOCKUTILS_EXPORT void
+send_listeners(int sock, std::span<const listening_socket_t> listeners, std::error_code& ec) noexcept;
+
+/**
+ * @brief Receives the listening sockets sent by `send_listeners()` over the connected UNIX socket @a sock.
+ *
+ * The descriptors are close-on-exec. They keep the file status flags of the sender's sockets, i.e., sockets from
+ * `create_listening_socket()` remain non-blocking.
+ *
+ * @param sock Connected `AF_UNIX` stream or seqpacket socket.
+ * @return The sockets, in the order they were sent; the caller owns them.
+ * @throw std::system_error Call to `recvmsg()` failed, or the message is not a listener handoff.
+ */
+PSB_SOCKUTILS_EXPORT std::vector<listening_socket_t> receive_listeners(int sock);
+
+/**
+ * @brief Receives the listening sockets sent by `send_listeners()`; non-throwing variant.
+ *
+ * @param sock Connected `AF_UNIX` stream or seqpacket socket.
+ * @param ec Set to the error if the call failed (`std::errc::protocol_error` if the message is not a listener
+ * handoff, `std::errc::message_size` if it carried too many descriptors), cleared otherwise.
+ * @return The sockets; empty on failure, in which case any descriptors received have been closed.
+ */
+PSB_SOCKUTILS_EXPORT std::vector<listening_socket_t> receive_listeners(int sock, std::error_code& ec);
+
+/**
+ * @brief Takes the sockets passed by the service manager with the `LISTEN_FDS` protocol (socket activation).
+ *
+ * If `LISTEN_PID` is the PID of this process, the `LISTEN_FDS` descriptors starting from 3 are made non-blocking and
+ * close-on-exec, and described by their domain and type. `LISTEN_PID`, `LISTEN_FDS` and `LISTEN_FDNAMES` are then
+ * removed from the environment so that child processes do not take the sockets for theirs; like any change to
+ * the environment, this must not race with other threads.
+ *
+ * @return The sockets, in descriptor order; empty if no sockets were passed to this process.
+ * @throw std::system_error A descriptor is not a socket, or a call to a system API failed; the `LISTEN_FDS`
+ * descriptors have been closed, unless the variables were malformed.
+ */
+PSB_SOCKUTILS_EXPORT std::vector<listening_socket_t> inherited_listeners();
+
+/**
+ * @brief Takes the sockets passed with the `LISTEN_FDS` protocol; non-throwing variant.
+ *
+ * @param ec Set to the error if the call failed (`std::errc::invalid_argument` for malformed variables,
+ * `std::errc::not_a_socket` if a descriptor is not a socket), cleared otherwise.
+ * @return The sockets; empty on failure, in which case the `LISTEN_FDS` descriptors have been closed (unless the
+ * variables were malformed).
+ */
+PSB_SOCKUTILS_EXPORT std::vector<listening_socket_t> inherited_listeners(std::error_code& ec);
+
+/**
+ * @brief Takes the stream listener bound to @a address and @a port from @a inherited, or creates a new one.
+ *
+ * The address of every TCP or UNIX listener in @a inherited is read with `getsockname()`; the first one with the
+ * same family, address and port (any port if @a port is zero) is removed from @a inherited and returned as is, with
+ * the options it was created with. If there is none, the socket is created with `create_listening_socket()`.
+ *
+ * @param inherited Sockets from `inherited_listeners()` or `receive_listeners()`.
+ * @param address IP address or UNIX socket path.
+ * @param port Port number.
+ * @param opts Socket options for a new socket.
+ * @return The listening socket.
+ * @throw std::system_error Call to a system API failed.
+ * @throw std::invalid_argument The address is not valid.
+ */
+PSB_SOCKUTILS_EXPORT listening_socket_t adopt_listening_socket(
+    std::vector<listening_socket_t>& inherited, std::string_view address, std::uint16_t port,
+    const socket_options_t& opts
+);
+
+/**
+ * @brief Takes the stream listener bound to @a address and @a port from @a inherited, or creates a new one;
+ * non-throwing variant.
+ *
+ * @param inherited Sockets from `inherited_listeners()` or `receive_listeners()`.
+ * @param address IP address or UNIX socket path.
+ * @param port Port number.
+ * @param opts Socket options for a new socket.
+ * @param ec Set to the error if the call failed (`std::errc::invalid_argument` for an invalid address),
+ * cleared otherwise.
+ * @return The listening socket; `sock` is -1 on failure.
+ */
+PSB_SOCKUTILS_EXPORT listening_socket_t adopt_listening_socket(
+    std::vector<listening_socket_t>& inherited, std::string_view address, std::uint16_t port,
+    const socket_options_t& opts, std::error_code& ec
+);
+
+}  // namespace psb
+
+#endif /* EB625FEC_31B4_40D5_A0F2_021385D1D9B7 */
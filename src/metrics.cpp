@@ -0,0 +1,377 @@
+#include "metrics.h"
+#include "metrics_internal.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <opentelemetry/common/attribute_value.h>
+#include <opentelemetry/context/context.h>
+#include <opentelemetry/metrics/noop.h>
+#include <opentelemetry/metrics/provider.h>
+#include <opentelemetry/semconv/error_attributes.h>
+#include <opentelemetry/semconv/incubating/network_attributes.h>
+
+namespace {
+
+namespace otel_metrics = opentelemetry::metrics;
+namespace nostd        = opentelemetry::nostd;
+
+enum error_kind : std::size_t { econnaborted, emfile, enfile, eagain, other_error, error_kind_count };
+
+constexpr std::array<const char*, error_kind_count> error_names{
+    "ECONNABORTED", "EMFILE", "ENFILE", "EAGAIN", opentelemetry::semconv::error::ErrorTypeValues::kOther
+};
+
+constexpr std::size_t duration_batch = 64;
+
+error_kind classify(int err) noexcept
+{
+    switch (err) {
+        case ECONNABORTED:
+            return econnaborted;
+        case EMFILE:
+            return emfile;
+        case ENFILE:
+            return enfile;
+#if EAGAIN != EWOULDBLOCK
+        case EWOULDBLOCK:
+#endif
+        case EAGAIN:
+            return eagain;
+        default:
+            return other_error;
+    }
+}
+
+/**
+ * Counter written only by the thread which owns it, so that incrementing it is a plain load and store rather than
+ * a locked read-modify-write; other threads only read it.
+ */
+class local_counter {
+public:
+    void increment() noexcept
+    {
+        this->m_value.store(this->m_value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::uint64_t get() const noexcept { return this->m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> m_value{0};
+};
+
+struct totals_t {
+    std::uint64_t accepted{};
+    std::uint64_t closed{};
+    std::array<std::uint64_t, error_kind_count> errors{};
+};
+
+struct thread_metrics;
+
+class registry {
+public:
+    static registry& instance()
+    {
+        static registry self;
+        return self;
+    }
+
+    void add(thread_metrics* metrics) noexcept;
+    void remove(thread_metrics* metrics) noexcept;
+    totals_t totals();
+
+    std::shared_ptr<otel_metrics::Histogram<double>> histogram()
+    {
+        const std::lock_guard lock(this->mutex);
+        return this->duration;
+    }
+
+    std::mutex mutex;
+    std::vector<thread_metrics*> threads;
+    totals_t retired;  // Counts of the threads which have exited
+    std::map<std::pair<std::string, std::string>, std::uint64_t> listeners;
+
+    nostd::shared_ptr<otel_metrics::Meter> meter;
+    nostd::shared_ptr<otel_metrics::ObservableInstrument> connections;
+    nostd::shared_ptr<otel_metrics::ObservableInstrument> errors;
+    nostd::shared_ptr<otel_metrics::ObservableInstrument> open_connections;
+    nostd::shared_ptr<otel_metrics::ObservableInstrument> listeners_created;
+    std::shared_ptr<otel_metrics::Histogram<double>> duration;
+};
+
+struct thread_metrics {
+    local_counter accepted;
+    local_counter closed;
+    std::array<local_counter, error_kind_count> errors{};
+    std::array<double, duration_batch> durations{};
+    std::size_t pending = 0;
+
+    thread_metrics() noexcept { registry::instance().add(this); }
+
+    thread_metrics(const thread_metrics&)            = delete;
+    thread_metrics(thread_metrics&&)                 = delete;
+    thread_metrics& operator=(const thread_metrics&) = delete;
+    thread_metrics& operator=(thread_metrics&&)      = delete;
+
+    ~thread_metrics() noexcept
+    {
+        this->flush();
+        registry::instance().remove(this);
+    }
+
+    void add_duration(double seconds) noexcept
+    {
+        this->durations.at(this->pending) = seconds;
+        if (++this->pending == this->durations.size()) {
+            this->flush();
+        }
+    }
+
+    void flush() noexcept
+    {
+        // Recorded without holding the registry lock, which the collection callbacks take
+        if (const auto histogram = registry::instance().histogram(); histogram) {
+            for (const auto value : std::span(this->durations).first(this->pending)) {
+                histogram->Record(value, opentelemetry::context::Context{});
+            }
+        }
+
+        this->pending = 0;
+    }
+
+    void add_to(totals_t& totals) const noexcept
+    {
+        totals.accepted += this->accepted.get();
+        totals.closed += this->closed.get();
+        for (std::size_t i = 0; i < error_kind_count; ++i) {
+            totals.errors.at(i) += this->errors.at(i).get();
+        }
+    }
+};
+
+void registry::add(thread_metrics* metrics) noexcept
+{
+    const std::lock_guard lock(this->mutex);
+    try {
+        this->threads.push_back(metrics);
+    }
+    catch (const std::bad_alloc&) {  // NOLINT(bugprone-empty-catch)
+        // The thread's counts are lost
+    }
+}
+
+void registry::remove(thread_metrics* metrics) noexcept
+{
+    const std::lock_guard lock(this->mutex);
+    if (const auto it = std::ranges::find(this->threads, metrics); it != this->threads.end()) {
+        metrics->add_to(this->retired);
+        this->threads.erase(it);
+    }
+}
+
+totals_t registry::totals()
+{
+    const std::lock_guard lock(this->mutex);
+    auto result = this->retired;
+    for (const auto* metrics : this->threads) {
+        metrics->add_to(result);
+    }
+
+    return result;
+}
+
+thread_metrics& local_metrics() noexcept
+{
+    thread_local thread_metrics metrics;
+    return metrics;
+}
+
+using attributes_t = std::initializer_list<std::pair<nostd::string_view, opentelemetry::common::AttributeValue>>;
+
+/**
+ * Reports @a value to an asynchronous instrument with integer measurements.
+ */
+void observe(otel_metrics::ObserverResult& result, std::uint64_t value, attributes_t attributes = {})
+{
+    using observer_t = nostd::shared_ptr<otel_metrics::ObserverResultT<std::int64_t>>;
+    if (auto* observer = nostd::get_if<observer_t>(&result); observer != nullptr) {
+        (*observer)->Observe(static_cast<std::int64_t>(value), attributes);
+    }
+}
+
+void observe_connections(otel_metrics::ObserverResult result, void* /*state*/)
+{
+    observe(result, registry::instance().totals().accepted);
+}
+
+void observe_errors(otel_metrics::ObserverResult result, void* /*state*/)
+{
+    const auto totals = registry::instance().totals();
+    for (std::size_t i = 0; i < error_kind_count; ++i) {
+        observe(result, totals.errors.at(i), {{opentelemetry::semconv::error::kErrorType, error_names.at(i)}});
+    }
+}
+
+void observe_open_connections(otel_metrics::ObserverResult result, void* /*state*/)
+{
+    const auto totals = registry::instance().totals();
+    observe(result, totals.accepted - std::min(totals.closed, totals.accepted));
+}
+
+void observe_listeners(otel_metrics::ObserverResult result, void* /*state*/)
+{
+    using namespace opentelemetry::semconv::network;
+
+    auto& reg = registry::instance();
+    const std::lock_guard lock(reg.mutex);
+    for (const auto& [key, count] : reg.listeners) {
+        if (key.second.empty()) {
+            observe(result, count, {{kNetworkTransport, key.first.c_str()}});
+        }
+        else {
+            observe(result, count, {{kNetworkTransport, key.first.c_str()}, {kNetworkType, key.second.c_str()}});
+        }
+    }
+}
+
+}  // namespace
+
+namespace psb {
+
+namespace detail {
+
+void record_accept(int err, std::chrono::steady_clock::duration elapsed) noexcept
+{
+    const auto saved_errno = errno;
+
+    auto& metrics = local_metrics();
+    if (err == 0) {
+        metrics.accepted.increment();
+    }
+    else {
+        metrics.errors.at(classify(err)).increment();
+    }
+
+    metrics.add_duration(std::chrono::duration<double>(elapsed).count());
+    errno = saved_errno;
+}
+
+void record_listener(const char* transport, const char* type) noexcept
+{
+    auto& reg = registry::instance();
+    const std::lock_guard lock(reg.mutex);
+    try {
+        ++reg.listeners[{transport, type != nullptr ? type : ""}];
+    }
+    catch (const std::bad_alloc&) {  // NOLINT(bugprone-empty-catch)
+    }
+}
+
+}  // namespace detail
+
+bool enable_metrics(std::string_view meter_name)
+{
+    const auto provider = otel_metrics::Provider::GetMeterProvider();
+    if (!provider || dynamic_cast<otel_metrics::NoopMeterProvider*>(provider.get()) != nullptr) {
+        return false;
+    }
+
+    auto& reg = registry::instance();
+    const std::lock_guard lock(reg.mutex);
+    if (!reg.meter) {
+        reg.meter = provider->GetMeter(nostd::string_view(meter_name.data(), meter_name.size()));
+
+        reg.connections = reg.meter->CreateInt64ObservableCounter(
+            "psb.sockutils.accept.connections", "Number of accepted connections", "{connection}"
+        );
+        reg.errors = reg.meter->CreateInt64ObservableCounter(
+            "psb.sockutils.accept.errors", "Number of failed accept() calls", "{error}"
+        );
+        reg.open_connections = reg.meter->CreateInt64ObservableUpDownCounter(
+            "psb.sockutils.open_connections", "Number of accepted connections not yet closed", "{connection}"
+        );
+        reg.listeners_created = reg.meter->CreateInt64ObservableCounter(
+            "psb.sockutils.listeners", "Number of listening sockets created", "{socket}"
+        );
+        reg.duration = std::shared_ptr<otel_metrics::Histogram<double>>(
+            reg.meter->CreateDoubleHistogram("psb.sockutils.accept.duration", "Duration of accept() calls", "s")
+                .release()
+        );
+
+        reg.connections->AddCallback(observe_connections, nullptr);
+        reg.errors->AddCallback(observe_errors, nullptr);
+        reg.open_connections->AddCallback(observe_open_connections, nullptr);
+        reg.listeners_created->AddCallback(observe_listeners, nullptr);
+    }
+
+    detail::metrics_enabled.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void disable_metrics() noexcept
+{
+    detail::metrics_enabled.store(false, std::memory_order_relaxed);
+
+    auto& reg = registry::instance();
+    const std::lock_guard lock(reg.mutex);
+    if (reg.meter) {
+        reg.connections->RemoveCallback(observe_connections, nullptr);
+        reg.errors->RemoveCallback(observe_errors, nullptr);
+        reg.open_connections->RemoveCallback(observe_open_connections, nullptr);
+        reg.listeners_created->RemoveCallback(observe_listeners, nullptr);
+
+        reg.connections       = nullptr;
+        reg.errors            = nullptr;
+        reg.open_connections  = nullptr;
+        reg.listeners_created = nullptr;
+        reg.duration          = nullptr;
+        reg.meter             = nullptr;
+    }
+}
+
+void record_socket_closed() noexcept
+{
+    if (detail::metrics_enabled.load(std::memory_order_relaxed)) {
+        local_metrics().closed.increment();
+    }
+}
+
+accept_metrics_t get_accept_metrics()
+{
+    auto& reg         = registry::instance();
+    const auto totals = reg.totals();
+
+    accept_metrics_t result{
+        .accepted     = totals.accepted,
+        .closed       = totals.closed,
+        .econnaborted = totals.errors.at(econnaborted),
+        .emfile       = totals.errors.at(emfile),
+        .enfile       = totals.errors.at(enfile),
+        .eagain       = totals.errors.at(eagain),
+        .other_errors = totals.errors.at(other_error),
+        .listeners    = 0,
+    };
+
+    const std::lock_guard lock(reg.mutex);
+    for (const auto& [key, count] : reg.listeners) {
+        result.listeners += count;
+    }
+
+    return result;
+}
+
+}  // namespace psb
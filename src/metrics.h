@@ -0,0 +1,66 @@
+#ifndef FB7C85D1_8EC8_4638_B24C_BD9342DB6E6E
+#define FB7C85D1_8EC8_4638_B24C_BD9342DB6E6E
+
+#include <cstdint>
+#include <string_view>
+
+#include "export.h"
+
+namespace psb {
+
+/**
+ * Totals of the accept-path metrics over all threads.
+ */
+struct accept_metrics_t {
+    std::uint64_t accepted;      // Accepted connections
+    std::uint64_t closed;        // Connections reported as closed with `record_socket_closed()`
+    std::uint64_t econnaborted;  // Failed accepts, by error
+    std::uint64_t emfile;
+    std::uint64_t enfile;
+    std::uint64_t eagain;
+    std::uint64_t other_errors;
+    std::uint64_t listeners;     // Listening sockets created
+};
+
+/**
+ * @brief Starts recording accept-path metrics and exports them through the global OpenTelemetry MeterProvider.
+ *
+ * Instruments (attributes follow the semantic conventions):
+ * - `psb.sockutils.accept.connections`: counter of accepted connections;
+ * - `psb.sockutils.accept.errors`: counter of failed accepts, by `error.type` (`ECONNABORTED`, `EMFILE`, `ENFILE`,
+ *   `EAGAIN` or `_OTHER`);
+ * - `psb.sockutils.accept.duration`: histogram of the duration of `accept4()` calls, in seconds;
+ * - `psb.sockutils.open_connections`: up-down counter of accepted connections not yet reported as closed;
+ * - `psb.sockutils.listeners`: counter of listening sockets created, by `network.transport` and `network.type`.
+ *
+ * Counts are kept in per-thread counters which only the owning thread writes (no atomic read-modify-write) and
+ * which are summed when the metrics are collected. Accept durations are buffered per thread and recorded in
+ * batches, so a thread's most recent durations become visible with a delay.
+ *
+ * Until this function is called, or if no MeterProvider has been set, the accept path only checks a flag.
+ *
+ * @param meter_name Instrumentation scope name.
+ * @return Whether metrics are being recorded (false if the global MeterProvider is the no-op one).
+ */
+PSB_SOCKUTILS_EXPORT bool enable_metrics(std::string_view meter_name = "psb-sockutils");
+
+/**
+ * @brief Stops recording and exporting the accept-path metrics; the totals are kept.
+ */
+PSB_SOCKUTILS_EXPORT void disable_metrics() noexcept;
+
+/**
+ * @brief Tells the library that an accepted socket has been closed; maintains `psb.sockutils.open_connections`.
+ *
+ * The library cannot see when accepted sockets are closed, so the application reports it.
+ */
+PSB_SOCKUTILS_EXPORT void record_socket_closed() noexcept;
+
+/**
+ * @brief Gets the totals of the accept-path metrics recorded so far.
+ */
+PSB_SOCKUTILS_EXPORT accept_metrics_t get_accept_metrics();
+
+}  // namespace psb
+
+#endif /* FB7C85D1_8EC8_4638_B24C_BD9342DB6E6E */
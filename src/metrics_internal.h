@@ -0,0 +1,25 @@
+#ifndef E1E5547C_C402_43E4_9348_DF10D5CA7A20
+#define E1E5547C_C402_43E4_9348_DF10D5CA7A20
+
+#include <atomic>
+#include <chrono>
+
+// Hooks for the instrumented code paths; not installed.
+
+namespace psb::detail {
+
+inline std::atomic<bool> metrics_enabled{false};  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+/**
+ * Records an `accept4()` call which took @a elapsed and failed with @a err (0 on success). Preserves `errno`.
+ */
+void record_accept(int err, std::chrono::steady_clock::duration elapsed) noexcept;
+
+/**
+ * Records the creation of a listening socket; @a type is `nullptr` for UNIX sockets.
+ */
+void record_listener(const char* transport, const char* type) noexcept;
+
+}  // namespace psb::detail
+
+#endif /* E1E5547C_C402_43E4_9348_DF10D5CA7A20 */
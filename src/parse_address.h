@@ -0,0 +1,295 @@
+#ifndef ADC25371_609B_42CE_A15E_6296FC532CFD
+#define ADC25371_609B_42CE_A15E_6296FC532CFD
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+namespace psb {
+
+namespace detail {
+
+using ipv4_bytes_t = std::array<std::uint8_t, sizeof(in_addr)>;
+using ipv6_bytes_t = std::array<std::uint8_t, sizeof(in6_addr)>;
+
+constexpr int hex_digit_value(char c) noexcept
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+/**
+ * Parses a dotted-quad IPv4 address with the same rules as glibc's `inet_pton(AF_INET)`:
+ * exactly four decimal octets, each in the range 0-255, without leading zeros.
+ */
+constexpr bool parse_ipv4_bytes(std::string_view src, std::span<std::uint8_t, sizeof(in_addr)> dst) noexcept
+{
+    ipv4_bytes_t tmp{};
+    std::size_t current = 0;  // Index of the octet being parsed
+    std::size_t octets  = 0;  // Number of octets seen so far
+    bool saw_digit      = false;
+
+    for (const auto ch : src) {
+        if (ch >= '0' && ch <= '9') {
+            auto& octet = tmp.at(current);
+            if (saw_digit && octet == 0) {
+                return false;
+            }
+
+            const auto value = static_cast<unsigned int>(octet) * 10U + static_cast<unsigned int>(ch - '0');
+            if (value > 255U) {
+                return false;
+            }
+
+            octet = static_cast<std::uint8_t>(value);
+            if (!saw_digit) {
+                if (++octets > tmp.size()) {
+                    return false;
+                }
+
+                saw_digit = true;
+            }
+        }
+        else if (ch == '.' && saw_digit) {
+            if (octets == tmp.size()) {
+                return false;
+            }
+
+            ++current;
+            saw_digit = false;
+        }
+        else {
+            return false;
+        }
+    }
+
+    if (octets < tmp.size()) {
+        return false;
+    }
+
+    std::ranges::copy(tmp, dst.begin());
+    return true;
+}
+
+/**
+ * Parses an IPv6 address with the same rules as glibc's `inet_pton(AF_INET6)`, including the `::` shorthand
+ * and a trailing dotted-quad IPv4 address.
+ */
+constexpr bool parse_ipv6_bytes(std::string_view src, std::span<std::uint8_t, sizeof(in6_addr)> dst) noexcept
+{
+    ipv6_bytes_t tmp{};
+    constexpr std::size_t npos = tmp.size() + 1;
+
+    std::size_t tp     = 0;     // Write position in tmp
+    std::size_t colonp = npos;  // Position of the `::` in tmp, if any
+
+    if (src.empty()) {
+        return false;
+    }
+
+    // Leading :: requires some special handling
+    if (src.front() == ':') {
+        src.remove_prefix(1);
+        if (src.empty() || src.front() != ':') {
+            return false;
+        }
+    }
+
+    std::size_t curtok       = 0;
+    std::size_t xdigits_seen = 0;
+    unsigned int val         = 0;
+
+    for (std::size_t i = 0; i < src.size();) {
+        const auto ch = src[i++];
+
+        if (const auto digit = hex_digit_value(ch); digit >= 0) {
+            if (xdigits_seen == 4) {
+                return false;
+            }
+
+            val = (val << 4U) | static_cast<unsigned int>(digit);
+            ++xdigits_seen;
+            continue;
+        }
+
+        if (ch == ':') {
+            curtok = i;
+            if (xdigits_seen == 0) {
+                if (colonp != npos) {
+                    return false;
+                }
+
+                colonp = tp;
+                continue;
+            }
+
+            if (i == src.size() || tp + 2 > tmp.size()) {
+                return false;
+            }
+
+            tmp.at(tp++) = static_cast<std::uint8_t>(val >> 8U);
+            tmp.at(tp++) = static_cast<std::uint8_t>(val & 0xFFU);
+            xdigits_seen = 0;
+            val          = 0;
+            continue;
+        }
+
+        if (ch == '.' && tp + sizeof(in_addr) <= tmp.size() &&
+            parse_ipv4_bytes(src.substr(curtok), std::span(tmp).subspan(tp).first<sizeof(in_addr)>()))
+        {
+            tp += sizeof(in_addr);
+            xdigits_seen = 0;
+            break;
+        }
+
+        return false;
+    }
+
+    if (xdigits_seen > 0) {
+        if (tp + 2 > tmp.size()) {
+            return false;
+        }
+
+        tmp.at(tp++) = static_cast<std::uint8_t>(val >> 8U);
+        tmp.at(tp++) = static_cast<std::uint8_t>(val & 0xFFU);
+    }
+
+    if (colonp != npos) {
+        // :: would expand to a zero-width field
+        if (tp == tmp.size()) {
+            return false;
+        }
+
+        // Move the groups after :: to the end and zero-fill the gap
+        const auto n = tp - colonp;
+        std::ranges::copy_backward(
+            std::span(tmp).subspan(colonp, n), std::span(tmp).subspan(tmp.size() - n).end()
+        );
+        std::ranges::fill(std::span(tmp).subspan(colonp, tmp.size() - n - colonp), 0);
+        tp = tmp.size();
+    }
+
+    if (tp != tmp.size()) {
+        return false;
+    }
+
+    std::ranges::copy(tmp, dst.begin());
+    return true;
+}
+
+constexpr in_port_t host_to_network(std::uint16_t port) noexcept
+{
+    const std::array<std::uint8_t, sizeof(in_port_t)> bytes{
+        static_cast<std::uint8_t>(port >> 8U), static_cast<std::uint8_t>(port & 0xFFU)
+    };
+
+    return std::bit_cast<in_port_t>(bytes);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Parses the IPv4 address @a address into @a dst without throwing or allocating memory.
+ *
+ * Accepts exactly what `inet_pton(AF_INET)` accepts. @a dst is left untouched on failure.
+ *
+ * @param address IPv4 address.
+ * @param dst Network address structure to store the result.
+ * @return `std::errc{}` on success, `std::errc::invalid_argument` if @a address is not a valid IPv4 address.
+ */
+constexpr std::errc parse_ipv4(std::string_view address, in_addr& dst) noexcept
+{
+    detail::ipv4_bytes_t bytes{};
+    if (!detail::parse_ipv4_bytes(address, bytes)) {
+        return std::errc::invalid_argument;
+    }
+
+    dst.s_addr = std::bit_cast<in_addr_t>(bytes);
+    return {};
+}
+
+/**
+ * @brief Parses the IPv6 address @a address into @a dst without throwing or allocating memory.
+ *
+ * Accepts exactly what `inet_pton(AF_INET6)` accepts. @a dst is left untouched on failure.
+ *
+ * @param address IPv6 address.
+ * @param dst Network address structure to store the result.
+ * @return `std::errc{}` on success, `std::errc::invalid_argument` if @a address is not a valid IPv6 address.
+ */
+constexpr std::errc parse_ipv6(std::string_view address, in6_addr& dst) noexcept
+{
+    detail::ipv6_bytes_t bytes{};
+    if (!detail::parse_ipv6_bytes(address, bytes)) {
+        return std::errc::invalid_argument;
+    }
+
+    std::ranges::copy(bytes, std::begin(dst.s6_addr));
+    return {};
+}
+
+/**
+ * @brief Builds an IPv4 socket address at compile time.
+ *
+ * An invalid @a address is a compile-time error.
+ *
+ * @param address IPv4 address.
+ * @param port Port number.
+ * @return The socket address, ready to be passed to `bind()` or `create_listening_socket()`.
+ */
+consteval sockaddr_in make_sockaddr_in(std::string_view address, std::uint16_t port)
+{
+    sockaddr_in sin{};
+    sin.sin_family = AF_INET;
+    sin.sin_port   = detail::host_to_network(port);
+    if (parse_ipv4(address, sin.sin_addr) != std::errc{}) {
+        throw std::invalid_argument("Invalid IPv4 address");
+    }
+
+    return sin;
+}
+
+/**
+ * @brief Builds an IPv6 socket address at compile time.
+ *
+ * An invalid @a address is a compile-time error.
+ *
+ * @param address IPv6 address.
+ * @param port Port number.
+ * @return The socket address, ready to be passed to `bind()` or `create_listening_socket()`.
+ */
+consteval sockaddr_in6 make_sockaddr_in6(std::string_view address, std::uint16_t port)
+{
+    sockaddr_in6 sin6{};
+    sin6.sin6_family = AF_INET6;
+    sin6.sin6_port   = detail::host_to_network(port);
+    if (parse_ipv6(address, sin6.sin6_addr) != std::errc{}) {
+        throw std::invalid_argument("Invalid IPv6 address");
+    }
+
+    return sin6;
+}
+
+}  // namespace psb
+
+#endif /* ADC25371_609B_42CE_A15E_6296FC532CFD */
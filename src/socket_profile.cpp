@@ -0,0 +1,26 @@
+#include "socket_profile.h"
+
+#include <atomic>
+
+#include <netinet/in.h>
+
+#include <opentelemetry/semconv/incubating/network_attributes.h>
+
+#include "metrics_internal.h"
+
+namespace psb::detail {
+
+listening_socket_t finish_profile_listener(int sock, int family) noexcept
+{
+    using namespace opentelemetry::semconv::network::NetworkTransportValues;
+    using namespace opentelemetry::semconv::network::NetworkTypeValues;
+
+    const auto* network_type = family == AF_INET6 ? kIpv6 : kIpv4;
+    if (metrics_enabled.load(std::memory_order_relaxed)) [[unlikely]] {
+        record_listener(kTcp, network_type);
+    }
+
+    return {.sock = sock, .transport = kTcp, .type = network_type};
+}
+
+}  // namespace psb::detail
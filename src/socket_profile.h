@@ -0,0 +1,414 @@
+#ifndef D0A46B31_17C4_4556_81B6_46570BED7802
+#define D0A46B31_17C4_4556_81B6_46570BED7802
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "export.h"
+#include "sockutils.h"
+
+namespace psb {
+
+namespace detail {
+
+/// Option names which the platform may lack; -1 marks an unsupported one.
+#if defined(IP_FREEBIND)
+inline constexpr int ip_freebind = IP_FREEBIND;
+#else
+inline constexpr int ip_freebind = -1;
+#endif
+
+#if defined(SO_REUSEPORT)
+inline constexpr int so_reuseport = SO_REUSEPORT;
+#else
+inline constexpr int so_reuseport = -1;
+#endif
+
+#if defined(TCP_DEFER_ACCEPT)
+inline constexpr int tcp_defer_accept = TCP_DEFER_ACCEPT;
+#else
+inline constexpr int tcp_defer_accept = -1;
+#endif
+
+#if defined(TCP_FASTOPEN)
+inline constexpr int tcp_fastopen = TCP_FASTOPEN;
+#else
+inline constexpr int tcp_fastopen = -1;
+#endif
+
+#if defined(TCP_KEEPIDLE) && defined(TCP_KEEPINTVL) && defined(TCP_KEEPCNT)
+inline constexpr int tcp_keepidle  = TCP_KEEPIDLE;
+inline constexpr int tcp_keepintvl = TCP_KEEPINTVL;
+inline constexpr int tcp_keepcnt   = TCP_KEEPCNT;
+#else
+inline constexpr int tcp_keepidle  = -1;
+inline constexpr int tcp_keepintvl = -1;
+inline constexpr int tcp_keepcnt   = -1;
+#endif
+
+#if defined(TCP_USER_TIMEOUT)
+inline constexpr int tcp_user_timeout = TCP_USER_TIMEOUT;
+#else
+inline constexpr int tcp_user_timeout = -1;
+#endif
+
+#if defined(TCP_NOTSENT_LOWAT)
+inline constexpr int tcp_notsent_lowat = TCP_NOTSENT_LOWAT;
+#else
+inline constexpr int tcp_notsent_lowat = -1;
+#endif
+
+#if defined(TCP_QUICKACK)
+inline constexpr int tcp_quickack = TCP_QUICKACK;
+#else
+inline constexpr int tcp_quickack = -1;
+#endif
+
+/**
+ * Sets the option @a Name to @a Value unless @a ec is already set. Unlike `psb::set_socket_option()`, `ENOPROTOOPT`
+ * is an error: a profile only sets options it has checked at compile time.
+ */
+template<int Level, int Name, int Value>
+void set_profile_option(int sock, std::error_code& ec) noexcept
+{
+    static_assert(Name != -1);
+
+    constexpr int optval = Value;
+    if (!ec && setsockopt(sock, Level, Name, &optval, sizeof(optval)) != 0) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
+    }
+}
+
+/**
+ * Completes `socket_profile::create_listening_socket()`: fills in the transport and the network type of the listener
+ * @a sock of the address family @a family and records it in the metrics if they are enabled.
+ */
+PSB_SOCKUTILS_EXPORT listening_socket_t finish_profile_listener(int sock, int family) noexcept;
+
+}  // namespace detail
+
+/**
+ * @brief Socket options fixed at compile time.
+ *
+ * `create_listening_socket()` and `set_accepted_socket_options()` test every field of `socket_options_t` for every
+ * socket. A `socket_profile` takes the options as a template argument instead, so that its functions contain only
+ * the system calls the options need: no tests for unset options, `SOCK_CLOEXEC` in the `socket()` call rather than
+ * a separate `fcntl()`, and no call at all for accepted sockets unless `quick_ack` is set.
+ *
+ * The options are checked when the profile is instantiated. Options which the platform does not support
+ * (`free_bind` without `IP_FREEBIND`, `defer_accept_timeout` without `TCP_DEFER_ACCEPT`, and so on) are compile
+ * errors rather than being skipped, and an `ENOPROTOOPT` from `setsockopt()` is reported rather than ignored.
+ * Profiles create TCP listeners only, so the UNIX socket options must be zero. `listen_backlog_auto` and
+ * `strict_backlog` still read `net.core.somaxconn` when the listener is created.
+ *
+ * @code
+ * constexpr psb::socket_options_t opts{
+ *     .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+ * };
+ * using profile = psb::socket_profile<opts>;
+ *
+ * const auto ls = profile::create_listening_socket("::", 8080);
+ * @endcode
+ *
+ * @tparam Options Socket options; the fields keep their `socket_options_t` meaning.
+ */
+template<socket_options_t Options>
+class socket_profile {
+    static_assert(
+        Options.seqpacket == 0 && Options.unix_mode == 0 && Options.unlink_stale == 0,
+        "socket profiles create TCP listeners; use create_listening_socket() for UNIX sockets"
+    );
+    static_assert(Options.listen_backlog >= 0 || Options.listen_backlog == listen_backlog_auto, "invalid backlog");
+    static_assert(Options.v6_only >= -1 && Options.v6_only <= 1, "v6_only must be -1, 0 or 1");
+    static_assert(Options.free_bind == 0 || detail::ip_freebind != -1, "IP_FREEBIND is not supported");
+    static_assert(Options.reuse_port == 0 || detail::so_reuseport != -1, "SO_REUSEPORT is not supported");
+    static_assert(
+        Options.defer_accept_timeout == 0 || detail::tcp_defer_accept != -1, "TCP_DEFER_ACCEPT is not supported"
+    );
+    static_assert(Options.fastopen_queue == 0 || detail::tcp_fastopen != -1, "TCP_FASTOPEN is not supported");
+    static_assert(
+        (Options.keep_idle == 0 && Options.keep_interval == 0 && Options.keep_count == 0) || detail::tcp_keepidle != -1,
+        "TCP_KEEPIDLE, TCP_KEEPINTVL and TCP_KEEPCNT are not supported"
+    );
+    static_assert(Options.user_timeout == 0 || detail::tcp_user_timeout != -1, "TCP_USER_TIMEOUT is not supported");
+    static_assert(
+        Options.notsent_lowat == 0 || detail::tcp_notsent_lowat != -1, "TCP_NOTSENT_LOWAT is not supported"
+    );
+    static_assert(Options.quick_ack == 0 || detail::tcp_quickack != -1, "TCP_QUICKACK is not supported");
+
+public:
+    /// The options of the profile.
+    static constexpr socket_options_t options = Options;
+
+    /// Whether accepted sockets need `set_accepted_socket_options()`; if not, the call compiles to nothing.
+    static constexpr bool sets_accepted_options = Options.quick_ack != 0;
+
+    /**
+     * @brief Creates a TCP listening socket bound to @a ss with the options of the profile; non-throwing variant.
+     *
+     * The socket is non-blocking, like the ones made by `psb::create_listening_socket()`.
+     *
+     * @param ss IPv4 or IPv6 socket address.
+     * @param len Length of the socket address.
+     * @param ec Set to the error if a call to a system API failed, cleared otherwise.
+     * @return The listening socket; `sock` is -1 on failure.
+     */
+    static listening_socket_t
+    create_listening_socket(const sockaddr_storage& ss, socklen_t len, std::error_code& ec) noexcept;
+
+    /**
+     * @brief Creates a TCP listening socket bound to @a ss with the options of the profile.
+     *
+     * @param ss IPv4 or IPv6 socket address.
+     * @param len Length of the socket address.
+     * @return The listening socket.
+     * @throw std::system_error Call to a system API failed.
+     */
+    static listening_socket_t create_listening_socket(const sockaddr_storage& ss, socklen_t len)
+    {
+        std::error_code ec;
+        const auto result = create_listening_socket(ss, len, ec);
+        if (ec) [[unlikely]] {
+            const auto info = get_socket_info(ss, len);
+            throw std::system_error(ec, std::format("create_listening_socket({}) failed", info));
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Creates a TCP listening socket bound to @a addr with the options of the profile.
+     *
+     * Together with `make_sockaddr_in()`, both the address and the options are fixed at compile time.
+     *
+     * @param addr IPv4 socket address.
+     * @return The listening socket.
+     * @throw std::system_error Call to a system API failed.
+     */
+    static listening_socket_t create_listening_socket(const sockaddr_in& addr)
+    {
+        sockaddr_storage ss{};
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        reinterpret_cast<sockaddr_in&>(ss) = addr;
+        return create_listening_socket(ss, sizeof(addr));
+    }
+
+    /**
+     * @brief Creates a TCP listening socket bound to @a addr with the options of the profile.
+     *
+     * @param addr IPv6 socket address.
+     * @return The listening socket.
+     * @throw std::system_error Call to a system API failed.
+     */
+    static listening_socket_t create_listening_socket(const sockaddr_in6& addr)
+    {
+        sockaddr_storage ss{};
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        reinterpret_cast<sockaddr_in6&>(ss) = addr;
+        return create_listening_socket(ss, sizeof(addr));
+    }
+
+    /**
+     * @brief Creates a TCP listening socket bound to @a address and @a port with the options of the profile.
+     *
+     * @param address IPv4 or IPv6 address.
+     * @param port Port number; 0 picks an ephemeral port.
+     * @return The listening socket.
+     * @throw std::invalid_argument @a address is not an IP address.
+     * @throw std::system_error Call to a system API failed.
+     */
+    static listening_socket_t create_listening_socket(std::string_view address, std::uint16_t port)
+    {
+        sockaddr_storage ss{};
+        socklen_t len{};
+        if (make_socket_address(address, port, ss, len) != std::errc{} || ss.ss_family == AF_UNIX) [[unlikely]] {
+            throw std::invalid_argument(std::format("Invalid address: {}", address));
+        }
+
+        return create_listening_socket(ss, len);
+    }
+
+    /**
+     * @brief Sets the options of the profile which accepted sockets do not inherit; non-throwing variant.
+     *
+     * @param sock Accepted socket.
+     * @param ec Set to the error if the call to `setsockopt()` failed, cleared otherwise.
+     */
+    static void set_accepted_socket_options([[maybe_unused]] int sock, std::error_code& ec) noexcept
+    {
+        ec.clear();
+        if constexpr (Options.quick_ack != 0) {
+            detail::set_profile_option<IPPROTO_TCP, detail::tcp_quickack, Options.quick_ack>(sock, ec);
+        }
+    }
+
+    /**
+     * @brief Sets the options of the profile which accepted sockets do not inherit.
+     *
+     * @param sock Accepted socket.
+     * @throw std::system_error Call to `setsockopt()` failed.
+     */
+    static void set_accepted_socket_options(int sock)
+    {
+        std::error_code ec;
+        set_accepted_socket_options(sock, ec);
+        if (ec) [[unlikely]] {
+            throw std::system_error(ec, "setsockopt(TCP_QUICKACK) failed");
+        }
+    }
+
+    /**
+     * @brief Accepts a batch of connections (see `psb::accept_connections()`) and sets the per-connection options.
+     *
+     * A socket on which the options could not be set is still returned; the error is reported in `error` if the
+     * batch itself did not fail.
+     *
+     * @param fd Listening socket descriptor; should be non-blocking.
+     * @param sockets Storage for the accepted sockets; the first `count` elements are filled in.
+     * @param budget Maximum number of connections to accept.
+     * @return Number of accepted sockets and the error which stopped the batch, if any.
+     */
+    static accept_batch_result_t
+    accept_connections(int fd, std::span<raw_accepted_socket_t> sockets, std::size_t budget)
+    {
+        auto result = psb::accept_connections(fd, sockets, budget);
+        if constexpr (sets_accepted_options) {
+            std::error_code ec;
+            for (const auto& accepted : sockets.first(result.count)) {
+                set_accepted_socket_options(accepted.sock, ec);
+                if (ec && !result.error) [[unlikely]] {
+                    result.error = ec;
+                }
+            }
+        }
+
+        return result;
+    }
+};
+
+template<socket_options_t Options>
+listening_socket_t socket_profile<Options>::create_listening_socket(
+    const sockaddr_storage& ss, socklen_t len, std::error_code& ec
+) noexcept
+{
+    using detail::set_profile_option;
+
+    ec.clear();
+
+    constexpr int type = SOCK_STREAM | SOCK_NONBLOCK | (Options.close_on_exec != 0 ? SOCK_CLOEXEC : 0);
+    const auto sock    = socket(ss.ss_family, type, IPPROTO_TCP);
+    if (sock < 0) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
+        return {.sock = -1};
+    }
+
+    // The same order as psb::create_listening_socket()
+    if constexpr (Options.reuse_addr != 0) {
+        set_profile_option<SOL_SOCKET, SO_REUSEADDR, Options.reuse_addr>(sock, ec);
+    }
+
+    if constexpr (Options.receive_buffer != 0) {
+        set_profile_option<SOL_SOCKET, SO_RCVBUF, Options.receive_buffer>(sock, ec);
+    }
+
+    if constexpr (Options.send_buffer != 0) {
+        set_profile_option<SOL_SOCKET, SO_SNDBUF, Options.send_buffer>(sock, ec);
+    }
+
+    if constexpr (Options.v6_only != 0) {
+        if (ss.ss_family == AF_INET6) {
+            set_profile_option<IPPROTO_IPV6, IPV6_V6ONLY, (Options.v6_only > 0 ? 1 : 0)>(sock, ec);
+        }
+    }
+
+    if constexpr (Options.free_bind != 0) {
+        set_profile_option<IPPROTO_IP, detail::ip_freebind, Options.free_bind>(sock, ec);
+    }
+
+    if constexpr (Options.reuse_port != 0) {
+        set_profile_option<SOL_SOCKET, detail::so_reuseport, Options.reuse_port>(sock, ec);
+    }
+
+    if constexpr (Options.defer_accept_timeout != 0) {
+        set_profile_option<IPPROTO_TCP, detail::tcp_defer_accept, Options.defer_accept_timeout>(sock, ec);
+    }
+
+    if constexpr (Options.fastopen_queue != 0) {
+        set_profile_option<IPPROTO_TCP, detail::tcp_fastopen, Options.fastopen_queue>(sock, ec);
+    }
+
+    if constexpr (Options.no_delay != 0) {
+        set_profile_option<IPPROTO_TCP, TCP_NODELAY, Options.no_delay>(sock, ec);
+    }
+
+    if constexpr (Options.keep_alive != 0) {
+        set_profile_option<SOL_SOCKET, SO_KEEPALIVE, Options.keep_alive>(sock, ec);
+    }
+
+    if constexpr (Options.keep_idle != 0) {
+        set_profile_option<IPPROTO_TCP, detail::tcp_keepidle, Options.keep_idle>(sock, ec);
+    }
+
+    if constexpr (Options.keep_interval != 0) {
+        set_profile_option<IPPROTO_TCP, detail::tcp_keepintvl, Options.keep_interval>(sock, ec);
+    }
+
+    if constexpr (Options.keep_count != 0) {
+        set_profile_option<IPPROTO_TCP, detail::tcp_keepcnt, Options.keep_count>(sock, ec);
+    }
+
+    if constexpr (Options.user_timeout != 0) {
+        set_profile_option<IPPROTO_TCP, detail::tcp_user_timeout, Options.user_timeout>(sock, ec);
+    }
+
+    if constexpr (Options.notsent_lowat != 0) {
+        set_profile_option<IPPROTO_TCP, detail::tcp_notsent_lowat, Options.notsent_lowat>(sock, ec);
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (!ec && bind(sock, reinterpret_cast<const sockaddr*>(&ss), len) != 0) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
+    }
+
+    int backlog = Options.listen_backlog;
+    if constexpr (Options.listen_backlog == listen_backlog_auto || Options.strict_backlog != 0) {
+        // The only option which depends on the running system
+        std::error_code backlog_ec;
+        const auto max_backlog = get_max_listen_backlog(backlog_ec);
+        if constexpr (Options.listen_backlog == listen_backlog_auto) {
+            backlog = backlog_ec ? SOMAXCONN : max_backlog;
+        }
+        else if (!ec) {
+            ec = backlog_ec;
+            if (!ec && backlog > max_backlog) {
+                ec = std::make_error_code(std::errc::invalid_argument);
+            }
+        }
+    }
+
+    if (!ec && listen(sock, backlog) != 0) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
+    }
+
+    if (ec) [[unlikely]] {
+        close(sock);
+        return {.sock = -1};
+    }
+
+    return detail::finish_profile_listener(sock, ss.ss_family);
+}
+
+}  // namespace psb
+
+#endif /* D0A46B31_17C4_4556_81B6_46570BED7802 */
@@ -2,24 +2,41 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
 #include <cerrno>
 #include <cstdint>
+#include <cstring>
 #include <exception>
 #include <format>
 #include <iterator>
+#include <span>
+#include <stdexcept>
 #include <string_view>
 #include <system_error>
+#include <utility>
+#include <vector>
 
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/un.h>
 #include <unistd.h>
 
+#if defined(__linux__)
+#    include <linux/filter.h>
+#endif
+
 #include <opentelemetry/semconv/incubating/network_attributes.h>
 
+#include "metrics_internal.h"
+
 namespace {
 
 class [[nodiscard]] close_on_error {
@@ -43,235 +60,1306 @@ private:
     int m_uncaught_init = std::uncaught_exceptions();
 };
 
-[[noreturn]] void throw_bind_error(int err, const std::string& address, std::uint16_t port)
+/**
+ * Parses @a address and @a port into @a ss; throws `std::invalid_argument` if @a address is not a valid address.
+ */
+socklen_t parse_socket_address(std::string_view address, std::uint16_t port, sockaddr_storage& ss)
 {
-    throw std::system_error(err, std::generic_category(), std::format("bind({}:{}) failed", address, port));
+    socklen_t len{};
+    if (psb::make_socket_address(address, port, ss, len) != std::errc{}) [[unlikely]] {
+        throw std::invalid_argument(std::format("Invalid address: {}", address));
+    }
+
+    return len;
 }
 
-void bind_ipv4(int sock, const std::string& address, std::uint16_t port)
+void bind_address(int sock, const sockaddr_storage& ss, socklen_t len, std::error_code& ec) noexcept
 {
-    sockaddr_in sin{};
-    psb::inet_pton(address, sin.sin_addr);
-    sin.sin_family = AF_INET;
-    sin.sin_port   = htons(port);
-
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-    if (const auto res = bind(sock, reinterpret_cast<const sockaddr*>(&sin), sizeof(sin)); res < 0) [[unlikely]] {
-        throw_bind_error(errno, address, port);
+    if (const auto res = bind(sock, reinterpret_cast<const sockaddr*>(&ss), len); res < 0) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
     }
 }
 
-void bind_ipv6(int sock, const std::string& address, std::uint16_t port)
+[[noreturn]] void throw_bind_error(const std::error_code& ec, const sockaddr_storage& ss, socklen_t len)
 {
-    sockaddr_in6 sin{};
-    psb::inet_pton(address, sin.sin6_addr);
-    sin.sin6_family = AF_INET6;
-    sin.sin6_port   = htons(port);
+    const auto info = psb::get_socket_info(ss, len);
+    throw std::system_error(ec, std::format("bind({}) failed", info));
+}
 
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-    if (const auto res = bind(sock, reinterpret_cast<const sockaddr*>(&sin), sizeof(sin)); res < 0) [[unlikely]] {
-        throw_bind_error(errno, address, port);
+/**
+ * Sets the socket option @a optname to @a optval unless @a ec is already set; on failure, sets @a what to @a step.
+ */
+void set_option(
+    int sock, int level, int optname, int optval, const char* step, std::error_code& ec, const char*& what
+) noexcept
+{
+    if (!ec) {
+        psb::set_socket_option(sock, level, optname, optval, ec);
+        if (ec) [[unlikely]] {
+            what = step;
+        }
     }
 }
 
-void handle_socket_options(int sock, const psb::socket_options_t& opts)
+/**
+ * Makes @a sock non-blocking and, with `close_on_exec`, close-on-exec, unless @a ec is already set; on failure,
+ * sets @a what to the failed step.
+ */
+void handle_fd_flags(int sock, const psb::socket_options_t& opts, std::error_code& ec, const char*& what) noexcept
 {
-    if (opts.close_on_exec != 0) {
-        psb::make_close_on_exec(sock);
+    if (!ec) {
+        psb::make_nonblocking(sock, ec);
+        if (ec) [[unlikely]] {
+            what = "fcntl(O_NONBLOCK)";
+        }
     }
 
+    if (opts.close_on_exec != 0 && !ec) {
+        psb::make_close_on_exec(sock, ec);
+        if (ec) [[unlikely]] {
+            what = "fcntl(FD_CLOEXEC)";
+        }
+    }
+}
+
+void handle_socket_options(
+    int sock, const psb::socket_options_t& opts, std::error_code& ec, const char*& what
+) noexcept
+{
     if (opts.reuse_addr != 0) {
-        psb::set_socket_option(sock, SOL_SOCKET, SO_REUSEADDR, opts.reuse_addr, "SO_REUSEADDR");
+        set_option(sock, SOL_SOCKET, SO_REUSEADDR, opts.reuse_addr, "setsockopt(SO_REUSEADDR)", ec, what);
+    }
+
+    // The options below are inherited by the accepted sockets
+
+    if (opts.receive_buffer != 0) {
+        set_option(sock, SOL_SOCKET, SO_RCVBUF, opts.receive_buffer, "setsockopt(SO_RCVBUF)", ec, what);
+    }
+
+    if (opts.send_buffer != 0) {
+        set_option(sock, SOL_SOCKET, SO_SNDBUF, opts.send_buffer, "setsockopt(SO_SNDBUF)", ec, what);
+    }
+}
+
+/**
+ * Sets the IP level options, which do not apply to UNIX domain sockets.
+ */
+void handle_ip_options(
+    int sock, int family, const psb::socket_options_t& opts, std::error_code& ec, const char*& what
+) noexcept
+{
+    if (family == AF_INET6 && opts.v6_only != 0) {
+        set_option(sock, IPPROTO_IPV6, IPV6_V6ONLY, opts.v6_only > 0 ? 1 : 0, "setsockopt(IPV6_V6ONLY)", ec, what);
     }
 
 #if defined(IP_FREEBIND)
     if (opts.free_bind != 0) {
-        psb::set_socket_option(sock, IPPROTO_IP, IP_FREEBIND, opts.free_bind, "IP_FREEBIND");
+        set_option(sock, IPPROTO_IP, IP_FREEBIND, opts.free_bind, "setsockopt(IP_FREEBIND)", ec, what);
+    }
+#endif
+
+#if defined(SO_REUSEPORT)
+    if (opts.reuse_port != 0) {
+        set_option(sock, SOL_SOCKET, SO_REUSEPORT, opts.reuse_port, "setsockopt(SO_REUSEPORT)", ec, what);
     }
 #endif
+}
 
+/**
+ * Sets the TCP level options.
+ */
+void handle_tcp_options(
+    int sock, const psb::socket_options_t& opts, std::error_code& ec, const char*& what
+) noexcept
+{
 #if defined(TCP_DEFER_ACCEPT)
     if (opts.defer_accept_timeout != 0) {
-        psb::set_socket_option(sock, IPPROTO_TCP, TCP_DEFER_ACCEPT, opts.defer_accept_timeout, "TCP_DEFER_ACCEPT");
+        const auto* step = "setsockopt(TCP_DEFER_ACCEPT)";
+        set_option(sock, IPPROTO_TCP, TCP_DEFER_ACCEPT, opts.defer_accept_timeout, step, ec, what);
+    }
+#endif
+
+#if defined(TCP_FASTOPEN)
+    if (opts.fastopen_queue != 0) {
+        set_option(sock, IPPROTO_TCP, TCP_FASTOPEN, opts.fastopen_queue, "setsockopt(TCP_FASTOPEN)", ec, what);
+    }
+#endif
+
+    // The options below are inherited by the accepted sockets
+
+    if (opts.no_delay != 0) {
+        set_option(sock, IPPROTO_TCP, TCP_NODELAY, opts.no_delay, "setsockopt(TCP_NODELAY)", ec, what);
+    }
+
+    if (opts.keep_alive != 0) {
+        set_option(sock, SOL_SOCKET, SO_KEEPALIVE, opts.keep_alive, "setsockopt(SO_KEEPALIVE)", ec, what);
+    }
+
+#if defined(TCP_KEEPIDLE) && defined(TCP_KEEPINTVL) && defined(TCP_KEEPCNT)
+    if (opts.keep_idle != 0) {
+        set_option(sock, IPPROTO_TCP, TCP_KEEPIDLE, opts.keep_idle, "setsockopt(TCP_KEEPIDLE)", ec, what);
+    }
+
+    if (opts.keep_interval != 0) {
+        set_option(sock, IPPROTO_TCP, TCP_KEEPINTVL, opts.keep_interval, "setsockopt(TCP_KEEPINTVL)", ec, what);
+    }
+
+    if (opts.keep_count != 0) {
+        set_option(sock, IPPROTO_TCP, TCP_KEEPCNT, opts.keep_count, "setsockopt(TCP_KEEPCNT)", ec, what);
+    }
+#endif
+
+#if defined(TCP_USER_TIMEOUT)
+    if (opts.user_timeout != 0) {
+        set_option(sock, IPPROTO_TCP, TCP_USER_TIMEOUT, opts.user_timeout, "setsockopt(TCP_USER_TIMEOUT)", ec, what);
+    }
+#endif
+
+#if defined(TCP_NOTSENT_LOWAT)
+    if (opts.notsent_lowat != 0) {
+        set_option(sock, IPPROTO_TCP, TCP_NOTSENT_LOWAT, opts.notsent_lowat, "setsockopt(TCP_NOTSENT_LOWAT)", ec, what);
     }
 #endif
 }
 
+/**
+ * Removes the socket file at the path in @a ss if nothing listens on it anymore; a live socket is left in place,
+ * so that `bind()` fails with `EADDRINUSE`. Abstract addresses disappear with their socket and need no cleanup.
+ * On failure, sets @a what to the failed step.
+ */
+void remove_stale_socket(
+    const sockaddr_storage& ss, socklen_t len, int type, std::error_code& ec, const char*& what
+) noexcept
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto& sun = reinterpret_cast<const sockaddr_un&>(ss);
+    const auto* path = static_cast<const char*>(sun.sun_path);
+    if (len <= offsetof(sockaddr_un, sun_path) || path[0] == '\0') {  // NOLINT(*-pointer-arithmetic)
+        return;
+    }
+
+    struct stat st{};
+    if (lstat(path, &st) == -1 || !S_ISSOCK(st.st_mode)) {
+        // Nothing to remove; bind() reports a regular file in the way
+        return;
+    }
+
+    const auto probe = socket(AF_UNIX, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (probe == -1) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
+        what = "socket()";
+        return;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto res = connect(probe, reinterpret_cast<const sockaddr*>(&ss), len);
+    const auto err = errno;
+    close(probe);
+
+    if (res == -1 && err == ECONNREFUSED && unlink(path) == -1 && errno != ENOENT) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
+        what = "unlink()";
+    }
+}
+
+/**
+ * Returns the backlog to pass to `listen()`: `somaxconn` for `listen_backlog_auto`, otherwise the requested one.
+ * With `strict_backlog`, a backlog which the kernel would silently clamp is an error (`EINVAL`). On failure, sets
+ * @a what to the failed step.
+ */
+int resolve_backlog(const psb::socket_options_t& opts, std::error_code& ec, const char*& what) noexcept
+{
+    if (opts.listen_backlog != psb::listen_backlog_auto && opts.strict_backlog == 0) {
+        return opts.listen_backlog;
+    }
+
+    const auto max_backlog = psb::get_max_listen_backlog(ec);
+    if (opts.listen_backlog == psb::listen_backlog_auto) {
+        if (ec) {
+            // No procfs: fall back to the compile-time limit, which the kernel clamps if needed
+            ec.clear();
+            return SOMAXCONN;
+        }
+
+        return max_backlog;
+    }
+
+    if (ec) [[unlikely]] {
+        what = "get_max_listen_backlog()";
+    }
+    else if (opts.listen_backlog > max_backlog) {
+        ec   = std::make_error_code(std::errc::invalid_argument);
+        what = "listen()";
+    }
+
+    return opts.listen_backlog;
+}
+
+/**
+ * Core of `psb::create_listening_socket()`; on failure, sets @a what to the failed step, e.g., `setsockopt(SO_RCVBUF)`.
+ */
+psb::listening_socket_t create_listener(
+    const sockaddr_storage& ss, socklen_t len, const psb::socket_options_t& opts, std::error_code& ec, const char*& what
+) noexcept
+{
+    ec.clear();
+
+    const auto is_ipv6 = ss.ss_family == AF_INET6;
+    const auto is_unix = ss.ss_family == AF_UNIX;
+    const auto type    = is_unix && opts.seqpacket != 0 ? SOCK_SEQPACKET : SOCK_STREAM;
+    const auto sock    = socket(ss.ss_family, type, is_unix ? 0 : IPPROTO_TCP);
+
+    if (sock < 0) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
+        what = "socket()";
+        return {.sock = -1};
+    }
+
+    handle_fd_flags(sock, opts, ec, what);
+    handle_socket_options(sock, opts, ec, what);
+
+    if (!is_unix) {
+        handle_ip_options(sock, ss.ss_family, opts, ec, what);
+        handle_tcp_options(sock, opts, ec, what);
+    }
+    else if (opts.unlink_stale != 0 && !ec) {
+        remove_stale_socket(ss, len, type, ec, what);
+    }
+
+    if (!ec) {
+        bind_address(sock, ss, len, ec);
+        if (ec) [[unlikely]] {
+            what = "bind()";
+        }
+    }
+
+    if (is_unix && opts.unix_mode != 0 && !ec) {
+        // Before listen(), so that no client can connect while the socket file has the umask permissions
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        const auto* path = static_cast<const char*>(reinterpret_cast<const sockaddr_un&>(ss).sun_path);
+        if (path[0] != '\0' && chmod(path, static_cast<mode_t>(opts.unix_mode)) == -1) [[unlikely]] {
+            ec.assign(errno, std::generic_category());
+            what = "chmod()";
+        }
+    }
+
+    const auto backlog = ec ? -1 : resolve_backlog(opts, ec, what);
+    if (!ec && listen(sock, backlog) == -1) {
+        ec.assign(errno, std::generic_category());
+        what = "listen()";
+    }
+
+    if (ec) [[unlikely]] {
+        close(sock);
+        return {.sock = -1};
+    }
+
+    using namespace opentelemetry::semconv::network::NetworkTransportValues;
+    using namespace opentelemetry::semconv::network::NetworkTypeValues;
+
+    const auto* transport    = is_unix ? kUnix : kTcp;
+    const auto* network_type = is_unix ? nullptr : is_ipv6 ? kIpv6 : kIpv4;
+    if (psb::detail::metrics_enabled.load(std::memory_order_relaxed)) [[unlikely]] {
+        psb::detail::record_listener(transport, network_type);
+    }
+
+    return {.sock = sock, .transport = transport, .type = network_type};
+}
+
+/**
+ * Core of `psb::create_udp_socket()`; on failure, sets @a what to the failed step.
+ */
+psb::listening_socket_t create_udp(
+    const sockaddr_storage& ss, socklen_t len, const psb::socket_options_t& opts, std::error_code& ec, const char*& what
+) noexcept
+{
+    ec.clear();
+
+    if (ss.ss_family != AF_INET && ss.ss_family != AF_INET6) [[unlikely]] {
+        ec   = std::make_error_code(std::errc::address_family_not_supported);
+        what = "socket()";
+        return {.sock = -1};
+    }
+
+    const auto sock = socket(ss.ss_family, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
+        what = "socket()";
+        return {.sock = -1};
+    }
+
+    handle_fd_flags(sock, opts, ec, what);
+    handle_socket_options(sock, opts, ec, what);
+    handle_ip_options(sock, ss.ss_family, opts, ec, what);
+
+    if (!ec) {
+        bind_address(sock, ss, len, ec);
+        if (ec) [[unlikely]] {
+            what = "bind()";
+        }
+    }
+
+    if (ec) [[unlikely]] {
+        close(sock);
+        return {.sock = -1};
+    }
+
+    using namespace opentelemetry::semconv::network::NetworkTransportValues;
+    using namespace opentelemetry::semconv::network::NetworkTypeValues;
+
+    const auto* network_type = ss.ss_family == AF_INET6 ? kIpv6 : kIpv4;
+    if (psb::detail::metrics_enabled.load(std::memory_order_relaxed)) [[unlikely]] {
+        psb::detail::record_listener(kUdp, network_type);
+    }
+
+    return {.sock = sock, .transport = kUdp, .type = network_type};
+}
+
+/**
+ * Throws the error of the step @a what of creating a socket bound to @a ss, with the message the step would have
+ * thrown on its own, e.g., `setsockopt(TCP_DEFER_ACCEPT) failed` or `bind(127.0.0.1:80) failed`.
+ */
+[[noreturn]] void
+throw_step_error(const std::error_code& ec, const char* what, const sockaddr_storage& ss, socklen_t len)
+{
+    if (std::string_view(what) == "bind()") {
+        throw_bind_error(ec, ss, len);
+    }
+
+    throw std::system_error(ec, std::format("{} failed", what));
+}
+
+/**
+ * Makes the kernel pick the socket with the index `cpu % count` of the reuseport group @a sock belongs to.
+ */
+void attach_cpu_steering(int sock, std::size_t count)
+{
+#if defined(SO_ATTACH_REUSEPORT_CBPF)
+    std::array<sock_filter, 3> code{{
+        {.code = BPF_LD | BPF_W | BPF_ABS, .jt = 0, .jf = 0, .k = static_cast<std::uint32_t>(SKF_AD_OFF + SKF_AD_CPU)},
+        {.code = BPF_ALU | BPF_MOD | BPF_K, .jt = 0, .jf = 0, .k = static_cast<std::uint32_t>(count)},
+        {.code = BPF_RET | BPF_A, .jt = 0, .jf = 0, .k = 0},
+    }};
+
+    const sock_fprog prog{.len = static_cast<unsigned short>(code.size()), .filter = code.data()};
+    if (setsockopt(sock, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) != 0) {
+        throw std::system_error(errno, std::generic_category(), "setsockopt(SO_ATTACH_REUSEPORT_CBPF) failed");
+    }
+#else
+    throw std::system_error(
+        std::make_error_code(std::errc::operation_not_supported), "SO_ATTACH_REUSEPORT_CBPF is not supported"
+    );
+#endif
+}
+
+/**
+ * Accepts a connection on @a fd; the accepted socket is non-blocking and close-on-exec.
+ * Returns the accepted socket, or -1 with `errno` set. Does not throw.
+ */
+int accept_socket(int fd, sockaddr_storage& addr, socklen_t& len) noexcept
+{
+    int res{};
+    do {
+        len = sizeof(addr);
+#if defined(SOCK_NONBLOCK) && defined(SOCK_CLOEXEC)
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        res = accept4(fd, reinterpret_cast<sockaddr*>(&addr), &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        res = accept(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+#endif
+    } while (res == -1 && errno == EINTR);
+
+#if !defined(SOCK_NONBLOCK) || !defined(SOCK_CLOEXEC)
+    if (res != -1) {
+        const auto flags = fcntl(res, F_GETFL, 0);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+        if (flags == -1 || fcntl(res, F_SETFL, static_cast<unsigned int>(flags) | O_NONBLOCK) != 0 ||
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+            fcntl(res, F_SETFD, FD_CLOEXEC) != 0) [[unlikely]] {
+            const auto err = errno;
+            close(res);
+            errno = err;
+            return -1;
+        }
+    }
+#endif
+
+    return res;
+}
+
+/**
+ * accept_socket() which records the call in the accept metrics when they are enabled.
+ */
+int accept_nonblocking(int fd, sockaddr_storage& addr, socklen_t& len) noexcept
+{
+    if (psb::detail::metrics_enabled.load(std::memory_order_relaxed)) [[unlikely]] {
+        const auto start = std::chrono::steady_clock::now();
+        const auto res   = accept_socket(fd, addr, len);
+        psb::detail::record_accept(res == -1 ? errno : 0, std::chrono::steady_clock::now() - start);
+        return res;
+    }
+
+    return accept_socket(fd, addr, len);
+}
+
+/**
+ * Accepts up to @a limit connections on @a fd and hands each of them over to @a store along with its index.
+ */
+template<typename Store>
+psb::accept_batch_result_t accept_batch(int fd, std::size_t limit, Store&& store)
+{
+    psb::accept_batch_result_t result{};
+
+    while (result.count < limit) {
+        psb::raw_accepted_socket_t raw{};
+        raw.sock = accept_nonblocking(fd, raw.addr, raw.addr_len);
+
+        if (raw.sock == -1) {
+            const auto err = errno;
+            if (err == ECONNABORTED || err == EPROTO) {
+                // The peer has gone away before we got to it; the rest of the queue is still good.
+                continue;
+            }
+
+            if (err != EAGAIN && err != EWOULDBLOCK) {
+                result.error = std::error_code(err, std::system_category());
+            }
+
+            break;
+        }
+
+        store(result.count, raw);
+        ++result.count;
+    }
+
+    return result;
+}
+
 psb::socket_info_t make_peer(std::string_view address, uint16_t port)
 {
     return {.address = {address.data(), address.size()}, .port = port};
 }
 
+std::uint16_t get_port(const sockaddr_storage& ss, socklen_t len) noexcept
+{
+    if (ss.ss_family == AF_INET && len >= sizeof(sockaddr_in)) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return ntohs(reinterpret_cast<const sockaddr_in&>(ss).sin_port);
+    }
+
+    if (ss.ss_family == AF_INET6 && len >= sizeof(sockaddr_in6)) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return ntohs(reinterpret_cast<const sockaddr_in6&>(ss).sin6_port);
+    }
+
+    return 0;
+}
+
+/**
+ * Converts an IPv4-mapped IPv6 address (`::ffff:a.b.c.d`) in @a ss into its IPv4 form in @a v4 and updates @a len.
+ *
+ * @return @a v4 if the address was converted, @a ss otherwise.
+ */
+const sockaddr_storage& unmap_ipv4(const sockaddr_storage& ss, socklen_t& len, sockaddr_storage& v4) noexcept
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto& sin6 = reinterpret_cast<const sockaddr_in6&>(ss);
+    if (ss.ss_family != AF_INET6 || len < sizeof(sockaddr_in6) || !IN6_IS_ADDR_V4MAPPED(&sin6.sin6_addr)) {
+        return ss;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto& sin      = reinterpret_cast<sockaddr_in&>(v4);
+    sin.sin_family = AF_INET;
+    sin.sin_port   = sin6.sin6_port;
+    std::memcpy(&sin.sin_addr, &sin6.sin6_addr.s6_addr[12], sizeof(in_addr));
+    len = sizeof(sockaddr_in);
+    return v4;
+}
+
+struct set_entry_t {
+    sockaddr_storage ss;
+    socklen_t len;
+    std::size_t index;  // Index of the address in the set
+    bool dual_stack;    // An IPv6 wildcard address, which serves IPv4 in dual-stack mode
+};
+
+/**
+ * Parses the addresses of a listener set into @a entries, leaving out the IPv4 addresses served by dual-stack sockets;
+ * on failure, sets @a failed to the index of the invalid address.
+ */
+bool parse_listener_set(
+    std::span<const psb::listen_address_t> addresses, bool dual_stack, std::vector<set_entry_t>& entries,
+    std::error_code& ec, std::size_t& failed
+)
+{
+    entries.reserve(addresses.size());
+    for (std::size_t i = 0; i < addresses.size(); ++i) {
+        const auto& addr = addresses[i];
+        set_entry_t entry{.ss = {}, .len = {}, .index = i, .dual_stack = false};
+        if (const auto res = psb::make_socket_address(addr.address, addr.port, entry.ss, entry.len); res != std::errc{})
+            [[unlikely]] {
+            ec     = std::make_error_code(res);
+            failed = i;
+            return false;
+        }
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        const auto& sin6 = reinterpret_cast<const sockaddr_in6&>(entry.ss);
+        entry.dual_stack = entry.ss.ss_family == AF_INET6 && IN6_IS_ADDR_UNSPECIFIED(&sin6.sin6_addr);
+        entries.push_back(entry);
+    }
+
+    if (dual_stack) {
+        std::vector<std::uint16_t> dual_stack_ports;
+        for (const auto& entry : entries) {
+            if (entry.dual_stack) {
+                dual_stack_ports.push_back(get_port(entry.ss, entry.len));
+            }
+        }
+
+        std::erase_if(entries, [&dual_stack_ports](const set_entry_t& entry) {
+            return entry.ss.ss_family == AF_INET &&
+                   std::ranges::find(dual_stack_ports, get_port(entry.ss, entry.len)) != dual_stack_ports.end();
+        });
+    }
+
+    return true;
+}
+
+/**
+ * Creates the sockets of a listener set; on failure, closes those already created and sets @a failed to the index
+ * of the entry which failed.
+ */
+std::vector<psb::set_listener_t> create_set_sockets(
+    std::span<const set_entry_t> entries, const psb::socket_options_t& opts, bool dual_stack, std::error_code& ec,
+    std::size_t& failed
+)
+{
+    std::vector<psb::set_listener_t> sockets;
+    sockets.reserve(entries.size());
+    for (const auto& entry : entries) {
+        auto entry_opts    = opts;
+        entry_opts.v6_only = dual_stack && entry.dual_stack ? -1 : 1;
+
+        const auto ls = psb::create_listening_socket(entry.ss, entry.len, entry_opts, ec);
+        if (ec) [[unlikely]] {
+            failed = sockets.size();
+            for (const auto& created : sockets) {
+                close(created.listener.sock);
+            }
+
+            return {};
+        }
+
+        sockets.push_back({.listener = ls, .index = entry.index});
+    }
+
+    return sockets;
+}
+
+using ipv4_bytes_t = std::array<std::uint8_t, sizeof(in_addr)>;
+using ipv6_bytes_t = std::array<std::uint8_t, sizeof(in6_addr)>;
+
+/**
+ * Decimal representation of every octet value: up to three digits followed by the number of digits.
+ */
+constexpr auto decimal_octets = []() {
+    std::array<std::array<char, 4>, 256> table{};
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        auto& entry         = table.at(i);
+        const auto hundreds = static_cast<char>('0' + i / 100);
+        const auto tens     = static_cast<char>('0' + (i / 10) % 10);
+        const auto ones     = static_cast<char>('0' + i % 10);
+
+        if (i >= 100) {
+            entry = {hundreds, tens, ones, 3};
+        }
+        else if (i >= 10) {
+            entry = {tens, ones, 0, 2};
+        }
+        else {
+            entry = {ones, 0, 0, 1};
+        }
+    }
+
+    return table;
+}();
+
+/**
+ * Writes the dotted-decimal form of @a octets into @a out starting at @a pos; returns the new position.
+ * @a out must have room for `INET_ADDRSTRLEN - 1` characters after @a pos.
+ */
+std::size_t write_ipv4(std::span<const std::uint8_t, sizeof(in_addr)> octets, std::span<char> out, std::size_t pos)
+{
+    for (std::size_t i = 0; i < octets.size(); ++i) {
+        if (i != 0) {
+            out[pos++] = '.';
+        }
+
+        // Always copy three characters: the buffer is large enough, and a fixed-size copy beats a variable-size one.
+        const auto& entry = decimal_octets[octets[i]];
+        out[pos]          = entry[0];
+        out[pos + 1]      = entry[1];
+        out[pos + 2]      = entry[2];
+        pos += static_cast<std::size_t>(entry[3]);
+    }
+
+    return pos;
+}
+
+/**
+ * Writes the RFC 5952 text form of @a bytes into @a out; returns the number of characters written.
+ * The output is byte-for-byte identical to that of glibc's `inet_ntop()`: the longest run of two or more zero
+ * groups (the first one on a tie) is compressed, and IPv4-mapped / IPv4-compatible addresses keep the dotted quad.
+ * @a out must have room for `INET6_ADDRSTRLEN - 1` characters.
+ */
+std::size_t write_ipv6(const ipv6_bytes_t& bytes, std::span<char> out)
+{
+    constexpr std::size_t groups          = 8;
+    constexpr std::string_view hex_digits = "0123456789abcdef";
+
+    std::array<unsigned int, groups> words{};
+    for (std::size_t i = 0; i < groups; ++i) {
+        words[i] = (static_cast<unsigned int>(bytes[2 * i]) << 8U) | bytes[2 * i + 1];
+    }
+
+    std::size_t best_base = groups;
+    std::size_t best_len  = 0;
+    for (std::size_t i = 0; i < groups;) {
+        if (words[i] != 0) {
+            ++i;
+            continue;
+        }
+
+        const auto base = i;
+        while (i < groups && words[i] == 0) {
+            ++i;
+        }
+
+        if (i - base > best_len) {
+            best_base = base;
+            best_len  = i - base;
+        }
+    }
+
+    if (best_len < 2) {
+        best_base = groups;
+        best_len  = 0;
+    }
+
+    std::size_t pos = 0;
+    for (std::size_t i = 0; i < groups; ++i) {
+        if (i == best_base) {
+            out[pos++] = ':';
+            i += best_len - 1;
+            if (i == groups - 1) {
+                out[pos++] = ':';
+            }
+
+            continue;
+        }
+
+        if (i != 0) {
+            out[pos++] = ':';
+        }
+
+        if (i == 6 && best_base == 0 && (best_len == 6 || (best_len == 5 && words[5] == 0xFFFFU))) {
+            return write_ipv4(std::span(bytes).last<sizeof(in_addr)>(), out, pos);
+        }
+
+        const auto word = words[i];
+        for (unsigned int shift = word > 0xFFFU ? 12U : word > 0xFFU ? 8U : word > 0xFU ? 4U : 0U;; shift -= 4U) {
+            out[pos++] = hex_digits[(word >> shift) & 0xFU];
+            if (shift == 0) {
+                break;
+            }
+        }
+    }
+
+    return pos;
+}
+
+/**
+ * Writes `address:port` (`[address]:port` for IPv6 addresses, or just `address` if @a port is zero) into @a buf.
+ */
+std::string_view write_peer(std::string_view address, bool is_ipv6, std::uint16_t port, psb::peer_buffer_t& buf)
+{
+    std::format_to_n_result<char*> res{};
+    if (port == 0) {
+        res = std::format_to_n(buf.data(), buf.size(), "{}", address);
+    }
+    else if (is_ipv6) {
+        res = std::format_to_n(buf.data(), buf.size(), "[{}]:{}", address, port);
+    }
+    else {
+        res = std::format_to_n(buf.data(), buf.size(), "{}:{}", address, port);
+    }
+
+    return {buf.data(), std::min(static_cast<std::size_t>(res.size), buf.size())};
+}
+
 }  // namespace
 
 namespace psb {
 
-void make_nonblocking(int fd)
+void make_nonblocking(int fd, std::error_code& ec) noexcept
 {
+    ec.clear();
     if (auto flags = fcntl(fd, F_GETFL, 0); flags != -1) {
         // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
         if (const auto res = fcntl(fd, F_SETFL, static_cast<unsigned int>(flags) | O_NONBLOCK); res != 0) [[unlikely]] {
-            throw std::system_error(errno, std::generic_category(), "fcntl(F_SETFL) failed");
+            ec.assign(errno, std::generic_category());
         }
     }
     else {
-        throw std::system_error(errno, std::generic_category(), "fcntl(F_GETFL) failed");
+        ec.assign(errno, std::generic_category());
     }
 }
 
-void make_close_on_exec(int fd)
+void make_nonblocking(int fd)
 {
+    std::error_code ec;
+    make_nonblocking(fd, ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, "fcntl(O_NONBLOCK) failed");
+    }
+}
+
+void make_close_on_exec(int fd, std::error_code& ec) noexcept
+{
+    ec.clear();
     if (auto flags = fcntl(fd, F_GETFD, 0); flags != -1) {
         // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
         if (const auto res = fcntl(fd, F_SETFD, static_cast<unsigned int>(flags) | FD_CLOEXEC); res != 0) [[unlikely]] {
-            throw std::system_error(errno, std::generic_category(), "fcntl(F_SETFD) failed");
+            ec.assign(errno, std::generic_category());
         }
     }
     else {
-        throw std::system_error(errno, std::generic_category(), "fcntl(F_GETFD) failed");
+        ec.assign(errno, std::generic_category());
     }
 }
 
-void set_socket_option(int sock, int level, int optname, int optval, std::string_view name)
+void make_close_on_exec(int fd)
+{
+    std::error_code ec;
+    make_close_on_exec(fd, ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, "fcntl(FD_CLOEXEC) failed");
+    }
+}
+
+void set_socket_option(int sock, int level, int optname, int optval, std::error_code& ec) noexcept
 {
+    ec.clear();
     if (const auto res = setsockopt(sock, level, optname, &optval, sizeof(optval)); res != 0) {
         const auto err = errno;
         // Ignore unsupported options
         if (err != ENOPROTOOPT) {
-            throw std::system_error(err, std::generic_category(), std::format("setsockopt({}) failed", name));
+            ec.assign(err, std::generic_category());
         }
     }
 }
 
-void bind_socket(int sock, const std::string& address, std::uint16_t port)
+void set_socket_option(int sock, int level, int optname, int optval, std::string_view name)
 {
-    if (address.find(':') != std::string::npos) {
-        bind_ipv6(sock, address, port);
+    std::error_code ec;
+    set_socket_option(sock, level, optname, optval, ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, std::format("setsockopt({}) failed", name));
     }
-    else {
-        bind_ipv4(sock, address, port);
+}
+
+void set_accepted_socket_options(int sock, const socket_options_t& opts, std::error_code& ec) noexcept
+{
+    ec.clear();
+
+#if defined(TCP_QUICKACK)
+    if (opts.quick_ack != 0) {
+        set_socket_option(sock, IPPROTO_TCP, TCP_QUICKACK, opts.quick_ack, ec);
     }
+#endif
 }
 
-listening_socket_t create_listening_socket(const std::string& address, std::uint16_t port, const socket_options_t& opts)
+void set_accepted_socket_options(int sock, const socket_options_t& opts)
 {
-    const auto is_ipv6 = address.find(':') != std::string::npos;
-    const auto sock    = socket(is_ipv6 ? AF_INET6 : AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    std::error_code ec;
+    set_accepted_socket_options(sock, opts, ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, "setsockopt(TCP_QUICKACK) failed");
+    }
+}
 
-    if (sock < 0) [[unlikely]] {
-        throw std::system_error(errno, std::generic_category(), "socket() failed");
+std::errc
+make_socket_address(std::string_view address, std::uint16_t port, sockaddr_storage& ss, socklen_t& len) noexcept
+{
+    ss = {};
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto& sin = reinterpret_cast<sockaddr_in&>(ss);
+    if (parse_ipv4(address, sin.sin_addr) == std::errc{}) {
+        sin.sin_family = AF_INET;
+        sin.sin_port   = htons(port);
+        len            = sizeof(sin);
+        return {};
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto& sin6 = reinterpret_cast<sockaddr_in6&>(ss);
+    if (parse_ipv6(address, sin6.sin6_addr) == std::errc{}) {
+        sin6.sin6_family = AF_INET6;
+        sin6.sin6_port   = htons(port);
+        len              = sizeof(sin6);
+        return {};
     }
 
-    const close_on_error closer(sock);
-    make_nonblocking(sock);
-    handle_socket_options(sock, opts);
-    bind_socket(sock, address, port);
+    if (!address.empty() && (address.front() == '/' || address.front() == '@')) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        auto& sun = reinterpret_cast<sockaddr_un&>(ss);
+        const auto is_abstract = address.front() == '@';
+        // A path needs room for its terminating NUL; an abstract name is not NUL-terminated
+        if (address.size() + (is_abstract ? 0 : 1) > sizeof(sun.sun_path)) [[unlikely]] {
+            return std::errc::filename_too_long;
+        }
 
-    if (const auto res = listen(sock, opts.listen_backlog); res == -1) {
-        throw std::system_error(errno, std::generic_category(), "listen() failed");
+        sun.sun_family = AF_UNIX;
+        std::ranges::copy(address, static_cast<char*>(sun.sun_path));
+        if (is_abstract) {
+            sun.sun_path[0] = '\0';
+        }
+
+        len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + address.size() + (is_abstract ? 0 : 1));
+        return {};
     }
 
-    using namespace opentelemetry::semconv::network::NetworkTransportValues;
-    using namespace opentelemetry::semconv::network::NetworkTypeValues;
+    return std::errc::invalid_argument;
+}
 
-    return {.sock = sock, .transport = kTcp, .type = is_ipv6 ? kIpv6 : kIpv4};
+void bind_socket(int sock, std::string_view address, std::uint16_t port, std::error_code& ec) noexcept
+{
+    ec.clear();
+
+    sockaddr_storage ss{};
+    socklen_t len{};
+    if (const auto res = make_socket_address(address, port, ss, len); res != std::errc{}) [[unlikely]] {
+        ec = std::make_error_code(res);
+        return;
+    }
+
+    bind_address(sock, ss, len, ec);
 }
 
-socket_info_t get_socket_info(const sockaddr_storage& ss, socklen_t len)
+void bind_socket(int sock, std::string_view address, std::uint16_t port)
 {
-    if (len > sizeof(sa_family_t)) {
-        std::array<char, INET6_ADDRSTRLEN> buf{};
+    sockaddr_storage ss{};
+    const auto len = parse_socket_address(address, port, ss);
+
+    std::error_code ec;
+    bind_address(sock, ss, len, ec);
+    if (ec) [[unlikely]] {
+        throw_bind_error(ec, ss, len);
+    }
+}
+
+listening_socket_t create_listening_socket(
+    std::string_view address, std::uint16_t port, const socket_options_t& opts, std::error_code& ec
+) noexcept
+{
+    sockaddr_storage ss{};
+    socklen_t len{};
+    if (const auto res = make_socket_address(address, port, ss, len); res != std::errc{}) [[unlikely]] {
+        ec = std::make_error_code(res);
+        return {.sock = -1};
+    }
+
+    return create_listening_socket(ss, len, opts, ec);
+}
+
+listening_socket_t create_listening_socket(std::string_view address, std::uint16_t port, const socket_options_t& opts)
+{
+    sockaddr_storage ss{};
+    const auto len = parse_socket_address(address, port, ss);
+    return create_listening_socket(ss, len, opts);
+}
+
+listening_socket_t create_listening_socket(const sockaddr_in& addr, const socket_options_t& opts)
+{
+    sockaddr_storage ss{};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    reinterpret_cast<sockaddr_in&>(ss) = addr;
+    return create_listening_socket(ss, sizeof(addr), opts);
+}
+
+listening_socket_t create_listening_socket(const sockaddr_in6& addr, const socket_options_t& opts)
+{
+    sockaddr_storage ss{};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    reinterpret_cast<sockaddr_in6&>(ss) = addr;
+    return create_listening_socket(ss, sizeof(addr), opts);
+}
+
+listening_socket_t create_listening_socket(
+    const sockaddr_storage& ss, socklen_t len, const socket_options_t& opts, std::error_code& ec
+) noexcept
+{
+    const char* what{};
+    return create_listener(ss, len, opts, ec, what);
+}
+
+listening_socket_t create_listening_socket(const sockaddr_storage& ss, socklen_t len, const socket_options_t& opts)
+{
+    std::error_code ec;
+    const char* what{};
+    const auto result = create_listener(ss, len, opts, ec, what);
+    if (ec) [[unlikely]] {
+        throw_step_error(ec, what, ss, len);
+    }
+
+    return result;
+}
+
+listening_socket_t create_udp_socket(
+    const sockaddr_storage& ss, socklen_t len, const socket_options_t& opts, std::error_code& ec
+) noexcept
+{
+    const char* what{};
+    return create_udp(ss, len, opts, ec, what);
+}
+
+listening_socket_t create_udp_socket(
+    std::string_view address, std::uint16_t port, const socket_options_t& opts, std::error_code& ec
+) noexcept
+{
+    sockaddr_storage ss{};
+    socklen_t len{};
+    if (const auto res = make_socket_address(address, port, ss, len); res != std::errc{}) [[unlikely]] {
+        ec = std::make_error_code(res);
+        return {.sock = -1};
+    }
+
+    return create_udp_socket(ss, len, opts, ec);
+}
+
+listening_socket_t create_udp_socket(std::string_view address, std::uint16_t port, const socket_options_t& opts)
+{
+    sockaddr_storage ss{};
+    const auto len = parse_socket_address(address, port, ss);
+
+    std::error_code ec;
+    const char* what{};
+    const auto result = create_udp(ss, len, opts, ec, what);
+    if (ec) [[unlikely]] {
+        throw_step_error(ec, what, ss, len);
+    }
 
+    return result;
+}
+
+std::string_view format_address(const sockaddr_storage& ss, socklen_t len, address_buffer_t& buf) noexcept
+{
+    const std::span<char> out(buf);
+
+    if (len > sizeof(sa_family_t)) {
         if (ss.ss_family == AF_INET && len >= sizeof(sockaddr_in)) {
             // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
             const auto& addr = reinterpret_cast<const sockaddr_in&>(ss);
-            if (inet_ntop(ss.ss_family, &addr.sin_addr, buf.data(), buf.size()) != nullptr) [[likely]] {
-                return make_peer(buf.data(), ntohs(addr.sin_port));
-            }
+            return {buf.data(), write_ipv4(std::bit_cast<ipv4_bytes_t>(addr.sin_addr), out, 0)};
         }
-        else if (ss.ss_family == AF_INET6 && len >= sizeof(sockaddr_in6)) {
+
+        if (ss.ss_family == AF_INET6 && len >= sizeof(sockaddr_in6)) {
             // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
             const auto& addr = reinterpret_cast<const sockaddr_in6&>(ss);
-            if (inet_ntop(ss.ss_family, &addr.sin6_addr, buf.data(), buf.size()) != nullptr) [[likely]] {
-                return make_peer(buf.data(), ntohs(addr.sin6_port));
-            }
+            return {buf.data(), write_ipv6(std::bit_cast<ipv6_bytes_t>(addr.sin6_addr), out)};
         }
-        else if (ss.ss_family == AF_UNIX && len >= offsetof(sockaddr_un, sun_path)) {
+
+        if (ss.ss_family == AF_UNIX && len >= offsetof(sockaddr_un, sun_path)) {
             // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
             const auto& addr        = reinterpret_cast<const sockaddr_un&>(ss);
             const auto raw_name_len = static_cast<socklen_t>(len - offsetof(sockaddr_un, sun_path));
             const auto name_len_with_prefix =
                 std::min<socklen_t>(raw_name_len, static_cast<socklen_t>(sizeof(addr.sun_path)));
+            const std::string_view raw_path(&addr.sun_path[0], name_len_with_prefix);
 
-            if (addr.sun_path[0] == '\0') {
+            std::string_view name;
+            if (!raw_path.empty() && raw_path.front() == '\0') {
                 // Abstract UNIX socket; name starts after the leading NUL and may be empty.
-                if (name_len_with_prefix > 1) {
-#pragma clang unsafe_buffer_usage begin
-                    const std::string_view abstract_socket_name(
-                        &addr.sun_path[1], static_cast<std::size_t>(name_len_with_prefix - 1)
-                    );
-#pragma clang unsafe_buffer_usage end
-                    return make_peer(abstract_socket_name, 0);
-                }
+                name = raw_path.substr(1);
             }
             else {
-                const std::string_view raw_path(&addr.sun_path[0], name_len_with_prefix);
-                const auto* terminator = std::ranges::find(raw_path, '\0');
-                const auto path_len    = static_cast<std::size_t>(std::distance(raw_path.begin(), terminator));
-                return make_peer(std::string_view(raw_path.begin(), path_len), 0);
+                name = raw_path.substr(0, raw_path.find('\0'));
             }
+
+            return {buf.data(), static_cast<std::size_t>(std::ranges::copy(name, buf.begin()).out - buf.begin())};
         }
     }
 
     return {};
 }
 
-void inet_pton(const std::string& address, in_addr& dst)
+std::vector<listening_socket_t> create_listening_group(
+    std::string_view address, std::uint16_t port, const socket_options_t& opts, std::size_t count, bool steer_by_cpu
+)
 {
-    const auto res = inet_pton(AF_INET, address.c_str(), &dst);
-    if (res == 0) [[unlikely]] {
-        throw std::invalid_argument("Invalid IPv4 address: " + address);
+    sockaddr_storage ss{};
+    auto len = parse_socket_address(address, port, ss);
+
+    auto group_opts       = opts;
+    group_opts.reuse_port = 1;
+
+    std::vector<listening_socket_t> group;
+    group.reserve(count);
+
+    try {
+        for (std::size_t i = 0; i < count; ++i) {
+            group.push_back(create_listening_socket(ss, len, group_opts));
+
+            if (i == 0 && port == 0) {
+                // The rest of the group has to join the port the kernel has picked for the first socket
+                len = sizeof(ss);
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                if (getsockname(group.front().sock, reinterpret_cast<sockaddr*>(&ss), &len) != 0) {
+                    throw std::system_error(errno, std::generic_category(), "getsockname() failed");
+                }
+            }
+        }
+
+        if (steer_by_cpu && !group.empty()) {
+            attach_cpu_steering(group.front().sock, count);
+        }
     }
+    catch (...) {
+        for (const auto& ls : group) {
+            close(ls.sock);
+        }
 
-    if (res != 1) [[unlikely]] {  // EAFNOSUPPORT case
-        const auto err = errno;
-        throw std::system_error(err, std::generic_category(), std::format("inet_pton(AF_INET, {})", address));
+        throw;
     }
+
+    return group;
 }
 
-void inet_pton(const std::string& address, in6_addr& dst)
+std::vector<set_listener_t> create_listener_set(
+    std::span<const listen_address_t> addresses, const socket_options_t& opts, bool dual_stack, std::error_code& ec
+)
 {
-    const auto res = inet_pton(AF_INET6, address.c_str(), &dst);
-    if (res == 0) [[unlikely]] {
-        throw std::invalid_argument("Invalid IPv6 address: " + address);
+    ec.clear();
+
+    std::size_t failed{};
+    std::vector<set_entry_t> entries;
+    if (!parse_listener_set(addresses, dual_stack, entries, ec, failed)) [[unlikely]] {
+        return {};
     }
 
-    if (res != 1) [[unlikely]] {  // EAFNOSUPPORT case
-        const auto err = errno;
-        throw std::system_error(err, std::generic_category(), std::format("inet_pton(AF_INET6, {})", address));
+    return create_set_sockets(entries, opts, dual_stack, ec, failed);
+}
+
+std::vector<set_listener_t>
+create_listener_set(std::span<const listen_address_t> addresses, const socket_options_t& opts, bool dual_stack)
+{
+    std::error_code ec;
+    std::size_t failed{};
+    std::vector<set_entry_t> entries;
+    if (!parse_listener_set(addresses, dual_stack, entries, ec, failed)) [[unlikely]] {
+        throw std::invalid_argument(std::format("Invalid address: {}", addresses[failed].address));
     }
+
+    auto result = create_set_sockets(entries, opts, dual_stack, ec, failed);
+    if (ec) [[unlikely]] {
+        const auto info = get_socket_info(entries[failed].ss, entries[failed].len);
+        throw std::system_error(ec, std::format("create_listener_set({}) failed", info));
+    }
+
+    return result;
 }
 
-accepted_socket_t accept_connection(int fd)
+int get_max_listen_backlog(std::error_code& ec) noexcept
 {
-    sockaddr_storage addr{};
-    socklen_t len = sizeof(addr);
-    int res{};
+    ec.clear();
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    const auto fd = open("/proc/sys/net/core/somaxconn", O_RDONLY | O_CLOEXEC);
+    if (fd == -1) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
+        return -1;
+    }
+
+    std::array<char, 16> buf{};
+    ssize_t res{};
     do {
-        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-        res = accept(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+        res = read(fd, buf.data(), buf.size());
     } while (res == -1 && errno == EINTR);
 
     if (res == -1) [[unlikely]] {
-        throw std::system_error(errno, std::system_category(), "accept");
+        ec.assign(errno, std::generic_category());
+    }
+
+    close(fd);
+
+    int value = -1;
+    if (!ec) {
+        const auto* end       = std::next(buf.data(), res);
+        const auto [ptr, err] = std::from_chars(buf.data(), end, value);
+        if (err != std::errc{} || value < 0) [[unlikely]] {
+            ec    = std::make_error_code(std::errc::invalid_argument);
+            value = -1;
+        }
+    }
+
+    return value;
+}
+
+int get_max_listen_backlog()
+{
+    std::error_code ec;
+    const auto result = get_max_listen_backlog(ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, "read(/proc/sys/net/core/somaxconn) failed");
+    }
+
+    return result;
+}
+
+listen_queue_t get_listen_queue(int sock, std::error_code& ec) noexcept
+{
+    ec.clear();
+
+    tcp_info info{};
+    socklen_t len = sizeof(info);
+    if (getsockopt(sock, IPPROTO_TCP, TCP_INFO, &info, &len) == -1) [[unlikely]] {
+        ec.assign(errno, std::generic_category());
+        return {};
+    }
+
+    if (info.tcpi_state != TCP_LISTEN) [[unlikely]] {
+        ec = std::make_error_code(std::errc::invalid_argument);
+        return {};
+    }
+
+    return {.length = info.tcpi_unacked, .max_length = info.tcpi_sacked};
+}
+
+listen_queue_t get_listen_queue(int sock)
+{
+    std::error_code ec;
+    const auto result = get_listen_queue(sock, ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, "getsockopt(TCP_INFO) failed");
     }
 
-    const close_on_error closer(res);
-    make_nonblocking(res);
-    make_close_on_exec(res);
+    return result;
+}
+
+socket_info_t get_socket_info(const sockaddr_storage& ss, socklen_t len)
+{
+    address_buffer_t buf;  // NOLINT(cppcoreguidelines-pro-type-member-init,hicpp-member-init)
+
+    sockaddr_storage v4{};
+    const auto& addr = unmap_ipv4(ss, len, v4);
+    return make_peer(format_address(addr, len, buf), get_port(addr, len));
+}
+
+socket_info_t get_socket_info(const raw_accepted_socket_t& sock)
+{
+    return get_socket_info(sock.addr, std::min(sock.addr_len, static_cast<socklen_t>(sizeof(sock.addr))));
+}
+
+std::string_view format_peer(const socket_info_t& info, peer_buffer_t& buf) noexcept
+{
+    return write_peer(info.address, info.address.find(':') != std::string::npos, info.port, buf);
+}
 
-    const auto info = get_socket_info(addr, std::min(len, static_cast<socklen_t>(sizeof(addr))));
-    return {.sock = res, .address = info.address, .port = info.port};
+std::string_view format_peer(const raw_accepted_socket_t& sock, peer_buffer_t& buf) noexcept
+{
+    auto len = std::min(sock.addr_len, static_cast<socklen_t>(sizeof(sock.addr)));
+    sockaddr_storage v4{};
+    const auto& addr = unmap_ipv4(sock.addr, len, v4);
+
+    address_buffer_t address;  // NOLINT(cppcoreguidelines-pro-type-member-init,hicpp-member-init)
+    const auto formatted = format_address(addr, len, address);
+    return write_peer(formatted, addr.ss_family == AF_INET6, get_port(addr, len), buf);
+}
+
+void inet_pton(std::string_view address, in_addr& dst)
+{
+    if (parse_ipv4(address, dst) != std::errc{}) [[unlikely]] {
+        throw std::invalid_argument(std::format("Invalid IPv4 address: {}", address));
+    }
+}
+
+void inet_pton(std::string_view address, in6_addr& dst)
+{
+    if (parse_ipv6(address, dst) != std::errc{}) [[unlikely]] {
+        throw std::invalid_argument(std::format("Invalid IPv6 address: {}", address));
+    }
+}
+
+accepted_socket_t accept_connection(int fd, std::error_code& ec)
+{
+    const auto raw = accept_raw_connection(fd, ec);
+    if (ec) {
+        return {.sock = -1, .address = {}, .port = {}};
+    }
+
+    const close_on_error closer(raw.sock);
+
+    auto info = get_socket_info(raw);
+    return {.sock = raw.sock, .address = std::move(info.address), .port = info.port};
+}
+
+accepted_socket_t accept_connection(int fd)
+{
+    std::error_code ec;
+    auto result = accept_connection(fd, ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, "accept");
+    }
+
+    return result;
+}
+
+accept_batch_result_t accept_connections(int fd, std::span<accepted_socket_t> sockets, std::size_t budget)
+{
+    const auto store = [sockets](std::size_t idx, const raw_accepted_socket_t& raw) {
+        const close_on_error closer(raw.sock);
+
+        auto info    = get_socket_info(raw);
+        sockets[idx] = {.sock = raw.sock, .address = std::move(info.address), .port = info.port};
+    };
+
+    return accept_batch(fd, std::min(sockets.size(), budget), store);
+}
+
+raw_accepted_socket_t accept_raw_connection(int fd, std::error_code& ec) noexcept
+{
+    ec.clear();
+
+    raw_accepted_socket_t result{};
+    result.sock = accept_nonblocking(fd, result.addr, result.addr_len);
+
+    if (result.sock == -1) [[unlikely]] {
+        ec.assign(errno, std::system_category());
+    }
+
+    return result;
+}
+
+raw_accepted_socket_t accept_raw_connection(int fd)
+{
+    std::error_code ec;
+    const auto result = accept_raw_connection(fd, ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, "accept");
+    }
+
+    return result;
+}
+
+accept_batch_result_t accept_connections(int fd, std::span<raw_accepted_socket_t> sockets, std::size_t budget)
+{
+    const auto store = [sockets](std::size_t idx, const raw_accepted_socket_t& raw) { sockets[idx] = raw; };
+    return accept_batch(fd, std::min(sockets.size(), budget), store);
 }
 
 }  // namespace psb
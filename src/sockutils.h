@@ -1,29 +1,92 @@
 #ifndef C4E7C8D4_DF90_421A_BAC2_E1BE5862ABBE
 #define C4E7C8D4_DF90_421A_BAC2_E1BE5862ABBE
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <format>
+#include <span>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
 
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <sys/un.h>
 
 #include "export.h"
+#include "parse_address.h"
 
 namespace psb {
 
+/// Maximum length of an address produced by `format_address()`: an IPv6 address or a UNIX socket path.
+inline constexpr std::size_t max_address_length = sizeof(sockaddr_un::sun_path);
+/// Maximum length of a peer produced by `format_peer()`: `[address]:port`.
+inline constexpr std::size_t max_peer_length = max_address_length + sizeof("[]:65535") - 1;
+
+using address_buffer_t = std::array<char, max_address_length>;
+using peer_buffer_t    = std::array<char, max_peer_length>;
+
+/// Value of `socket_options_t::listen_backlog` which selects the largest backlog allowed (`net.core.somaxconn`).
+inline constexpr int listen_backlog_auto = -1;
+
+/**
+ * Options for listening sockets; zero leaves the system default in place.
+ *
+ * Linux copies the options marked "inherited" from the listening socket to every socket accepted on it, so they are
+ * set once on the listener by `create_listening_socket()` and cost nothing per connection. The remaining
+ * per-connection option (`quick_ack`) is not inherited: `accept_connection()` and `accept_connections()` do not
+ * set it, so call `set_accepted_socket_options()` on each accepted socket; `epoll_acceptor` and `uring_acceptor`
+ * do that themselves when given the options.
+ */
 struct socket_options_t {
     int close_on_exec;
     int reuse_addr;
     int free_bind;
     int defer_accept_timeout;
-    int listen_backlog;
+    int listen_backlog;    // listen() backlog, or listen_backlog_auto
+    int reuse_port{};      // SO_REUSEPORT; always enabled by create_listening_group()
+    int no_delay{};        // TCP_NODELAY; inherited
+    int keep_alive{};      // SO_KEEPALIVE; inherited
+    int keep_idle{};       // TCP_KEEPIDLE, seconds; inherited
+    int keep_interval{};   // TCP_KEEPINTVL, seconds; inherited
+    int keep_count{};      // TCP_KEEPCNT; inherited
+    int user_timeout{};    // TCP_USER_TIMEOUT, milliseconds; inherited
+    int notsent_lowat{};   // TCP_NOTSENT_LOWAT, bytes; inherited
+    int receive_buffer{};  // SO_RCVBUF, bytes; inherited (set before listen() so that the window scale matches)
+    int send_buffer{};     // SO_SNDBUF, bytes; inherited
+    int fastopen_queue{};  // TCP_FASTOPEN, maximum number of pending TFO requests; listener only
+    int quick_ack{};       // TCP_QUICKACK; not inherited, does nothing unless set_accepted_socket_options() is called
+    int strict_backlog{};  // Fail with EINVAL instead of letting the kernel clamp listen_backlog to somaxconn
+    int seqpacket{};       // UNIX sockets: SOCK_SEQPACKET instead of SOCK_STREAM
+    int unix_mode{};       // UNIX sockets: permissions of the socket file, e.g., 0660
+    int unlink_stale{};    // UNIX sockets: remove the socket file left behind by a listener which no longer exists
+    int v6_only{};         // IPv6 sockets: 1 for IPv6 only, -1 for dual-stack (IPV6_V6ONLY); 0 keeps bindv6only
 };
 
 struct listening_socket_t {
     int sock{};
     const char* transport{};  // opentelemetry::semconv::network::NetworkTransportValues; e.g., kTcp
-    const char* type{};       // opentelemetry::semconv::network::NetworkTypeValues; e.g., kIpv4
+    const char* type{};       // opentelemetry::semconv::network::NetworkTypeValues; e.g., kIpv4; nullptr for kUnix
+};
+
+struct listen_queue_t {
+    std::uint32_t length{};      // Connections waiting in the accept queue
+    std::uint32_t max_length{};  // Effective backlog: the requested one clamped to somaxconn
+};
+
+/// Endpoint of a listener set; see `create_listener_set()`.
+struct listen_address_t {
+    std::string_view address;  // IP address or UNIX socket address
+    std::uint16_t port{};
+};
+
+/// Socket of a listener set; see `create_listener_set()`.
+struct set_listener_t {
+    listening_socket_t listener;
+    std::size_t index{};  // Index of the address the socket was created for
 };
 
 struct socket_info_t {
@@ -37,6 +100,21 @@ struct accepted_socket_t {
     std::uint16_t port{};
 };
 
+/**
+ * Accepted socket with the peer address kept in its raw form. Unlike `accepted_socket_t`, it does not allocate;
+ * use `get_socket_info()` to format the address when (if ever) it is needed.
+ */
+struct raw_accepted_socket_t {
+    int sock{};
+    sockaddr_storage addr{};
+    socklen_t addr_len{};
+};
+
+struct accept_batch_result_t {
+    std::size_t count{};    // Number of sockets stored in the output span
+    std::error_code error;  // Error which stopped the batch; empty if the queue was drained or the budget exhausted
+};
+
 /**
  * @brief Makes the file descriptor @a fd non-blocking.
  *
@@ -45,6 +123,14 @@ struct accepted_socket_t {
  */
 PSB_SOCKUTILS_EXPORT void make_nonblocking(int fd);
 
+/**
+ * @brief Makes the file descriptor @a fd non-blocking; non-throwing variant.
+ *
+ * @param fd File descriptor.
+ * @param ec Set to the error if the call to `fcntl()` failed, cleared otherwise.
+ */
+PSB_SOCKUTILS_EXPORT void make_nonblocking(int fd, std::error_code& ec) noexcept;
+
 /**
  * @brief Makes the file descriptor @a fd close-on-exec.
  *
@@ -53,6 +139,14 @@ PSB_SOCKUTILS_EXPORT void make_nonblocking(int fd);
  */
 PSB_SOCKUTILS_EXPORT void make_close_on_exec(int fd);
 
+/**
+ * @brief Makes the file descriptor @a fd close-on-exec; non-throwing variant.
+ *
+ * @param fd File descriptor.
+ * @param ec Set to the error if the call to `fcntl()` failed, cleared otherwise.
+ */
+PSB_SOCKUTILS_EXPORT void make_close_on_exec(int fd, std::error_code& ec) noexcept;
+
 /**
  * @brief Sets the socket option @a optname to @a optval.
  *
@@ -65,59 +159,373 @@ PSB_SOCKUTILS_EXPORT void make_close_on_exec(int fd);
  */
 PSB_SOCKUTILS_EXPORT void set_socket_option(int sock, int level, int optname, int optval, std::string_view name);
 
+/**
+ * @brief Sets the socket option @a optname to @a optval; non-throwing variant.
+ *
+ * Options not supported by the protocol (`ENOPROTOOPT`) are silently ignored.
+ *
+ * @param sock Socket descriptor.
+ * @param level The protocol level.
+ * @param optname The option name.
+ * @param optval The option value.
+ * @param ec Set to the error if the call to `setsockopt()` failed, cleared otherwise.
+ */
+PSB_SOCKUTILS_EXPORT void set_socket_option(int sock, int level, int optname, int optval, std::error_code& ec) noexcept;
+
+/**
+ * @brief Sets the options from @a opts which accepted sockets do not inherit from the listening socket.
+ *
+ * Only `quick_ack` belongs here; the call does nothing (and makes no system calls) if it is not set. Note that the
+ * kernel may leave quick ACK mode on its own, so this only affects the start of the connection.
+ *
+ * @param sock Accepted socket.
+ * @param opts The options the listening socket was created with.
+ * @throw std::system_error Call to `setsockopt()` failed.
+ */
+PSB_SOCKUTILS_EXPORT void set_accepted_socket_options(int sock, const socket_options_t& opts);
+
+/**
+ * @brief Sets the options from @a opts which accepted sockets do not inherit; non-throwing variant.
+ *
+ * @param sock Accepted socket.
+ * @param opts The options the listening socket was created with.
+ * @param ec Set to the error if the call to `setsockopt()` failed, cleared otherwise.
+ */
+PSB_SOCKUTILS_EXPORT void
+set_accepted_socket_options(int sock, const socket_options_t& opts, std::error_code& ec) noexcept;
+
 /**
  * @brief Binds the socket @a sock to the address @a address and port @a port.
  *
  * @param sock Socket descriptor.
- * @param address IP address.
+ * @param address IP address or UNIX socket address; see `make_socket_address()`.
  * @param port Port number.
  * @throw std::system_error Call to `bind()` failed.
- * @throw std::system_error The address family is not supported.
- * @throw std::invalid_argument The address is not valid IPv4 or IPv6 address.
+ * @throw std::invalid_argument The address is not valid IPv4, IPv6 or UNIX socket address.
  */
-PSB_SOCKUTILS_EXPORT void bind_socket(int sock, const std::string& address, std::uint16_t port);
+PSB_SOCKUTILS_EXPORT void bind_socket(int sock, std::string_view address, std::uint16_t port);
+
+/**
+ * @brief Binds the socket @a sock to the address @a address and port @a port; non-throwing variant.
+ *
+ * @param sock Socket descriptor.
+ * @param address IP address or UNIX socket address; see `make_socket_address()`.
+ * @param port Port number.
+ * @param ec Set to the error if the call failed (`std::errc::invalid_argument` for an invalid address),
+ * cleared otherwise.
+ */
+PSB_SOCKUTILS_EXPORT void
+bind_socket(int sock, std::string_view address, std::uint16_t port, std::error_code& ec) noexcept;
+
+/**
+ * @brief Parses the address @a address and the port @a port into the network address structure @a ss.
+ *
+ * The address family is determined by the address itself: an address starting with `/` is a UNIX socket path,
+ * and one starting with `@` is a name in the abstract UNIX socket namespace (`@` stands for the leading NUL byte);
+ * @a port is ignored for both. The function neither throws nor allocates memory.
+ *
+ * @param address IPv4 or IPv6 address, or UNIX socket address.
+ * @param port Port number.
+ * @param ss Network address structure to store the result.
+ * @param len Length of the resulting network address structure.
+ * @return `std::errc{}` on success, `std::errc::invalid_argument` if @a address is not a valid address,
+ * `std::errc::filename_too_long` if a UNIX socket address does not fit into `sockaddr_un`.
+ */
+PSB_SOCKUTILS_EXPORT std::errc
+make_socket_address(std::string_view address, std::uint16_t port, sockaddr_storage& ss, socklen_t& len) noexcept;
 
 /**
  * @brief Creates a listening socket bound to the address @a address and port @a port.
  *
+ * A UNIX socket address (see `make_socket_address()`) creates a UNIX domain listener; `seqpacket`, `unix_mode`
+ * and `unlink_stale` apply to it, while the IP and TCP level options are ignored.
+ *
+ * @param address IP address or UNIX socket address.
+ * @param port Port number; ignored for UNIX sockets.
+ * @param opts Socket options.
+ * @return The listening socket.
+ * @throw std::system_error Call to a system API failed.
+ * @throw std::invalid_argument The address is not valid IPv4, IPv6 or UNIX socket address.
+ */
+PSB_SOCKUTILS_EXPORT listening_socket_t
+create_listening_socket(std::string_view address, std::uint16_t port, const socket_options_t& opts);
+
+/**
+ * @brief Creates a listening socket bound to the address @a address and port @a port; non-throwing variant.
+ *
+ * @param address IP address or UNIX socket address.
+ * @param port Port number; ignored for UNIX sockets.
+ * @param opts Socket options.
+ * @param ec Set to the error if the call failed (`std::errc::invalid_argument` for an invalid address),
+ * cleared otherwise.
+ * @return The listening socket; `sock` is -1 on failure.
+ */
+PSB_SOCKUTILS_EXPORT listening_socket_t create_listening_socket(
+    std::string_view address, std::uint16_t port, const socket_options_t& opts, std::error_code& ec
+) noexcept;
+
+/**
+ * @brief Creates a listening socket bound to the socket address @a addr.
+ *
+ * Together with `make_sockaddr_in()`, this allows listener addresses to be parsed at compile time.
+ *
+ * @param addr IPv4 socket address.
+ * @param opts Socket options.
+ * @return The listening socket.
+ * @throw std::system_error Call to a system API failed.
+ */
+PSB_SOCKUTILS_EXPORT listening_socket_t create_listening_socket(const sockaddr_in& addr, const socket_options_t& opts);
+
+/**
+ * @brief Creates a listening socket bound to the socket address @a addr.
+ *
+ * @param addr IPv6 socket address.
+ * @param opts Socket options.
+ * @return The listening socket.
+ * @throw std::system_error Call to a system API failed.
+ */
+PSB_SOCKUTILS_EXPORT listening_socket_t create_listening_socket(const sockaddr_in6& addr, const socket_options_t& opts);
+
+/**
+ * @brief Creates a listening socket bound to the socket address @a ss.
+ *
+ * @param ss IPv4, IPv6 or UNIX socket address.
+ * @param len Length of the socket address.
+ * @param opts Socket options.
+ * @return The listening socket.
+ * @throw std::system_error Call to a system API failed; the message names the call, e.g.,
+ * `setsockopt(TCP_DEFER_ACCEPT) failed` or `bind(127.0.0.1:80) failed`.
+ */
+PSB_SOCKUTILS_EXPORT listening_socket_t
+create_listening_socket(const sockaddr_storage& ss, socklen_t len, const socket_options_t& opts);
+
+/**
+ * @brief Creates a listening socket bound to the socket address @a ss; non-throwing variant.
+ *
+ * @param ss IPv4, IPv6 or UNIX socket address.
+ * @param len Length of the socket address.
+ * @param opts Socket options.
+ * @param ec Set to the error if a call to a system API failed, cleared otherwise.
+ * @return The listening socket; `sock` is -1 on failure.
+ */
+PSB_SOCKUTILS_EXPORT listening_socket_t create_listening_socket(
+    const sockaddr_storage& ss, socklen_t len, const socket_options_t& opts, std::error_code& ec
+) noexcept;
+
+/**
+ * @brief Creates a group of @a count `SO_REUSEPORT` listening sockets bound to the same address and port.
+ *
+ * The kernel spreads incoming connections across the sockets of the group, so that every worker thread can have
+ * its own accept queue. If @a port is zero, all sockets share the port chosen by the kernel for the first one.
+ *
+ * With @a steer_by_cpu, a classic BPF program (`SO_ATTACH_REUSEPORT_CBPF`) makes the kernel hand every connection
+ * to the socket with the index `cpu % count`, where `cpu` is the CPU which processed the incoming SYN. This works
+ * best with one socket per CPU, each served by a worker pinned to that CPU.
+ *
  * @param address IP address.
  * @param port Port number.
+ * @param opts Socket options; `reuse_port` is implied.
+ * @param count Number of sockets in the group.
+ * @param steer_by_cpu Whether to attach the CPU steering program.
+ * @return The listening sockets, in the order of their indices in the group.
+ * @throw std::system_error Call to a system API failed.
+ * @throw std::invalid_argument The address is not valid IPv4 or IPv6 address.
+ */
+PSB_SOCKUTILS_EXPORT std::vector<listening_socket_t> create_listening_group(
+    std::string_view address, std::uint16_t port, const socket_options_t& opts, std::size_t count, bool steer_by_cpu
+);
+
+/**
+ * @brief Creates the listening sockets for all @a addresses as one unit: either all of them or none.
+ *
+ * All addresses are parsed before any socket is created. With @a dual_stack, every IPv6 wildcard address (`::`)
+ * gets a dual-stack socket, which accepts IPv4 connections as well (as IPv4-mapped IPv6 addresses, which
+ * `get_socket_info()` reports in their IPv4 form), and the IPv4 addresses with the same port are served by it
+ * instead of sockets of their own. Without @a dual_stack, every IPv6 socket is IPv6 only, so that `0.0.0.0` and
+ * `::` can be bound to the same port by separate sockets. Either way, `v6_only` in @a opts is overridden.
+ *
+ * The sockets can then be registered with one `epoll_acceptor`.
+ *
+ * @param addresses Addresses and ports to listen on.
  * @param opts Socket options.
- * @return The listening socket.
+ * @param dual_stack Whether IPv6 wildcard sockets also serve IPv4.
+ * @return The listening sockets with the indices of their addresses in @a addresses, in that order. An IPv4
+ * address served by a dual-stack socket has no socket of its own; it maps to the socket of `::` with its port.
+ * @throw std::system_error Call to a system API failed.
+ * @throw std::invalid_argument An address is not valid.
+ */
+PSB_SOCKUTILS_EXPORT std::vector<set_listener_t>
+create_listener_set(std::span<const listen_address_t> addresses, const socket_options_t& opts, bool dual_stack);
+
+/**
+ * @brief Creates the listening sockets for all @a addresses as one unit; non-throwing variant.
+ *
+ * @param addresses Addresses and ports to listen on.
+ * @param opts Socket options.
+ * @param dual_stack Whether IPv6 wildcard sockets also serve IPv4.
+ * @param ec Set to the error if the call failed (`std::errc::invalid_argument` for an invalid address),
+ * cleared otherwise.
+ * @return The listening sockets with the indices of their addresses, as for the throwing variant; empty on failure,
+ * in which case the sockets already created have been closed.
+ */
+PSB_SOCKUTILS_EXPORT std::vector<set_listener_t> create_listener_set(
+    std::span<const listen_address_t> addresses, const socket_options_t& opts, bool dual_stack, std::error_code& ec
+);
+
+/**
+ * @brief Creates a non-blocking UDP socket bound to the address @a address and port @a port.
+ *
+ * The socket options are handled as for `create_listening_socket()`, except for those which only apply to TCP.
+ * Use `udp_receiver` to receive datagrams in batches.
+ *
+ * @param address IP address.
+ * @param port Port number.
+ * @param opts Socket options; `listen_backlog` is ignored.
+ * @return The socket; `transport` is `kUdp`.
  * @throw std::system_error Call to a system API failed.
  * @throw std::invalid_argument The address is not valid IPv4 or IPv6 address.
  */
 PSB_SOCKUTILS_EXPORT listening_socket_t
-create_listening_socket(const std::string& address, std::uint16_t port, const socket_options_t& opts);
+create_udp_socket(std::string_view address, std::uint16_t port, const socket_options_t& opts);
+
+/**
+ * @brief Creates a non-blocking UDP socket bound to the address @a address and port @a port; non-throwing variant.
+ *
+ * @param address IP address.
+ * @param port Port number.
+ * @param opts Socket options; `listen_backlog` is ignored.
+ * @param ec Set to the error if the call failed (`std::errc::invalid_argument` for an invalid address),
+ * cleared otherwise.
+ * @return The socket; `sock` is -1 on failure.
+ */
+PSB_SOCKUTILS_EXPORT listening_socket_t create_udp_socket(
+    std::string_view address, std::uint16_t port, const socket_options_t& opts, std::error_code& ec
+) noexcept;
+
+/**
+ * @brief Creates a non-blocking UDP socket bound to the socket address @a ss; non-throwing variant.
+ *
+ * @param ss IPv4 or IPv6 socket address.
+ * @param len Length of the socket address.
+ * @param opts Socket options; `listen_backlog` is ignored.
+ * @param ec Set to the error if a call to a system API failed, cleared otherwise.
+ * @return The socket; `sock` is -1 on failure.
+ */
+PSB_SOCKUTILS_EXPORT listening_socket_t create_udp_socket(
+    const sockaddr_storage& ss, socklen_t len, const socket_options_t& opts, std::error_code& ec
+) noexcept;
+
+/**
+ * @brief Gets the largest backlog `listen()` accepts, `net.core.somaxconn`.
+ *
+ * @return The maximum backlog.
+ * @throw std::system_error Reading `/proc/sys/net/core/somaxconn` failed.
+ */
+PSB_SOCKUTILS_EXPORT int get_max_listen_backlog();
+
+/**
+ * @brief Gets the largest backlog `listen()` accepts, `net.core.somaxconn`; non-throwing variant.
+ *
+ * @param ec Set to the error if reading `/proc/sys/net/core/somaxconn` failed, cleared otherwise.
+ * @return The maximum backlog; -1 on failure.
+ */
+PSB_SOCKUTILS_EXPORT int get_max_listen_backlog(std::error_code& ec) noexcept;
+
+/**
+ * @brief Gets the current length and the effective maximum of the accept queue of the listening socket @a sock.
+ *
+ * Uses `TCP_INFO`, which reports these values for listening sockets in `tcpi_unacked` and `tcpi_sacked`.
+ * A queue which stays full means that the kernel is dropping connections (`ListenOverflows` in `nstat`).
+ *
+ * @param sock Listening TCP socket.
+ * @return The accept queue length and limit.
+ * @throw std::system_error Call to `getsockopt()` failed, or @a sock is not listening (`EINVAL`).
+ */
+PSB_SOCKUTILS_EXPORT listen_queue_t get_listen_queue(int sock);
+
+/**
+ * @brief Gets the current length and the effective maximum of the accept queue of the listening socket @a sock;
+ * non-throwing variant.
+ *
+ * @param sock Listening TCP socket.
+ * @param ec Set to the error if the call to `getsockopt()` failed or @a sock is not listening, cleared otherwise.
+ * @return The accept queue length and limit; zeros on failure.
+ */
+PSB_SOCKUTILS_EXPORT listen_queue_t get_listen_queue(int sock, std::error_code& ec) noexcept;
 
 /**
  * @brief Gets the socket information from the network address structure @a ss.
  *
+ * IPv4-mapped IPv6 addresses (`::ffff:a.b.c.d`), which dual-stack sockets report for IPv4 peers, are given in their
+ * IPv4 form, so that a peer has the same address whichever kind of socket it connected to.
+ *
  * @param ss Network address structure.
  * @param len Length of the network address structure.
  * @return The socket information.
  */
 PSB_SOCKUTILS_EXPORT socket_info_t get_socket_info(const sockaddr_storage& ss, socklen_t len);
 
+/**
+ * @brief Formats the address from the network address structure @a ss into @a buf without allocating memory.
+ *
+ * IPv4 and IPv6 addresses are formatted exactly as `inet_ntop()` does; for UNIX sockets, the path
+ * (or the abstract name without the leading NUL) is returned.
+ *
+ * @param ss Network address structure.
+ * @param len Length of the network address structure.
+ * @param buf Buffer to store the result.
+ * @return View of the formatted address in @a buf; empty if the address family is not supported or @a len is invalid.
+ */
+PSB_SOCKUTILS_EXPORT std::string_view
+format_address(const sockaddr_storage& ss, socklen_t len, address_buffer_t& buf) noexcept;
+
+/**
+ * @brief Formats @a info as `address:port` (`[address]:port` for IPv6, or just `address` if the port is zero).
+ *
+ * @param info Socket information.
+ * @param buf Buffer to store the result; overly long addresses are truncated.
+ * @return View of the formatted peer in @a buf.
+ */
+PSB_SOCKUTILS_EXPORT std::string_view format_peer(const socket_info_t& info, peer_buffer_t& buf) noexcept;
+
+/**
+ * @brief Formats the peer of the accepted socket @a sock as `address:port` without allocating memory.
+ *
+ * Like `get_socket_info()`, gives IPv4-mapped IPv6 addresses in their IPv4 form (`a.b.c.d:port`).
+ *
+ * @param sock Accepted socket.
+ * @param buf Buffer to store the result.
+ * @return View of the formatted peer in @a buf.
+ */
+PSB_SOCKUTILS_EXPORT std::string_view format_peer(const raw_accepted_socket_t& sock, peer_buffer_t& buf) noexcept;
+
+/**
+ * @brief Gets the peer information of the accepted socket @a sock.
+ *
+ * @param sock Accepted socket.
+ * @return The socket information.
+ */
+PSB_SOCKUTILS_EXPORT socket_info_t get_socket_info(const raw_accepted_socket_t& sock);
+
 /**
  * @brief Converts the IPv4 address @a address src into a network address structure @a dst.
  *
  * @param address IPv4 address.
  * @param dst Network address structure to store the result.
  * @throw std::invalid_argument The address is not valid IPv4 address.
- * @throw std::system_error The address family is not supported.
+ * @see parse_ipv4() for a non-throwing variant.
  */
-PSB_SOCKUTILS_EXPORT void inet_pton(const std::string& address, in_addr& dst);
+PSB_SOCKUTILS_EXPORT void inet_pton(std::string_view address, in_addr& dst);
 
 /**
  * @brief Converts the IPv6 address @a address src into a network address structure @a dst.
  *
  * @param address IPv6 address.
  * @param dst Network address structure to store the result.
- * @throw std::invalid_argument The address is not valid IPv4 address.
- * @throw std::system_error The address family is not supported.
+ * @throw std::invalid_argument The address is not valid IPv6 address.
+ * @see parse_ipv6() for a non-throwing variant.
  */
-PSB_SOCKUTILS_EXPORT void inet_pton(const std::string& address, in6_addr& dst);
+PSB_SOCKUTILS_EXPORT void inet_pton(std::string_view address, in6_addr& dst);
 
 /**
  * @brief Accepts a connection on the socket @a fd and makes the accepted socket non-blocking and close-on-exec.
@@ -128,6 +536,80 @@ PSB_SOCKUTILS_EXPORT void inet_pton(const std::string& address, in6_addr& dst);
  */
 PSB_SOCKUTILS_EXPORT accepted_socket_t accept_connection(int fd);
 
+/**
+ * @brief Accepts a connection on the socket @a fd; variant which reports `accept()` errors through @a ec.
+ *
+ * Routine conditions such as `EAGAIN`, `ECONNABORTED` or `EMFILE` are reported without the cost of an exception.
+ *
+ * @param fd Socket descriptor.
+ * @param ec Set to the error if the call to `accept()` failed, cleared otherwise.
+ * @return Accepted socket and peer information; `sock` is -1 on failure.
+ * @throw std::bad_alloc Failed to allocate memory for the peer address.
+ */
+PSB_SOCKUTILS_EXPORT accepted_socket_t accept_connection(int fd, std::error_code& ec);
+
+/**
+ * @brief Accepts up to @a budget pending connections on the socket @a fd in one go.
+ *
+ * The accepted sockets are created non-blocking and close-on-exec atomically (via `accept4()` where available).
+ * The function stops when the accept queue is drained (`EAGAIN`), when @a budget connections or `sockets.size()`
+ * connections have been accepted, or when `accept()` fails. Aborted connections (`ECONNABORTED`) are skipped.
+ * The function does not throw on `accept()` errors: the sockets accepted so far are always reported.
+ *
+ * @param fd Listening socket descriptor; should be non-blocking.
+ * @param sockets Storage for the accepted sockets; the first `count` elements are filled in.
+ * @param budget Maximum number of connections to accept.
+ * @return Number of accepted sockets and the error which stopped the batch, if any.
+ */
+PSB_SOCKUTILS_EXPORT accept_batch_result_t
+accept_connections(int fd, std::span<accepted_socket_t> sockets, std::size_t budget);
+
+/**
+ * @brief Accepts a connection on the socket @a fd without formatting the peer address.
+ *
+ * The accepted socket is non-blocking and close-on-exec. The function performs no heap allocations.
+ *
+ * @param fd Socket descriptor.
+ * @return Accepted socket and the raw peer address.
+ * @throw std::system_error Call to a system API failed.
+ */
+PSB_SOCKUTILS_EXPORT raw_accepted_socket_t accept_raw_connection(int fd);
+
+/**
+ * @brief Accepts a connection on the socket @a fd without formatting the peer address; non-throwing variant.
+ *
+ * @param fd Socket descriptor.
+ * @param ec Set to the error if the call to `accept()` failed, cleared otherwise.
+ * @return Accepted socket and the raw peer address; `sock` is -1 on failure.
+ */
+PSB_SOCKUTILS_EXPORT raw_accepted_socket_t accept_raw_connection(int fd, std::error_code& ec) noexcept;
+
+/**
+ * @brief Allocation-free variant of `accept_connections()` which keeps peer addresses in their raw form.
+ *
+ * @param fd Listening socket descriptor; should be non-blocking.
+ * @param sockets Storage for the accepted sockets; the first `count` elements are filled in.
+ * @param budget Maximum number of connections to accept.
+ * @return Number of accepted sockets and the error which stopped the batch, if any.
+ */
+PSB_SOCKUTILS_EXPORT accept_batch_result_t
+accept_connections(int fd, std::span<raw_accepted_socket_t> sockets, std::size_t budget);
+
 }  // namespace psb
 
+/**
+ * Formats `psb::socket_info_t` and `psb::raw_accepted_socket_t` as `address:port` (see `psb::format_peer()`).
+ * Standard string format specifications (fill, alignment, width) are supported.
+ */
+template<typename Peer>
+    requires std::is_same_v<Peer, psb::socket_info_t> || std::is_same_v<Peer, psb::raw_accepted_socket_t>
+struct std::formatter<Peer, char> : std::formatter<std::string_view, char> {
+    template<typename FormatContext>
+    auto format(const Peer& peer, FormatContext& ctx) const
+    {
+        psb::peer_buffer_t buf;  // NOLINT(cppcoreguidelines-pro-type-member-init,hicpp-member-init)
+        return std::formatter<std::string_view, char>::format(psb::format_peer(peer, buf), ctx);
+    }
+};
+
 #endif /* C4E7C8D4_DF90_421A_BAC2_E1BE5862ABBE */
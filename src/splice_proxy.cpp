@@ -0,0 +1,256 @@
+#include "splice_proxy.h"
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+void close_pipe(const psb::pipe_t& pipe) noexcept
+{
+    close(pipe.read_fd);
+    close(pipe.write_fd);
+}
+
+/**
+ * Calls `splice()` without blocking; returns the number of bytes moved, 0 at end of stream, or -1 with `errno` set.
+ */
+ssize_t splice_nonblocking(int from, int to, std::size_t len) noexcept
+{
+    ssize_t res{};
+    do {
+        res = splice(from, nullptr, to, nullptr, len, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    } while (res == -1 && errno == EINTR);
+
+    return res;
+}
+
+bool is_sigpipe_ignored() noexcept
+{
+    struct sigaction action{};
+    return sigaction(SIGPIPE, nullptr, &action) == 0 && action.sa_handler == SIG_IGN;
+}
+
+/**
+ * Same as `splice_nonblocking()` with a socket destination, but without raising `SIGPIPE` when the connection is
+ * gone: `splice()` has no `MSG_NOSIGNAL`. The signal is blocked for the call, and the one it raises is discarded
+ * unless it was already pending.
+ */
+ssize_t splice_nosignal(int from, int to, std::size_t len) noexcept
+{
+    sigset_t sigpipe;
+    sigemptyset(&sigpipe);
+    sigaddset(&sigpipe, SIGPIPE);
+
+    sigset_t pending;
+    sigemptyset(&pending);
+    sigpending(&pending);
+    const bool was_pending = sigismember(&pending, SIGPIPE) == 1;
+
+    sigset_t old_mask;
+    pthread_sigmask(SIG_BLOCK, &sigpipe, &old_mask);
+
+    const auto res = splice_nonblocking(from, to, len);
+    const auto err = errno;
+    if (res == -1 && err == EPIPE && !was_pending) {
+        constexpr timespec no_wait{};
+        while (sigtimedwait(&sigpipe, nullptr, &no_wait) == -1 && errno == EINTR) {
+        }
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old_mask, nullptr);
+    errno = err;
+    return res;
+}
+
+}  // namespace
+
+namespace psb {
+
+pipe_pool::pipe_pool(std::size_t max_idle, std::size_t pipe_size)
+    : m_max_idle(max_idle), m_pipe_size(pipe_size), m_sigpipe_ignored(is_sigpipe_ignored())
+{
+    this->m_idle.reserve(max_idle);
+}
+
+pipe_pool::~pipe_pool() noexcept
+{
+    for (const auto& pipe : this->m_idle) {
+        close_pipe(pipe);
+    }
+}
+
+pipe_t pipe_pool::acquire()
+{
+    if (!this->m_idle.empty()) {
+        const auto pipe = this->m_idle.back();
+        this->m_idle.pop_back();
+        return pipe;
+    }
+
+    std::array<int, 2> fds{};
+    if (pipe2(fds.data(), O_NONBLOCK | O_CLOEXEC) == -1) [[unlikely]] {
+        throw std::system_error(errno, std::generic_category(), "pipe2() failed");
+    }
+
+    const pipe_t pipe{.read_fd = fds[0], .write_fd = fds[1]};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    const auto size = fcntl(pipe.write_fd, this->m_pipe_size != 0 ? F_SETPIPE_SZ : F_GETPIPE_SZ, this->m_pipe_size);
+    if (size == -1) [[unlikely]] {
+        const auto err = errno;
+        close_pipe(pipe);
+        throw std::system_error(
+            err, std::generic_category(),
+            this->m_pipe_size != 0 ? "fcntl(F_SETPIPE_SZ) failed" : "fcntl(F_GETPIPE_SZ) failed"
+        );
+    }
+
+    // The kernel rounds the size up to a power of two number of pages
+    this->m_pipe_size = static_cast<std::size_t>(size);
+    return pipe;
+}
+
+void pipe_pool::release(const pipe_t& pipe, bool empty) noexcept
+{
+    if (empty && this->m_idle.size() < this->m_max_idle) {
+        this->m_idle.push_back(pipe);  // Does not allocate: the capacity is max_idle
+    }
+    else {
+        close_pipe(pipe);
+    }
+}
+
+std::size_t pipe_pool::pipe_size() const noexcept
+{
+    return this->m_pipe_size;
+}
+
+std::size_t pipe_pool::idle() const noexcept
+{
+    return this->m_idle.size();
+}
+
+bool pipe_pool::sigpipe_ignored() const noexcept
+{
+    return this->m_sigpipe_ignored;
+}
+
+splice_proxy::splice_proxy(int client, int upstream, pipe_pool& pool)
+    : m_pool(pool), m_to_upstream{.from = client, .to = upstream, .pipe = pool.acquire()},
+      m_to_client{.from = upstream, .to = client, .pipe = {}}
+{
+    try {
+        this->m_to_client.pipe = pool.acquire();
+    }
+    catch (...) {
+        pool.release(this->m_to_upstream.pipe, true);
+        throw;
+    }
+}
+
+splice_proxy::~splice_proxy() noexcept
+{
+    this->m_pool.release(this->m_to_upstream.pipe, this->m_to_upstream.buffered == 0);
+    this->m_pool.release(this->m_to_client.pipe, this->m_to_client.buffered == 0);
+}
+
+void splice_proxy::pump(direction_t& dir, std::error_code& ec) const noexcept
+{
+    const auto capacity = this->m_pool.pipe_size();
+
+    for (bool progress = true; progress && !ec;) {
+        progress = false;
+
+        if (!dir.eof && dir.buffered < capacity) {
+            const auto res = splice_nonblocking(dir.from, dir.pipe.write_fd, capacity - dir.buffered);
+            if (res > 0) {
+                dir.buffered += static_cast<std::size_t>(res);
+                progress = true;
+            }
+            else if (res == 0) {
+                dir.eof = true;
+            }
+            else if (errno != EAGAIN) [[unlikely]] {
+                ec.assign(errno, std::generic_category());
+                return;
+            }
+        }
+
+        if (dir.buffered > 0) {
+            const auto res = this->m_pool.sigpipe_ignored()
+                                 ? splice_nonblocking(dir.pipe.read_fd, dir.to, dir.buffered)
+                                 : splice_nosignal(dir.pipe.read_fd, dir.to, dir.buffered);
+            if (res > 0) {
+                dir.buffered -= static_cast<std::size_t>(res);
+                dir.total += static_cast<std::uint64_t>(res);
+                progress = true;
+            }
+            else if (res == -1 && errno != EAGAIN) [[unlikely]] {
+                ec.assign(errno, std::generic_category());
+                return;
+            }
+        }
+    }
+
+    if (dir.eof && dir.buffered == 0 && !dir.shut_down && !ec) {
+        // Propagate the half-close once everything read has been written
+        if (shutdown(dir.to, SHUT_WR) == -1 && errno != ENOTCONN) [[unlikely]] {
+            ec.assign(errno, std::generic_category());
+            return;
+        }
+
+        dir.shut_down = true;
+    }
+}
+
+splice_interest_t splice_proxy::pump(std::error_code& ec) noexcept
+{
+    ec.clear();
+
+    this->pump(this->m_to_upstream, ec);
+    if (!ec) {
+        this->pump(this->m_to_client, ec);
+    }
+
+    // Data left in a pipe means that its destination is full: stop reading until it has been flushed
+    const auto& up   = this->m_to_upstream;
+    const auto& down = this->m_to_client;
+    return {
+        .client_read    = !up.eof && up.buffered == 0,
+        .client_write   = down.buffered > 0,
+        .upstream_read  = !down.eof && down.buffered == 0,
+        .upstream_write = up.buffered > 0,
+        .done           = up.shut_down && down.shut_down,
+    };
+}
+
+splice_interest_t splice_proxy::pump()
+{
+    std::error_code ec;
+    const auto result = this->pump(ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, "splice() failed");
+    }
+
+    return result;
+}
+
+std::uint64_t splice_proxy::bytes_to_upstream() const noexcept
+{
+    return this->m_to_upstream.total;
+}
+
+std::uint64_t splice_proxy::bytes_to_client() const noexcept
+{
+    return this->m_to_client.total;
+}
+
+}  // namespace psb
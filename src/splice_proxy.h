@@ -0,0 +1,173 @@
+#ifndef E8EE755E_4785_4A63_A4A0_BF8BFDE6936A
+#define E8EE755E_4785_4A63_A4A0_BF8BFDE6936A
+
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <vector>
+
+#include "export.h"
+
+namespace psb {
+
+struct pipe_t {
+    int read_fd{-1};
+    int write_fd{-1};
+};
+
+/**
+ * @brief Pool of non-blocking pipes for `splice_proxy`, which keeps pipe creation out of the per-connection path.
+ *
+ * Only empty pipes return to the pool; a pipe released with data in it is closed. The pool is not thread-safe;
+ * use one pool per thread.
+ *
+ * The pool also records whether the process ignores `SIGPIPE` when the pool is created, so that the proxies using
+ * it need not check on every write.
+ */
+class PSB_SOCKUTILS_EXPORT pipe_pool {
+public:
+    /**
+     * @brief Creates an empty pool.
+     *
+     * @param max_idle Number of idle pipes kept at most; extra pipes are closed when released.
+     * @param pipe_size Capacity of new pipes in bytes (`F_SETPIPE_SZ`); 0 keeps the system default.
+     */
+    explicit pipe_pool(std::size_t max_idle, std::size_t pipe_size = 0);
+    ~pipe_pool() noexcept;
+
+    pipe_pool(const pipe_pool&)            = delete;
+    pipe_pool(pipe_pool&&)                 = delete;
+    pipe_pool& operator=(const pipe_pool&) = delete;
+    pipe_pool& operator=(pipe_pool&&)      = delete;
+
+    /**
+     * @brief Takes an idle pipe from the pool, or creates one if there is none.
+     *
+     * @return The pipe; both ends are non-blocking and close-on-exec.
+     * @throw std::system_error Creating the pipe failed.
+     */
+    pipe_t acquire();
+
+    /**
+     * @brief Returns @a pipe to the pool, or closes it if it is not @a empty or the pool is full.
+     */
+    void release(const pipe_t& pipe, bool empty) noexcept;
+
+    /**
+     * @brief Gets the capacity of the pipes in bytes.
+     */
+    [[nodiscard]] std::size_t pipe_size() const noexcept;
+
+    /**
+     * @brief Gets the number of idle pipes in the pool.
+     */
+    [[nodiscard]] std::size_t idle() const noexcept;
+
+    /**
+     * @brief Tells whether `SIGPIPE` was ignored (`SIG_IGN`) when the pool was created.
+     */
+    [[nodiscard]] bool sigpipe_ignored() const noexcept;
+
+private:
+    std::size_t m_max_idle;
+    std::size_t m_pipe_size;
+    bool m_sigpipe_ignored;
+    std::vector<pipe_t> m_idle;
+};
+
+/**
+ * Readiness the proxy waits for; register these events with the event loop (e.g., `EPOLLIN`/`EPOLLOUT`) and call
+ * `splice_proxy::pump()` when any of them occurs.
+ */
+struct splice_interest_t {
+    bool client_read{};
+    bool client_write{};
+    bool upstream_read{};
+    bool upstream_write{};
+    bool done{};  // Both directions have been closed and flushed; the sockets can be closed
+};
+
+/**
+ * @brief Moves data between two connected non-blocking sockets with `splice()`, without copying it to user space.
+ *
+ * Each direction goes through its own pipe from a `pipe_pool`: `splice()` moves data from the source socket into
+ * the pipe and from the pipe into the destination socket. A direction stops reading while its destination socket
+ * is full, so a slow receiver pushes back on the sender through the TCP window instead of the proxy buffering
+ * without bound. When a source reaches end of stream, the proxy shuts down the writing side of the destination once
+ * the pipe has been flushed, and the other direction keeps working (half-close).
+ *
+ * Writing to a destination whose connection is gone fails with `EPIPE` without raising `SIGPIPE`, so callers do
+ * not need to ignore the signal. `splice()` has no `MSG_NOSIGNAL`, though, so unless `SIGPIPE` was ignored when
+ * the pool was created, every write to a socket blocks the signal around the call, which costs three more system
+ * calls; processes that can should ignore `SIGPIPE` before creating the pool. The proxy does not own the sockets.
+ */
+class PSB_SOCKUTILS_EXPORT splice_proxy {
+public:
+    /**
+     * @brief Creates the proxy and takes two pipes from @a pool.
+     *
+     * @param client Socket of the downstream connection, e.g. from `accept_connection()`.
+     * @param upstream Socket of the upstream connection.
+     * @param pool Pipe pool; must outlive the proxy.
+     * @throw std::system_error Creating a pipe failed.
+     */
+    splice_proxy(int client, int upstream, pipe_pool& pool);
+
+    /**
+     * @brief Returns the pipes to the pool.
+     */
+    ~splice_proxy() noexcept;
+
+    splice_proxy(const splice_proxy&)            = delete;
+    splice_proxy(splice_proxy&&)                 = delete;
+    splice_proxy& operator=(const splice_proxy&) = delete;
+    splice_proxy& operator=(splice_proxy&&)      = delete;
+
+    /**
+     * @brief Moves as much data in both directions as the sockets allow without blocking.
+     *
+     * @return The events to wait for before the next call.
+     * @throw std::system_error Call to `splice()` or `shutdown()` failed, e.g. with `ECONNRESET`.
+     */
+    splice_interest_t pump();
+
+    /**
+     * @brief Moves as much data in both directions as the sockets allow without blocking; non-throwing variant.
+     *
+     * @param ec Set to the error if a call to `splice()` or `shutdown()` failed, cleared otherwise. After an error,
+     * the connection should be closed.
+     * @return The events to wait for before the next call.
+     */
+    splice_interest_t pump(std::error_code& ec) noexcept;
+
+    /**
+     * @brief Gets the number of bytes moved from the client to the upstream socket.
+     */
+    [[nodiscard]] std::uint64_t bytes_to_upstream() const noexcept;
+
+    /**
+     * @brief Gets the number of bytes moved from the upstream to the client socket.
+     */
+    [[nodiscard]] std::uint64_t bytes_to_client() const noexcept;
+
+private:
+    struct direction_t {
+        int from;
+        int to;
+        pipe_t pipe;
+        std::size_t buffered = 0;  // Bytes in the pipe
+        std::uint64_t total  = 0;  // Bytes written to `to`
+        bool eof             = false;
+        bool shut_down       = false;
+    };
+
+    void pump(direction_t& dir, std::error_code& ec) const noexcept;
+
+    pipe_pool& m_pool;
+    direction_t m_to_upstream;
+    direction_t m_to_client;
+};
+
+}  // namespace psb
+
+#endif /* E8EE755E_4785_4A63_A4A0_BF8BFDE6936A */
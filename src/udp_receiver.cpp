@@ -0,0 +1,158 @@
+#include "udp_receiver.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <system_error>
+
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+
+namespace {
+
+constexpr std::size_t default_batch_size  = 64;
+constexpr std::size_t default_buffer_size = 2048;
+constexpr std::size_t max_gro_size        = 65535;
+// UDP_MAX_SEGMENTS: the largest number of datagrams the kernel coalesces into one message
+constexpr std::size_t max_gro_segments = 128;
+
+/**
+ * Returns the segment size reported in the `UDP_GRO` control message of @a hdr, or 0 if there is none.
+ */
+std::size_t get_gro_size([[maybe_unused]] msghdr& hdr) noexcept
+{
+#if defined(UDP_GRO)
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-cstyle-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    for (auto* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+        if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+            int size{};
+            std::memcpy(&size, CMSG_DATA(cmsg), sizeof(size));
+            return size > 0 ? static_cast<std::size_t>(size) : 0;
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-pro-type-cstyle-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+#endif
+
+    return 0;
+}
+
+}  // namespace
+
+namespace psb {
+
+udp_receiver::udp_receiver(int sock, const udp_receiver_options_t& opts)
+    : m_sock(sock),
+      m_buffer_size(opts.buffer_size != 0 ? opts.buffer_size : (opts.gro ? max_gro_size : default_buffer_size)),
+      m_control_size(opts.gro ? CMSG_SPACE(sizeof(int)) : 0)
+{
+    const auto batch_size = opts.batch_size != 0 ? opts.batch_size : default_batch_size;
+
+    if (opts.gro) {
+#if defined(UDP_GRO)
+        set_socket_option(sock, SOL_UDP, UDP_GRO, 1, "UDP_GRO");
+#else
+        throw std::system_error(std::make_error_code(std::errc::protocol_not_available), "UDP_GRO is not supported");
+#endif
+    }
+
+    this->m_buffers.resize(batch_size * this->m_buffer_size);
+    this->m_control.resize(batch_size * this->m_control_size);
+    this->m_addrs.resize(batch_size);
+    this->m_iovecs.resize(batch_size);
+    this->m_messages.resize(batch_size);
+    this->m_datagrams.reserve(opts.gro ? batch_size * max_gro_segments : batch_size);
+
+    const std::span<std::byte> buffers(this->m_buffers);
+    const std::span<std::byte> control(this->m_control);
+    for (std::size_t i = 0; i < batch_size; ++i) {
+        auto& iov    = this->m_iovecs.at(i);
+        iov.iov_base = buffers.subspan(i * this->m_buffer_size).data();
+        iov.iov_len  = this->m_buffer_size;
+
+        auto& hdr      = this->m_messages.at(i).msg_hdr;
+        hdr.msg_name   = &this->m_addrs.at(i);
+        hdr.msg_iov    = &iov;
+        hdr.msg_iovlen = 1;
+        if (this->m_control_size != 0) {
+            hdr.msg_control = control.subspan(i * this->m_control_size).data();
+        }
+    }
+}
+
+std::span<const udp_datagram_t> udp_receiver::receive(std::error_code& ec) noexcept
+{
+    ec.clear();
+    this->m_datagrams.clear();
+
+    for (auto& message : this->m_messages) {
+        message.msg_hdr.msg_namelen    = sizeof(sockaddr_storage);
+        message.msg_hdr.msg_controllen = this->m_control_size;
+        message.msg_hdr.msg_flags      = 0;
+    }
+
+    int res{};
+    do {
+        res = recvmmsg(
+            this->m_sock, this->m_messages.data(), static_cast<unsigned int>(this->m_messages.size()), MSG_DONTWAIT,
+            nullptr
+        );
+    } while (res == -1 && errno == EINTR);
+
+    if (res == -1) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) [[unlikely]] {
+            ec.assign(errno, std::generic_category());
+        }
+
+        return {};
+    }
+
+    const std::span<const std::byte> buffers(this->m_buffers);
+    for (std::size_t i = 0; i < static_cast<std::size_t>(res); ++i) {
+        auto& message        = this->m_messages.at(i);
+        const auto length    = static_cast<std::size_t>(message.msg_len);
+        const auto data      = buffers.subspan(i * this->m_buffer_size, length);
+        const auto truncated = (static_cast<unsigned int>(message.msg_hdr.msg_flags) & MSG_TRUNC) != 0;
+        const auto* addr     = &this->m_addrs.at(i);
+
+        auto segment = this->m_control_size != 0 ? get_gro_size(message.msg_hdr) : 0;
+        if (segment == 0) {
+            segment = std::max<std::size_t>(length, 1);
+        }
+
+        std::size_t offset = 0;
+        do {
+            // With GRO, only the last segment may be shorter than the segment size
+            const auto size = std::min(segment, length - offset);
+            this->m_datagrams.push_back(
+                {.data      = data.subspan(offset, size),
+                 .addr      = addr,
+                 .addr_len  = message.msg_hdr.msg_namelen,
+                 .truncated = truncated}
+            );
+            offset += size;
+        } while (offset < length);
+    }
+
+    return this->m_datagrams;
+}
+
+std::span<const udp_datagram_t> udp_receiver::receive()
+{
+    std::error_code ec;
+    const auto result = this->receive(ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, "recvmmsg() failed");
+    }
+
+    return result;
+}
+
+int udp_receiver::sock() const noexcept
+{
+    return this->m_sock;
+}
+
+}  // namespace psb
@@ -0,0 +1,89 @@
+#ifndef A8D39551_BE5E_49A5_BBAB_951395B1959E
+#define A8D39551_BE5E_49A5_BBAB_951395B1959E
+
+#include <cstddef>
+#include <span>
+#include <system_error>
+#include <vector>
+
+#include <sys/socket.h>
+
+#include "export.h"
+#include "sockutils.h"
+
+namespace psb {
+
+struct udp_receiver_options_t {
+    std::size_t batch_size;   // Messages received per recvmmsg() call at most; 0 selects the default (64)
+    std::size_t buffer_size;  // Size of every message buffer; 0 selects the default (2048, or 65535 with gro)
+    bool gro;                 // Enable UDP_GRO: the kernel may coalesce datagrams, which are split on receipt
+};
+
+/**
+ * A received datagram. `data` points into the receiver's buffers and `addr` into its address table; both are only
+ * valid until the next `receive()` call. Use `get_socket_info(*addr, addr_len)` to decode the peer.
+ */
+struct udp_datagram_t {
+    std::span<const std::byte> data;
+    const sockaddr_storage* addr{};
+    socklen_t addr_len{};
+    bool truncated{};  // The datagram did not fit into the buffer and has been cut short
+};
+
+/**
+ * @brief Receives datagrams from a UDP socket in batches with `recvmmsg()`.
+ *
+ * All message buffers, address slots and control buffers are allocated once, in the constructor; `receive()`
+ * does not allocate. With `gro`, the kernel may deliver several datagrams of the same flow as one message
+ * together with their segment size (`UDP_GRO` control message); `receive()` splits such messages, so the caller
+ * always sees the individual datagrams.
+ *
+ * The receiver does not own the socket. It is not thread-safe; use one receiver per thread.
+ */
+class PSB_SOCKUTILS_EXPORT udp_receiver {
+public:
+    /**
+     * @brief Creates the receiver and, with `gro`, enables `UDP_GRO` on @a sock.
+     *
+     * @param sock UDP socket, e.g. from `create_udp_socket()`.
+     * @param opts Receiver options.
+     * @throw std::system_error Enabling `UDP_GRO` failed.
+     */
+    udp_receiver(int sock, const udp_receiver_options_t& opts);
+
+    /**
+     * @brief Receives the datagrams which are queued on the socket, without waiting for more.
+     *
+     * @return The received datagrams; empty if none were queued. Valid until the next call.
+     * @throw std::system_error Call to `recvmmsg()` failed.
+     */
+    std::span<const udp_datagram_t> receive();
+
+    /**
+     * @brief Receives the datagrams which are queued on the socket, without waiting for more; non-throwing variant.
+     *
+     * @param ec Set to the error if the call to `recvmmsg()` failed, cleared otherwise.
+     * @return The received datagrams; empty if none were queued or on failure. Valid until the next call.
+     */
+    std::span<const udp_datagram_t> receive(std::error_code& ec) noexcept;
+
+    /**
+     * @brief Gets the socket the receiver reads from.
+     */
+    [[nodiscard]] int sock() const noexcept;
+
+private:
+    int m_sock;
+    std::size_t m_buffer_size;
+    std::size_t m_control_size;
+    std::vector<std::byte> m_buffers;
+    std::vector<std::byte> m_control;
+    std::vector<sockaddr_storage> m_addrs;
+    std::vector<iovec> m_iovecs;
+    std::vector<mmsghdr> m_messages;
+    std::vector<udp_datagram_t> m_datagrams;
+};
+
+}  // namespace psb
+
+#endif /* A8D39551_BE5E_49A5_BBAB_951395B1959E */
@@ -0,0 +1,152 @@
+#include "udp_sender.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <system_error>
+
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+
+namespace {
+
+constexpr std::size_t default_batch_size = 64;
+constexpr std::size_t iovecs_per_message = 4;
+constexpr std::size_t control_size       = CMSG_SPACE(sizeof(std::uint16_t));
+
+}  // namespace
+
+namespace psb {
+
+udp_sender::udp_sender(int sock, const udp_sender_options_t& opts) : m_sock(sock)
+{
+    const auto batch_size = opts.batch_size != 0 ? opts.batch_size : default_batch_size;
+
+    this->m_addrs.resize(batch_size);
+    this->m_control.resize(batch_size * control_size);
+    this->m_messages.resize(batch_size);
+    this->m_first_iovec.resize(batch_size);
+    this->m_iovecs.reserve(batch_size * iovecs_per_message);
+    this->m_results.reserve(batch_size);
+}
+
+bool udp_sender::add(const sockaddr_storage& addr, socklen_t len, std::span<const iovec> iov)
+{
+    if (this->m_count == this->m_messages.size()) {
+        return false;
+    }
+
+    this->queue(addr, len, iov, 0);
+    return true;
+}
+
+bool udp_sender::add(const sockaddr_storage& addr, socklen_t len, std::span<const std::byte> data)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast): sendmmsg() does not write to the payload
+    const iovec iov{.iov_base = const_cast<std::byte*>(data.data()), .iov_len = data.size()};
+    return this->add(addr, len, std::span(&iov, 1));
+}
+
+bool udp_sender::add_segmented(
+    const sockaddr_storage& addr, socklen_t len, std::span<const std::byte> data, std::uint16_t segment_size
+)
+{
+    if (this->m_count == this->m_messages.size()) {
+        return false;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast): sendmmsg() does not write to the payload
+    const iovec iov{.iov_base = const_cast<std::byte*>(data.data()), .iov_len = data.size()};
+    this->queue(addr, len, std::span(&iov, 1), segment_size);
+    return true;
+}
+
+void udp_sender::queue(
+    const sockaddr_storage& addr, socklen_t len, std::span<const iovec> iov, std::uint16_t segment_size
+)
+{
+    const auto index = this->m_count;
+
+    // May allocate if the messages have more iovecs than reserved for
+    this->m_first_iovec.at(index) = this->m_iovecs.size();
+    this->m_iovecs.insert(this->m_iovecs.end(), iov.begin(), iov.end());
+    ++this->m_count;
+
+    auto& dest = this->m_addrs.at(index);
+    len        = std::min<socklen_t>(len, sizeof(dest));
+    std::memcpy(&dest, &addr, len);
+
+    auto& hdr       = this->m_messages.at(index).msg_hdr;
+    hdr             = {};
+    hdr.msg_name    = &dest;
+    hdr.msg_namelen = len;
+    hdr.msg_iovlen  = iov.size();
+
+    if (segment_size != 0) {
+        hdr.msg_control    = std::span(this->m_control).subspan(index * control_size, control_size).data();
+        hdr.msg_controllen = control_size;
+
+        // NOLINTBEGIN(cppcoreguidelines-pro-type-cstyle-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        auto* cmsg       = CMSG_FIRSTHDR(&hdr);
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type  = UDP_SEGMENT;
+        cmsg->cmsg_len   = CMSG_LEN(sizeof(segment_size));
+        std::memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+        // NOLINTEND(cppcoreguidelines-pro-type-cstyle-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+}
+
+std::span<const udp_send_result_t> udp_sender::flush() noexcept
+{
+    const auto count = this->m_count;
+
+    // The iovecs may have been reallocated while the messages were queued
+    for (std::size_t i = 0; i < count; ++i) {
+        this->m_messages.at(i).msg_hdr.msg_iov = std::span(this->m_iovecs).subspan(this->m_first_iovec.at(i)).data();
+    }
+
+    this->m_results.clear();
+    this->m_results.resize(count);
+
+    std::size_t sent = 0;
+    while (sent < count) {
+        const auto res = sendmmsg(
+            this->m_sock, std::span(this->m_messages).subspan(sent).data(), static_cast<unsigned int>(count - sent),
+            MSG_DONTWAIT
+        );
+
+        if (res == -1) {
+            const auto err = errno;
+            if (err == EINTR) {
+                continue;
+            }
+
+            // The message which failed is skipped; the socket being full fails all of the remaining ones
+            const auto failed = err == EAGAIN || err == EWOULDBLOCK ? count : sent + 1;
+            for (; sent < failed; ++sent) {
+                this->m_results.at(sent).error.assign(err, std::generic_category());
+            }
+
+            continue;
+        }
+
+        for (const auto end = sent + static_cast<std::size_t>(res); sent < end; ++sent) {
+            this->m_results.at(sent).bytes = this->m_messages.at(sent).msg_len;
+        }
+    }
+
+    this->m_count = 0;
+    this->m_iovecs.clear();
+    return this->m_results;
+}
+
+std::size_t udp_sender::pending() const noexcept
+{
+    return this->m_count;
+}
+
+}  // namespace psb
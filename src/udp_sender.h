@@ -0,0 +1,115 @@
+#ifndef B3DAE197_48C2_4A1D_B0BD_4896B2D327B7
+#define B3DAE197_48C2_4A1D_B0BD_4896B2D327B7
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <system_error>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include "export.h"
+
+namespace psb {
+
+struct udp_sender_options_t {
+    std::size_t batch_size;  // Messages queued (and sent per sendmmsg() call) at most; 0 selects the default (64)
+};
+
+struct udp_send_result_t {
+    std::size_t bytes{};    // Bytes sent; for a segmented message, the total over all its datagrams
+    std::error_code error;  // Why the message was not sent; empty on success
+};
+
+/**
+ * @brief Sends datagrams from a UDP socket in batches with `sendmmsg()`.
+ *
+ * Messages are queued with `add()` or `add_segmented()` and sent by `flush()`, which needs one system call per
+ * batch rather than one per datagram. The sender copies the destination addresses but not the payloads: the
+ * memory referenced by the queued iovecs must stay valid until `flush()` returns. This makes fanning out the same
+ * payload to many peers cheap.
+ *
+ * A segmented message is sent as one GSO message (`UDP_SEGMENT`): the kernel splits the payload into datagrams of
+ * the given size (the last may be shorter) after routing, which is much cheaper than one message per datagram.
+ *
+ * The sender does not own the socket. It is not thread-safe; use one sender per thread.
+ */
+class PSB_SOCKUTILS_EXPORT udp_sender {
+public:
+    /**
+     * @brief Creates the sender.
+     *
+     * @param sock UDP socket, e.g. from `create_udp_socket()`.
+     * @param opts Sender options.
+     */
+    udp_sender(int sock, const udp_sender_options_t& opts);
+
+    /**
+     * @brief Queues a datagram to @a addr with the payload gathered from @a iov.
+     *
+     * @param addr Destination address.
+     * @param len Length of the destination address.
+     * @param iov Payload; the memory must stay valid until `flush()`.
+     * @return false if the queue is full; call `flush()` and try again.
+     */
+    bool add(const sockaddr_storage& addr, socklen_t len, std::span<const iovec> iov);
+
+    /**
+     * @brief Queues a datagram to @a addr with the payload @a data.
+     *
+     * @param addr Destination address.
+     * @param len Length of the destination address.
+     * @param data Payload; the memory must stay valid until `flush()`.
+     * @return false if the queue is full; call `flush()` and try again.
+     */
+    bool add(const sockaddr_storage& addr, socklen_t len, std::span<const std::byte> data);
+
+    /**
+     * @brief Queues @a data to be sent to @a addr as datagrams of @a segment_size bytes with `UDP_SEGMENT`.
+     *
+     * The kernel limits a segmented message to 64 KiB and 64 (or, in newer kernels, 128) segments; a message over
+     * the limits fails with `EINVAL`.
+     *
+     * @param addr Destination address.
+     * @param len Length of the destination address.
+     * @param data Payload; the memory must stay valid until `flush()`.
+     * @param segment_size Size of every datagram but the last one.
+     * @return false if the queue is full; call `flush()` and try again.
+     */
+    bool add_segmented(
+        const sockaddr_storage& addr, socklen_t len, std::span<const std::byte> data, std::uint16_t segment_size
+    );
+
+    /**
+     * @brief Sends all queued messages and empties the queue.
+     *
+     * A message which cannot be sent does not stop the others: its error is reported in its result. If the
+     * socket buffer is full (`EAGAIN`), all remaining messages fail with that error instead of being retried.
+     *
+     * @return One result per queued message, in the order the messages were queued. Valid until the next call.
+     */
+    std::span<const udp_send_result_t> flush() noexcept;
+
+    /**
+     * @brief Gets the number of queued messages.
+     */
+    [[nodiscard]] std::size_t pending() const noexcept;
+
+private:
+    void queue(const sockaddr_storage& addr, socklen_t len, std::span<const iovec> iov, std::uint16_t segment_size);
+
+    int m_sock;
+    std::size_t m_count = 0;
+    std::vector<sockaddr_storage> m_addrs;
+    std::vector<std::byte> m_control;
+    std::vector<mmsghdr> m_messages;
+    std::vector<std::size_t> m_first_iovec;
+    std::vector<iovec> m_iovecs;
+    std::vector<udp_send_result_t> m_results;
+};
+
+}  // namespace psb
+
+#endif /* B3DAE197_48C2_4A1D_B0BD_4896B2D327B7 */
@@ -0,0 +1,454 @@
+#include "uring_acceptor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <system_error>
+
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if __has_include(<linux/io_uring.h>)
+#    include <linux/io_uring.h>
+#endif
+
+#if defined(IORING_ACCEPT_MULTISHOT) && defined(IORING_FILE_INDEX_ALLOC) && defined(__NR_io_uring_setup)
+#    define PSB_SOCKUTILS_HAVE_IO_URING
+#endif
+
+namespace {
+
+constexpr unsigned int default_queue_depth = 256;
+
+void wait_readable(int fd, int timeout)
+{
+    pollfd pfd{.fd = fd, .events = POLLIN, .revents = 0};
+    if (poll(&pfd, 1, timeout) == -1 && errno != EINTR) [[unlikely]] {
+        throw std::system_error(errno, std::generic_category(), "poll() failed");
+    }
+}
+
+}  // namespace
+
+namespace psb {
+
+#if defined(PSB_SOCKUTILS_HAVE_IO_URING)
+
+/**
+ * Minimal io_uring: just enough to post a multishot accept and to reap its completions.
+ */
+struct uring_acceptor::ring {
+    static constexpr std::uint64_t accept_tag = 1;
+    static constexpr std::uint64_t cancel_tag = 2;
+
+    int fd = -1;
+    std::span<std::byte> sq_map;
+    std::span<std::byte> cq_map;
+    std::span<io_uring_sqe> sqes;
+    std::span<unsigned int> sq_array;
+    std::span<io_uring_cqe> cqes;
+
+    unsigned int* sq_tail  = nullptr;
+    unsigned int* sq_flags = nullptr;
+    unsigned int* cq_head  = nullptr;
+    unsigned int* cq_tail  = nullptr;
+    unsigned int sq_mask   = 0;
+    unsigned int cq_mask   = 0;
+    bool direct            = false;
+    bool armed             = false;
+
+    ring() noexcept = default;
+
+    ring(const ring&)            = delete;
+    ring(ring&&)                 = delete;
+    ring& operator=(const ring&) = delete;
+    ring& operator=(ring&&)      = delete;
+
+    ~ring() noexcept
+    {
+        if (this->fd != -1 && !this->direct) {
+            this->close_unreaped();
+        }
+
+        if (!this->sqes.empty()) {
+            munmap(this->sqes.data(), this->sqes.size_bytes());
+        }
+
+        if (!this->cq_map.empty() && this->cq_map.data() != this->sq_map.data()) {
+            munmap(this->cq_map.data(), this->cq_map.size());
+        }
+
+        if (!this->sq_map.empty()) {
+            munmap(this->sq_map.data(), this->sq_map.size());
+        }
+
+        close(this->fd);
+    }
+
+    /**
+     * Sets up a ring with @a cq_entries completion entries; returns nullptr if io_uring is not available.
+     */
+    static std::unique_ptr<ring> create(unsigned int cq_entries, unsigned int direct_descriptors)
+    {
+        io_uring_params params{};
+        params.flags      = IORING_SETUP_CQSIZE;
+        params.cq_entries = cq_entries;
+
+        // Only one request is ever submitted at a time
+        const auto fd = static_cast<int>(syscall(__NR_io_uring_setup, 2, &params));
+        if (fd == -1) {
+            const auto err = errno;
+            if (err == ENOSYS || err == EPERM || err == EINVAL) {
+                // Not supported by the kernel, or disabled by sysctl / seccomp
+                return nullptr;
+            }
+
+            throw std::system_error(err, std::generic_category(), "io_uring_setup() failed");
+        }
+
+        auto result = std::make_unique<ring>();
+        result->fd  = fd;
+        result->map(params);
+
+        if (direct_descriptors != 0 && !result->register_files(direct_descriptors)) {
+            return nullptr;
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] bool has_completions() const noexcept
+    {
+        return std::atomic_ref(*this->cq_head).load(std::memory_order_relaxed) !=
+               std::atomic_ref(*this->cq_tail).load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns the oldest unconsumed completion, or nullptr if there is none.
+     */
+    [[nodiscard]] const io_uring_cqe* peek()
+    {
+        if (!this->has_completions()) {
+            if ((std::atomic_ref(*this->sq_flags).load(std::memory_order_relaxed) & IORING_SQ_CQ_OVERFLOW) == 0) {
+                return nullptr;
+            }
+
+            // Completions which did not fit into the ring are flushed into it by the kernel on request
+            this->enter(0, IORING_ENTER_GETEVENTS);
+            if (!this->has_completions()) {
+                return nullptr;
+            }
+        }
+
+        const auto head = std::atomic_ref(*this->cq_head).load(std::memory_order_relaxed);
+        return &this->cqes[head & this->cq_mask];
+    }
+
+    void advance() noexcept
+    {
+        const auto head = std::atomic_ref(*this->cq_head).load(std::memory_order_relaxed);
+        std::atomic_ref(*this->cq_head).store(head + 1, std::memory_order_release);
+    }
+
+    void submit_accept(int sock)
+    {
+        const auto tail = std::atomic_ref(*this->sq_tail).load(std::memory_order_relaxed);
+        const auto idx  = tail & this->sq_mask;
+
+        auto& sqe        = this->sqes[idx];
+        sqe              = {};
+        sqe.opcode       = IORING_OP_ACCEPT;
+        sqe.fd           = sock;
+        sqe.ioprio       = IORING_ACCEPT_MULTISHOT;
+        sqe.accept_flags = this->direct ? SOCK_NONBLOCK : SOCK_NONBLOCK | SOCK_CLOEXEC;
+        sqe.user_data    = accept_tag;
+        if (this->direct) {
+            sqe.file_index = IORING_FILE_INDEX_ALLOC;
+        }
+
+        this->sq_array[idx] = idx;
+        std::atomic_ref(*this->sq_tail).store(tail + 1, std::memory_order_release);
+
+        this->enter(1, 0);
+        this->armed = true;
+    }
+
+private:
+    /**
+     * Cancels the accept request and closes the sockets it has accepted but nobody has reaped: the kernel installs
+     * them in the process file table whether or not the completions are consumed. Direct descriptors go away with
+     * the registered file table, so they need no cleanup.
+     */
+    void close_unreaped() noexcept
+    {
+        auto terminated = !this->armed;
+        auto cancelled  = terminated;
+        if (!terminated) {
+            const auto tail = std::atomic_ref(*this->sq_tail).load(std::memory_order_relaxed);
+            const auto idx  = tail & this->sq_mask;
+
+            auto& sqe     = this->sqes[idx];
+            sqe           = {};
+            sqe.opcode    = IORING_OP_ASYNC_CANCEL;
+            sqe.fd        = -1;
+            sqe.addr      = accept_tag;
+            sqe.user_data = cancel_tag;
+
+            this->sq_array[idx] = idx;
+            std::atomic_ref(*this->sq_tail).store(tail + 1, std::memory_order_release);
+
+            if (this->try_enter(1, 0, 0) != 0) [[unlikely]] {
+                // Only the completions already posted can be closed
+                terminated = cancelled = true;
+            }
+        }
+
+        for (;;) {
+            while (this->has_completions()) {
+                const auto head = std::atomic_ref(*this->cq_head).load(std::memory_order_relaxed);
+                const auto& cqe = this->cqes[head & this->cq_mask];
+                if (cqe.user_data == accept_tag) {
+                    if (cqe.res >= 0) {
+                        close(cqe.res);
+                    }
+
+                    terminated = terminated || (cqe.flags & IORING_CQE_F_MORE) == 0;
+                }
+                else if (cqe.user_data == cancel_tag) {
+                    cancelled = true;
+                }
+
+                this->advance();
+            }
+
+            const auto overflow =
+                (std::atomic_ref(*this->sq_flags).load(std::memory_order_relaxed) & IORING_SQ_CQ_OVERFLOW) != 0;
+            if (terminated && cancelled && !overflow) {
+                return;
+            }
+
+            // Waits for the final completion of the accept request, or flushes the overflowed ones
+            if (this->try_enter(0, overflow ? 0 : 1, IORING_ENTER_GETEVENTS) != 0) [[unlikely]] {
+                return;
+            }
+        }
+    }
+
+    void map(const io_uring_params& params)
+    {
+        const auto sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        const auto cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const auto single  = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+        this->sq_map = this->map_region(single ? std::max(sq_size, cq_size) : sq_size, IORING_OFF_SQ_RING);
+        this->cq_map = single ? this->sq_map : this->map_region(cq_size, IORING_OFF_CQ_RING);
+
+        const auto sqes_map = this->map_region(params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        this->sqes = {reinterpret_cast<io_uring_sqe*>(sqes_map.data()), params.sq_entries};
+
+        // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+        this->sq_tail  = reinterpret_cast<unsigned int*>(this->sq_map.subspan(params.sq_off.tail).data());
+        this->sq_flags = reinterpret_cast<unsigned int*>(this->sq_map.subspan(params.sq_off.flags).data());
+        this->sq_mask  = *reinterpret_cast<unsigned int*>(this->sq_map.subspan(params.sq_off.ring_mask).data());
+        this->sq_array = {
+            reinterpret_cast<unsigned int*>(this->sq_map.subspan(params.sq_off.array).data()), params.sq_entries
+        };
+
+        this->cq_head = reinterpret_cast<unsigned int*>(this->cq_map.subspan(params.cq_off.head).data());
+        this->cq_tail = reinterpret_cast<unsigned int*>(this->cq_map.subspan(params.cq_off.tail).data());
+        this->cq_mask = *reinterpret_cast<unsigned int*>(this->cq_map.subspan(params.cq_off.ring_mask).data());
+        this->cqes    = {
+            reinterpret_cast<io_uring_cqe*>(this->cq_map.subspan(params.cq_off.cqes).data()), params.cq_entries
+        };
+        // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+
+    [[nodiscard]] std::span<std::byte> map_region(std::size_t size, off_t offset) const
+    {
+        auto* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd, offset);
+        if (ptr == MAP_FAILED) [[unlikely]] {
+            throw std::system_error(errno, std::generic_category(), "mmap(io_uring) failed");
+        }
+
+        return {static_cast<std::byte*>(ptr), size};
+    }
+
+    bool register_files(unsigned int count)
+    {
+        io_uring_rsrc_register reg{};
+        reg.nr    = count;
+        reg.flags = IORING_RSRC_REGISTER_SPARSE;
+
+        if (syscall(__NR_io_uring_register, this->fd, IORING_REGISTER_FILES2, &reg, sizeof(reg)) != 0) {
+            const auto err = errno;
+            if (err == EINVAL) {
+                // Sparse file tables need Linux 5.19
+                return false;
+            }
+
+            throw std::system_error(err, std::generic_category(), "io_uring_register(IORING_REGISTER_FILES2) failed");
+        }
+
+        this->direct = true;
+        return true;
+    }
+
+    /**
+     * Calls `io_uring_enter()`; returns 0 or the error.
+     */
+    int try_enter(unsigned int to_submit, unsigned int min_complete, unsigned int flags) noexcept
+    {
+        long res{};
+        do {
+            res = syscall(__NR_io_uring_enter, this->fd, to_submit, min_complete, flags, nullptr, 0);
+        } while (res == -1 && errno == EINTR);
+
+        return res == -1 ? errno : 0;
+    }
+
+    void enter(unsigned int to_submit, unsigned int flags)
+    {
+        if (const auto err = this->try_enter(to_submit, 0, flags); err != 0) [[unlikely]] {
+            throw std::system_error(err, std::generic_category(), "io_uring_enter() failed");
+        }
+    }
+};
+
+#else
+
+struct uring_acceptor::ring {};
+
+#endif
+
+uring_acceptor::uring_acceptor(int sock, const uring_acceptor_options_t& opts)
+    : m_sock(sock), m_opts(opts),
+      m_socket_options(opts.socket_options != nullptr ? *opts.socket_options : socket_options_t{})
+{
+    this->m_opts.socket_options = nullptr;
+
+#if defined(PSB_SOCKUTILS_HAVE_IO_URING)
+    const auto queue_depth = this->m_opts.queue_depth != 0 ? this->m_opts.queue_depth : default_queue_depth;
+
+    this->m_ring = ring::create(queue_depth, this->m_opts.direct_descriptors);
+    if (this->m_ring) {
+        this->m_ring->submit_accept(this->m_sock);
+
+        // Kernels without multishot accept (or without IORING_OP_ACCEPT at all) reject the request right away
+        if (const auto* cqe = this->m_ring->peek(); cqe != nullptr && cqe->res == -EINVAL) {
+            this->m_ring.reset();
+        }
+    }
+#endif
+}
+
+uring_acceptor::~uring_acceptor() noexcept = default;
+
+bool uring_acceptor::is_multishot() const noexcept
+{
+    return this->m_ring != nullptr;
+}
+
+int uring_acceptor::ring_fd() const noexcept
+{
+#if defined(PSB_SOCKUTILS_HAVE_IO_URING)
+    if (this->m_ring) {
+        return this->m_ring->fd;
+    }
+#endif
+
+    return -1;
+}
+
+accept_batch_result_t uring_acceptor::accept_connections(std::span<raw_accepted_socket_t> sockets, int timeout)
+{
+#if defined(PSB_SOCKUTILS_HAVE_IO_URING)
+    if (this->m_ring) {
+        auto& uring = *this->m_ring;
+        if (timeout != 0 && !uring.has_completions()) {
+            wait_readable(uring.fd, timeout);
+        }
+
+        accept_batch_result_t result{};
+        while (result.count < sockets.size()) {
+            const auto* cqe = uring.peek();
+            if (cqe == nullptr) {
+                break;
+            }
+
+            const auto res  = cqe->res;
+            const auto more = (cqe->flags & IORING_CQE_F_MORE) != 0;
+            const auto ours = cqe->user_data == ring::accept_tag;
+            uring.advance();
+
+            if (!ours) {
+                continue;
+            }
+
+            if (!more) {
+                // The kernel has terminated the multishot request (e.g., because of an error or a CQ overflow)
+                uring.armed = false;
+            }
+
+            if (res >= 0) {
+                auto& accepted = sockets[result.count++];
+                accepted       = {.sock = res, .addr = {}, .addr_len = 0};
+                if (this->m_opts.peer_address != 0 && !uring.direct) {
+                    accepted.addr_len = sizeof(accepted.addr);
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                    if (getpeername(res, reinterpret_cast<sockaddr*>(&accepted.addr), &accepted.addr_len) != 0) {
+                        accepted.addr_len = 0;
+                    }
+                }
+            }
+            else if (res != -ECONNABORTED && res != -EPROTO && res != -EAGAIN && res != -EINTR) {
+                result.error = std::error_code(-res, std::system_category());
+                break;
+            }
+        }
+
+        if (!uring.armed) {
+            uring.submit_accept(this->m_sock);
+        }
+
+        if (!uring.direct) {
+            this->set_accepted_options(sockets.first(result.count), result);
+        }
+
+        return result;
+    }
+#endif
+
+    if (timeout != 0) {
+        wait_readable(this->m_sock, timeout);
+    }
+
+    auto result = psb::accept_connections(this->m_sock, sockets, sockets.size());
+    this->set_accepted_options(sockets.first(result.count), result);
+    return result;
+}
+
+void uring_acceptor::set_accepted_options(std::span<const raw_accepted_socket_t> sockets, accept_batch_result_t& result)
+    const noexcept
+{
+    if (this->m_socket_options.quick_ack == 0) {
+        return;
+    }
+
+    for (const auto& accepted : sockets) {
+        std::error_code ec;
+        set_accepted_socket_options(accepted.sock, this->m_socket_options, ec);
+        if (ec && !result.error) [[unlikely]] {
+            result.error = ec;
+        }
+    }
+}
+
+}  // namespace psb
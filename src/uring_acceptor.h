@@ -0,0 +1,102 @@
+#ifndef FB591187_DF84_4113_A754_6A8A9E555825
+#define FB591187_DF84_4113_A754_6A8A9E555825
+
+#include <memory>
+#include <span>
+
+#include "export.h"
+#include "sockutils.h"
+
+namespace psb {
+
+struct uring_acceptor_options_t {
+    unsigned int queue_depth;                  // Size of the completion queue; 0 selects the default
+    unsigned int direct_descriptors;           // Size of the registered file table for direct descriptors; 0: none
+    int peer_address;                          // Whether to fetch peer addresses (a getpeername() per connection)
+    const socket_options_t* socket_options{};  // Options of the listener; the non-inherited ones are set per socket
+};
+
+/**
+ * @brief Accepts connections on a listening socket with a multishot io_uring accept.
+ *
+ * A single submission keeps producing accepted sockets (non-blocking and close-on-exec) until it is cancelled,
+ * so the kernel does the accepting without a system call per connection. Completions are reaped from the shared
+ * ring without entering the kernel at all when connections are already waiting.
+ *
+ * Multishot accept does not report peer addresses. When `peer_address` is set, they are obtained with
+ * `getpeername()`; otherwise `addr_len` of the accepted sockets is zero.
+ *
+ * When `direct_descriptors` is non-zero, the accepted sockets are installed into the ring's registered file table
+ * instead of the process file table: `sock` is then an index into that table, usable only by operations submitted
+ * to `ring_fd()` with `IOSQE_FIXED_FILE`, and peer addresses are not available.
+ *
+ * With `socket_options`, the options accepted sockets do not inherit from the listener (`quick_ack`) are set on
+ * every accepted socket, as `set_accepted_socket_options()` does; a failure is reported in `error` of the batch,
+ * with the socket still returned. Direct descriptors are not accessible to `setsockopt()`, so they are left alone.
+ *
+ * On kernels without io_uring or multishot accept (before 5.19), or if io_uring is disabled, the acceptor falls
+ * back to `poll()` and `accept_connections()`; `is_multishot()` tells which path is in use.
+ *
+ * The kernel accepts connections whether or not they are collected. Destroying the acceptor cancels the request and
+ * closes the sockets accepted but not yet collected, so that they are neither leaked nor left open.
+ */
+class PSB_SOCKUTILS_EXPORT uring_acceptor {
+public:
+    /**
+     * @brief Sets up the ring and posts the multishot accept request.
+     *
+     * @param sock Listening socket; must outlive the acceptor.
+     * @param opts Acceptor options.
+     * @throw std::system_error Call to a system API failed.
+     */
+    uring_acceptor(int sock, const uring_acceptor_options_t& opts);
+    ~uring_acceptor() noexcept;
+
+    uring_acceptor(const uring_acceptor&)            = delete;
+    uring_acceptor(uring_acceptor&&)                 = delete;
+    uring_acceptor& operator=(const uring_acceptor&) = delete;
+    uring_acceptor& operator=(uring_acceptor&&)      = delete;
+
+    /**
+     * @brief Whether connections are accepted with io_uring multishot accept (as opposed to the fallback path).
+     */
+    [[nodiscard]] bool is_multishot() const noexcept;
+
+    /**
+     * @brief Gets the io_uring file descriptor; -1 on the fallback path.
+     *
+     * The descriptor becomes readable when accepted connections are waiting, so it can be watched with epoll.
+     */
+    [[nodiscard]] int ring_fd() const noexcept;
+
+    /**
+     * @brief Collects accepted connections, waiting up to @a timeout milliseconds for the first one.
+     *
+     * Like `psb::accept_connections()`, the function does not throw on accept errors, but reports them.
+     *
+     * @param sockets Storage for the accepted sockets; the first `count` elements are filled in.
+     * @param timeout Maximum time to wait if no connections are waiting, in milliseconds; 0 does not wait,
+     * -1 waits indefinitely.
+     * @return Number of accepted sockets and the error which stopped the batch, if any.
+     * @throw std::system_error Failed to wait for or to re-post the accept request.
+     */
+    accept_batch_result_t accept_connections(std::span<raw_accepted_socket_t> sockets, int timeout);
+
+private:
+    struct ring;
+
+    /**
+     * Sets the non-inherited socket options on the accepted @a sockets; reports a failure in @a result.
+     */
+    void set_accepted_options(std::span<const raw_accepted_socket_t> sockets, accept_batch_result_t& result)
+        const noexcept;
+
+    int m_sock;
+    uring_acceptor_options_t m_opts;
+    socket_options_t m_socket_options;
+    std::unique_ptr<ring> m_ring;
+};
+
+}  // namespace psb
+
+#endif /* FB591187_DF84_4113_A754_6A8A9E555825 */
@@ -0,0 +1,165 @@
+#include "zerocopy_receiver.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <system_error>
+
+#include <linux/tcp.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t default_map_size  = 2U << 20U;
+constexpr std::size_t default_copy_size = 64U << 10U;
+
+std::size_t round_to_pages(std::size_t size) noexcept
+{
+    const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return (size + page - 1) / page * page;
+}
+
+int get_zerocopy_receive(int sock, tcp_zerocopy_receive& zc, socklen_t len) noexcept
+{
+    int res{};
+    do {
+        res = getsockopt(sock, IPPROTO_TCP, TCP_ZEROCOPY_RECEIVE, &zc, &len);
+    } while (res == -1 && errno == EINTR);
+
+    return res;
+}
+
+}  // namespace
+
+namespace psb {
+
+zerocopy_receiver::zerocopy_receiver(int sock, const zerocopy_receiver_options_t& opts)
+    : m_sock(sock), m_map_size(round_to_pages(opts.map_size != 0 ? opts.map_size : default_map_size)),
+      m_copy(opts.copy_size != 0 ? opts.copy_size : default_copy_size)
+{
+    // Mapping the socket reserves the address range; TCP_ZEROCOPY_RECEIVE fills it with the received pages
+    if (auto* map = mmap(nullptr, this->m_map_size, PROT_READ, MAP_SHARED, sock, 0); map != MAP_FAILED) {
+        this->m_map = map;
+    }
+}
+
+zerocopy_receiver::~zerocopy_receiver() noexcept
+{
+    if (this->m_map != nullptr) {
+        munmap(this->m_map, this->m_map_size);
+    }
+}
+
+std::span<const std::byte> zerocopy_receiver::copy(std::size_t len, bool& eof, std::error_code& ec) noexcept
+{
+    ssize_t res{};
+    do {
+        res = recv(this->m_sock, this->m_copy.data(), std::min(len, this->m_copy.size()), MSG_DONTWAIT);
+    } while (res == -1 && errno == EINTR);
+
+    if (res == -1) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) [[unlikely]] {
+            ec.assign(errno, std::generic_category());
+        }
+
+        return {};
+    }
+
+    eof = res == 0;
+    return std::span<const std::byte>(this->m_copy).first(static_cast<std::size_t>(res));
+}
+
+zerocopy_receive_result_t zerocopy_receiver::receive(std::error_code& ec) noexcept
+{
+    ec.clear();
+
+    zerocopy_receive_result_t result{};
+    if (this->m_map == nullptr) {
+        result.copied = this->copy(this->m_copy.size(), result.eof, ec);
+        return result;
+    }
+
+    tcp_zerocopy_receive zc{};
+    zc.address = reinterpret_cast<std::uintptr_t>(this->m_map);  // NOLINT(*-pro-type-reinterpret-cast)
+    zc.length  = static_cast<std::uint32_t>(this->m_map_size);
+
+    // Without the copy buffer, the request ends where its fields start
+    constexpr socklen_t short_len = offsetof(tcp_zerocopy_receive, copybuf_address);
+
+    int res{};
+    if (this->m_copybuf) {
+        zc.copybuf_address = reinterpret_cast<std::uintptr_t>(this->m_copy.data());  // NOLINT(*-type-reinterpret-cast)
+        zc.copybuf_len     = static_cast<std::int32_t>(this->m_copy.size());
+
+        res = get_zerocopy_receive(this->m_sock, zc, sizeof(zc));
+        if (res == -1 && errno == EINVAL) {
+            // Kernels before 5.11 reject the fields they do not know unless they are zero: retry without them
+            zc.copybuf_address = 0;
+            zc.copybuf_len     = 0;
+            res                = get_zerocopy_receive(this->m_sock, zc, short_len);
+            this->m_copybuf    = false;
+        }
+    }
+    else {
+        res = get_zerocopy_receive(this->m_sock, zc, short_len);
+    }
+
+    if (res == -1) {
+        if (errno == EINVAL || errno == EOPNOTSUPP || errno == ENOPROTOOPT) {
+            // Not supported by this kernel: read the ordinary way from now on
+            munmap(this->m_map, this->m_map_size);
+            this->m_map   = nullptr;
+            result.copied = this->copy(this->m_copy.size(), result.eof, ec);
+        }
+        else if (errno == EIO) {
+            // The queue is empty and the peer has closed the connection; recv() reports end of stream or the error
+            result.copied = this->copy(this->m_copy.size(), result.eof, ec);
+        }
+        else if (errno != EAGAIN) [[unlikely]] {
+            ec.assign(errno, std::generic_category());
+        }
+
+        return result;
+    }
+
+    if (zc.err != 0) [[unlikely]] {
+        ec.assign(zc.err, std::generic_category());
+        return result;
+    }
+
+    result.mapped = std::span<const std::byte>(static_cast<const std::byte*>(this->m_map), zc.length);
+    if (zc.copybuf_len > 0) {
+        result.copied = std::span<const std::byte>(this->m_copy).first(static_cast<std::size_t>(zc.copybuf_len));
+    }
+    else if (zc.recv_skip_hint > 0 || zc.length == 0) {
+        // Data the kernel could not map: the unaligned tail, or everything if the payload is not in whole pages.
+        // With nothing mapped, this also tells end of stream from an empty queue
+        const auto tail = zc.recv_skip_hint > 0 ? zc.recv_skip_hint : this->m_copy.size();
+        result.copied   = this->copy(tail, result.eof, ec);
+    }
+
+    return result;
+}
+
+zerocopy_receive_result_t zerocopy_receiver::receive()
+{
+    std::error_code ec;
+    const auto result = this->receive(ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, "getsockopt(TCP_ZEROCOPY_RECEIVE) failed");
+    }
+
+    return result;
+}
+
+bool zerocopy_receiver::is_zerocopy() const noexcept
+{
+    return this->m_map != nullptr;
+}
+
+}  // namespace psb
@@ -0,0 +1,96 @@
+#ifndef B7B0FA1F_E19D_417D_96F4_8FCF08BAE7B4
+#define B7B0FA1F_E19D_417D_96F4_8FCF08BAE7B4
+
+#include <cstddef>
+#include <span>
+#include <system_error>
+#include <vector>
+
+#include "export.h"
+
+namespace psb {
+
+struct zerocopy_receiver_options_t {
+    std::size_t map_size;   // Address space mapped for received pages; 0 selects the default (2 MiB)
+    std::size_t copy_size;  // Buffer for data which cannot be mapped; 0 selects the default (64 KiB)
+};
+
+/**
+ * Data returned by one `zerocopy_receiver::receive()` call, in stream order: first `mapped`, then `copied`.
+ * Both are only valid until the next call.
+ */
+struct zerocopy_receive_result_t {
+    std::span<const std::byte> mapped;  // Payload pages mapped from the socket into the receiver's address range
+    std::span<const std::byte> copied;  // Payload copied the ordinary way: the unaligned tail or small reads
+    bool eof{};                         // The peer has closed its side of the connection
+};
+
+/**
+ * @brief Receives from a TCP socket with `TCP_ZEROCOPY_RECEIVE`, mapping payload pages instead of copying them.
+ *
+ * The receiver reserves a read-only mapping of the socket. Each `receive()` asks the kernel to map the whole
+ * pages of received payload into it and copies the rest (data which does not fill a page, or not aligned to one)
+ * into an ordinary buffer, in the same system call where the kernel supports it. The next `receive()` replaces
+ * the mapped pages, and the destructor unmaps them, so the returned spans never outlive the pages.
+ *
+ * Zero-copy receive needs Linux 4.18 and payload in whole pages, which in practice means an MTU of at least 4 KiB
+ * plus header split on the NIC. Kernels before 5.11 reject the copy buffer, so the receiver maps only and copies
+ * the rest with `recv()` there. If the kernel does not support zero-copy receive at all, the receiver falls back to
+ * plain `recv()` into the copy buffer.
+ *
+ * The receiver does not own the socket. It is not thread-safe.
+ */
+class PSB_SOCKUTILS_EXPORT zerocopy_receiver {
+public:
+    /**
+     * @brief Creates the receiver; if the socket cannot be mapped, the receiver uses plain reads.
+     *
+     * @param sock Connected TCP socket, e.g. from `accept_connection()`.
+     * @param opts Receiver options.
+     */
+    zerocopy_receiver(int sock, const zerocopy_receiver_options_t& opts);
+
+    /**
+     * @brief Unmaps the received pages.
+     */
+    ~zerocopy_receiver() noexcept;
+
+    zerocopy_receiver(const zerocopy_receiver&)            = delete;
+    zerocopy_receiver(zerocopy_receiver&&)                 = delete;
+    zerocopy_receiver& operator=(const zerocopy_receiver&) = delete;
+    zerocopy_receiver& operator=(zerocopy_receiver&&)      = delete;
+
+    /**
+     * @brief Receives the data which is available, without blocking.
+     *
+     * @return The received data; both spans are empty if there was none (or at end of stream).
+     * @throw std::system_error A system call failed.
+     */
+    zerocopy_receive_result_t receive();
+
+    /**
+     * @brief Receives the data which is available, without blocking; non-throwing variant.
+     *
+     * @param ec Set to the error if a system call failed, cleared otherwise.
+     * @return The received data; both spans are empty if there was none (or at end of stream).
+     */
+    zerocopy_receive_result_t receive(std::error_code& ec) noexcept;
+
+    /**
+     * @brief Tells whether the receiver maps pages or has fallen back to plain reads.
+     */
+    [[nodiscard]] bool is_zerocopy() const noexcept;
+
+private:
+    std::span<const std::byte> copy(std::size_t len, bool& eof, std::error_code& ec) noexcept;
+
+    int m_sock;
+    void* m_map = nullptr;
+    std::size_t m_map_size;
+    std::vector<std::byte> m_copy;
+    bool m_copybuf = true;  // Whether the kernel accepts the copy buffer in TCP_ZEROCOPY_RECEIVE
+};
+
+}  // namespace psb
+
+#endif /* B7B0FA1F_E19D_417D_96F4_8FCF08BAE7B4 */
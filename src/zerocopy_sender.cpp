@@ -0,0 +1,195 @@
+#include "zerocopy_sender.h"
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <system_error>
+
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+namespace {
+
+// Below this size, pinning the pages and handling the notification cost more than the copy
+constexpr std::size_t default_copy_threshold = 16384;
+constexpr std::size_t default_max_pending    = 1024;
+
+struct completion_t {
+    std::uint32_t first;
+    std::uint32_t last;
+    bool copied;
+};
+
+enum class queue_entry { none, completion, other };
+
+/**
+ * Reads one message from the error queue of @a sock; for a zero-copy completion notification, stores it in
+ * @a completion.
+ */
+queue_entry read_error_queue(int sock, completion_t& completion)
+{
+    alignas(cmsghdr) std::array<std::byte, CMSG_SPACE(sizeof(sock_extended_err)) + CMSG_SPACE(sizeof(sockaddr_in6))>
+        control{};
+
+    msghdr msg{};
+    msg.msg_control    = control.data();
+    msg.msg_controllen = control.size();
+
+    ssize_t res{};
+    do {
+        res = recvmsg(sock, &msg, MSG_ERRQUEUE | MSG_DONTWAIT);
+    } while (res == -1 && errno == EINTR);
+
+    if (res == -1) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return queue_entry::none;
+        }
+
+        throw std::system_error(errno, std::generic_category(), "recvmsg(MSG_ERRQUEUE) failed");
+    }
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-cstyle-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    for (auto* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        const auto is_recverr = (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                                (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+        if (!is_recverr) {
+            continue;
+        }
+
+        sock_extended_err err{};
+        std::memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+        if (err.ee_origin == SO_EE_ORIGIN_ZEROCOPY && err.ee_errno == 0) {
+            completion.first  = err.ee_info;
+            completion.last   = err.ee_data;
+            completion.copied = (err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0;
+            return queue_entry::completion;
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-pro-type-cstyle-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    return queue_entry::other;
+}
+
+}  // namespace
+
+namespace psb {
+
+zerocopy_sender::zerocopy_sender(int sock, const zerocopy_sender_options_t& opts)
+    : m_sock(sock), m_copy_threshold(opts.copy_threshold != 0 ? opts.copy_threshold : default_copy_threshold),
+      m_pending(opts.max_pending != 0 ? opts.max_pending : default_max_pending)
+{
+    constexpr int enable = 1;
+    if (setsockopt(sock, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) == -1) [[unlikely]] {
+        if (errno != ENOPROTOOPT) {
+            throw std::system_error(errno, std::generic_category(), "setsockopt(SO_ZEROCOPY) failed");
+        }
+
+        // The kernel would accept MSG_ZEROCOPY, but copy the data and never report a completion
+        this->m_zerocopy = false;
+    }
+}
+
+zerocopy_send_result_t
+zerocopy_sender::send(std::span<const std::byte> data, std::uint64_t tag, std::error_code& ec) noexcept
+{
+    ec.clear();
+
+    auto zerocopy = this->m_zerocopy && data.size() >= this->m_copy_threshold && this->m_count < this->m_pending.size();
+    ssize_t res{};
+    for (;;) {
+        const auto flags = MSG_DONTWAIT | MSG_NOSIGNAL | (zerocopy ? MSG_ZEROCOPY : 0);
+        res              = ::send(this->m_sock, data.data(), data.size(), flags);
+        if (res != -1) {
+            break;
+        }
+
+        if (errno == ENOBUFS && zerocopy) {
+            // Out of option memory for the notifications: copy this time
+            zerocopy = false;
+        }
+        else if (errno != EINTR) {
+            ec.assign(errno, std::generic_category());
+            return {};
+        }
+    }
+
+    if (zerocopy) {
+        // Every successful zero-copy send() takes the next ID, even if it ends up sending fewer bytes
+        this->m_pending[(this->m_head + this->m_count) % this->m_pending.size()] = {.tag = tag, .done = false};
+        ++this->m_count;
+        ++this->m_outstanding;
+        ++this->m_next_id;
+    }
+
+    return {.bytes = static_cast<std::size_t>(res), .zerocopy = zerocopy};
+}
+
+zerocopy_send_result_t zerocopy_sender::send(std::span<const std::byte> data, std::uint64_t tag)
+{
+    std::error_code ec;
+    const auto result = this->send(data, tag, ec);
+    if (ec) [[unlikely]] {
+        throw std::system_error(ec, "send(MSG_ZEROCOPY) failed");
+    }
+
+    return result;
+}
+
+std::size_t zerocopy_sender::process_completions(const completion_callback_t& on_complete)
+{
+    std::size_t count = 0;
+    completion_t completion{};
+    for (;;) {
+        const auto entry = read_error_queue(this->m_sock, completion);
+        if (entry == queue_entry::none) {
+            break;
+        }
+
+        if (entry == queue_entry::other) {
+            continue;
+        }
+
+        // The IDs are consecutive, so the offset of an ID from the oldest one is its position in the ring; the
+        // unsigned arithmetic handles the wrap-around at 2^32
+        const auto oldest = this->m_next_id - static_cast<std::uint32_t>(this->m_count);
+        const auto first  = completion.first - oldest;
+        const auto last   = completion.last - oldest;
+        for (auto offset = first; offset - first <= last - first && offset < this->m_count; ++offset) {
+            auto& sent = this->m_pending[(this->m_head + offset) % this->m_pending.size()];
+            if (sent.done) {
+                continue;
+            }
+
+            // Marked before the callback, which may send (and thus append) more
+            sent.done = true;
+            --this->m_outstanding;
+            ++count;
+            on_complete(sent.tag, completion.copied);
+        }
+
+        // Completions normally arrive in order, but a retransmitted send can complete late: only the completed
+        // sends at the front leave the ring
+        while (this->m_count > 0 && this->m_pending[this->m_head].done) {
+            this->m_head = (this->m_head + 1) % this->m_pending.size();
+            --this->m_count;
+        }
+    }
+
+    return count;
+}
+
+std::size_t zerocopy_sender::pending() const noexcept
+{
+    return this->m_outstanding;
+}
+
+bool zerocopy_sender::is_zerocopy() const noexcept
+{
+    return this->m_zerocopy;
+}
+
+}  // namespace psb
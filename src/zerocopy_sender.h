@@ -0,0 +1,124 @@
+#ifndef F8F6619D_3932_4AAC_BE5B_A3DDDF517C9F
+#define F8F6619D_3932_4AAC_BE5B_A3DDDF517C9F
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <system_error>
+#include <vector>
+
+#include "export.h"
+
+namespace psb {
+
+struct zerocopy_sender_options_t {
+    std::size_t copy_threshold;  // Writes shorter than this are copied as usual; 0 selects the default (16 KiB)
+    std::size_t max_pending{};   // Zero-copy sends awaiting completion at most; 0 selects the default (1024)
+};
+
+struct zerocopy_send_result_t {
+    std::size_t bytes{};  // Bytes sent; may be fewer than requested, as with send()
+    bool zerocopy{};      // The buffer stays in use until the completion for the send is reported
+};
+
+/**
+ * @brief Sends large buffers on a TCP socket with `MSG_ZEROCOPY`, tracking when they can be reused.
+ *
+ * With zero-copy, the kernel sends directly from the pages of the caller's buffer instead of copying it, so the
+ * buffer must not be modified or freed until the kernel reports that it is done with it. The reports arrive on the
+ * socket error queue (the socket polls as `POLLERR`); `process_completions()` reads them and hands the tag of every
+ * completed send to a callback.
+ *
+ * Pinning pages and handling the completion costs more than copying a small buffer, so writes shorter than
+ * `copy_threshold` are sent the ordinary way. Their buffers can be reused as soon as `send()` returns. So are
+ * writes while `max_pending` sends await completion: the sender tracks them in storage allocated up front, and
+ * `send()` never allocates.
+ *
+ * Kernels before 4.14 lack `SO_ZEROCOPY` but accept `MSG_ZEROCOPY`, copying the data and never reporting
+ * a completion. On them the sender copies every write, and `is_zerocopy()` returns `false`.
+ *
+ * The sender does not own the socket. It is not thread-safe.
+ */
+class PSB_SOCKUTILS_EXPORT zerocopy_sender {
+public:
+    /**
+     * @brief Called with the tag of a completed send. @a copied is set if the kernel had to copy the data
+     * after all (e.g., over loopback), in which case zero-copy only adds overhead for this socket.
+     */
+    using completion_callback_t = std::function<void(std::uint64_t tag, bool copied)>;
+
+    /**
+     * @brief Creates the sender and enables `SO_ZEROCOPY` on @a sock.
+     *
+     * @param sock Connected TCP socket, e.g. from `accept_connection()`.
+     * @param opts Sender options.
+     * @throw std::system_error Enabling `SO_ZEROCOPY` failed for a reason other than the kernel not knowing it.
+     */
+    zerocopy_sender(int sock, const zerocopy_sender_options_t& opts);
+
+    /**
+     * @brief Sends @a data without blocking, with zero-copy if it is long enough.
+     *
+     * If only part of @a data is sent, the caller sends the rest with another call; a buffer sent in parts can be
+     * reused when the completions of all parts (which may share the tag) have been reported.
+     *
+     * @param data Data to send.
+     * @param tag Value passed to the completion callback; e.g., the index of the buffer.
+     * @return Bytes sent and whether a completion will be reported.
+     * @throw std::system_error Call to `send()` failed (`EAGAIN` included).
+     */
+    zerocopy_send_result_t send(std::span<const std::byte> data, std::uint64_t tag);
+
+    /**
+     * @brief Sends @a data without blocking, with zero-copy if it is long enough; non-throwing variant.
+     *
+     * @param data Data to send.
+     * @param tag Value passed to the completion callback; e.g., the index of the buffer.
+     * @param ec Set to the error if the call to `send()` failed, cleared otherwise.
+     * @return Bytes sent and whether a completion will be reported; zeros on failure.
+     */
+    zerocopy_send_result_t send(std::span<const std::byte> data, std::uint64_t tag, std::error_code& ec) noexcept;
+
+    /**
+     * @brief Reads the pending completion notifications and invokes @a on_complete for every completed send.
+     *
+     * Does not block. The callback may call `send()`.
+     *
+     * @param on_complete Completion callback.
+     * @return Number of completed sends.
+     * @throw std::system_error Reading the error queue failed.
+     */
+    std::size_t process_completions(const completion_callback_t& on_complete);
+
+    /**
+     * @brief Gets the number of zero-copy sends whose completion has not been reported yet.
+     */
+    [[nodiscard]] std::size_t pending() const noexcept;
+
+    /**
+     * @brief Tells whether the kernel supports zero-copy sends on the socket, or the sender copies every write.
+     */
+    [[nodiscard]] bool is_zerocopy() const noexcept;
+
+private:
+    struct pending_send_t {
+        std::uint64_t tag;
+        bool done;  // Completed, but younger than a send which has not
+    };
+
+    int m_sock;
+    std::size_t m_copy_threshold;
+    bool m_zerocopy = true;
+    // The kernel numbers zero-copy sends from 0 and reports completions as ranges of these IDs
+    std::uint32_t m_next_id = 0;
+    // Ring of the sends since the oldest one awaiting completion; the send at `m_head` has ID `m_next_id - m_count`
+    std::vector<pending_send_t> m_pending;
+    std::size_t m_head        = 0;
+    std::size_t m_count       = 0;
+    std::size_t m_outstanding = 0;  // Sends in the ring not completed yet
+};
+
+}  // namespace psb
+
+#endif /* F8F6619D_3932_4AAC_BE5B_A3DDDF517C9F */
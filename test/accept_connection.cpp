@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <system_error>
+
 #include <poll.h>
 #include <sys/socket.h>
 
@@ -55,3 +57,19 @@ TEST(AcceptConnection, Functional)
 
     close(accepted.sock);
 }
+
+TEST(AcceptConnection, ErrorCode)
+{
+    const psb::socket_options_t opts{
+        .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+    };
+
+    psb::listening_socket_t ls{};
+    ASSERT_NO_THROW(ls = psb::create_listening_socket("127.0.0.1", 0, opts));
+    auto close_listening_socket = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    std::error_code ec;
+    const auto accepted = psb::accept_connection(ls.sock, ec);
+    EXPECT_EQ(ec, std::errc::resource_unavailable_try_again);
+    EXPECT_EQ(accepted.sock, -1);
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "sockutils.h"
+#include "utils.h"
+
+namespace {
+
+constexpr psb::socket_options_t opts{
+    .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+};
+
+}  // namespace
+
+TEST(AcceptConnections, BadFD)
+{
+    std::array<psb::accepted_socket_t, 4U> sockets{};
+    const auto result = psb::accept_connections(-1, sockets, sockets.size());
+    EXPECT_EQ(result.count, 0);
+    EXPECT_EQ(result.error, std::error_code(EBADF, std::system_category()));
+}
+
+TEST(AcceptConnections, EmptyQueue)
+{
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    std::array<psb::accepted_socket_t, 4U> sockets{};
+    const auto result = psb::accept_connections(ls.sock, sockets, sockets.size());
+    EXPECT_EQ(result.count, 0);
+    EXPECT_FALSE(result.error);
+}
+
+TEST(AcceptConnections, DrainsQueue)
+{
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(ls.sock, ss, len));
+
+    constexpr std::size_t connections = 3;
+    std::array<int, connections> clients{};
+    auto close_clients = gsl::finally([&clients]() {
+        for (const auto sock : clients) {
+            close(sock);
+        }
+    });
+
+    for (auto& sock : clients) {
+        ASSERT_NO_THROW(sock = connect_to(ss, len));
+    }
+
+    std::array<psb::accepted_socket_t, connections + 1> sockets{};
+    const auto result = psb::accept_connections(ls.sock, sockets, sockets.size());
+    ASSERT_EQ(result.count, connections);
+    EXPECT_FALSE(result.error);
+
+    for (std::size_t i = 0; i < result.count; ++i) {
+        const auto& accepted = sockets.at(i);
+        auto close_accepted  = gsl::finally([sock = accepted.sock]() { close(sock); });
+
+        EXPECT_EQ(accepted.address, "127.0.0.1");
+        EXPECT_NE(accepted.port, 0);
+        EXPECT_EQ(get_status_flags(accepted.sock) & O_NONBLOCK, O_NONBLOCK);
+        EXPECT_EQ(get_fd_flags(accepted.sock) & FD_CLOEXEC, FD_CLOEXEC);
+    }
+}
+
+TEST(AcceptConnections, Budget)
+{
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(ls.sock, ss, len));
+
+    std::array<int, 3U> clients{};
+    auto close_clients = gsl::finally([&clients]() {
+        for (const auto sock : clients) {
+            close(sock);
+        }
+    });
+
+    for (auto& sock : clients) {
+        ASSERT_NO_THROW(sock = connect_to(ss, len));
+    }
+
+    std::array<psb::accepted_socket_t, 3U> sockets{};
+
+    auto result = psb::accept_connections(ls.sock, sockets, 2);
+    EXPECT_EQ(result.count, 2);
+    EXPECT_FALSE(result.error);
+    close(sockets.at(0).sock);
+    close(sockets.at(1).sock);
+
+    result = psb::accept_connections(ls.sock, sockets, 2);
+    EXPECT_EQ(result.count, 1);
+    EXPECT_FALSE(result.error);
+    close(sockets.at(0).sock);
+}
+
+TEST(AcceptConnections, Raw)
+{
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(ls.sock, ss, len));
+
+    std::array<int, 2U> clients{};
+    auto close_clients = gsl::finally([&clients]() {
+        for (const auto sock : clients) {
+            close(sock);
+        }
+    });
+
+    for (auto& sock : clients) {
+        ASSERT_NO_THROW(sock = connect_to(ss, len));
+    }
+
+    std::array<psb::raw_accepted_socket_t, 4U> sockets{};
+    const auto result = psb::accept_connections(ls.sock, sockets, sockets.size());
+    ASSERT_EQ(result.count, clients.size());
+    EXPECT_FALSE(result.error);
+
+    for (std::size_t i = 0; i < result.count; ++i) {
+        const auto& accepted = sockets.at(i);
+        auto close_accepted  = gsl::finally([sock = accepted.sock]() { close(sock); });
+
+        EXPECT_EQ(accepted.addr.ss_family, AF_INET);
+        EXPECT_EQ(accepted.addr_len, sizeof(sockaddr_in));
+        EXPECT_EQ(psb::get_socket_info(accepted).address, "127.0.0.1");
+    }
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "sockutils.h"
+#include "utils.h"
+
+TEST(AcceptRawConnection, BadFD)
+{
+    EXPECT_THROW(psb::accept_raw_connection(-1), std::system_error);
+}
+
+TEST(AcceptRawConnection, Functional)
+{
+    const psb::socket_options_t opts{
+        .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+    };
+
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(ls.sock, ss, len));
+
+    int client{};
+    ASSERT_NO_THROW(client = connect_to(ss, len));
+    auto close_client = gsl::finally([client]() { close(client); });
+
+    psb::raw_accepted_socket_t accepted{};
+    ASSERT_NO_THROW(accepted = psb::accept_raw_connection(ls.sock));
+    auto close_accepted = gsl::finally([sock = accepted.sock]() { close(sock); });
+
+    EXPECT_EQ(get_status_flags(accepted.sock) & O_NONBLOCK, O_NONBLOCK);
+    EXPECT_EQ(get_fd_flags(accepted.sock) & FD_CLOEXEC, FD_CLOEXEC);
+
+    sockaddr_storage client_addr{};
+    socklen_t client_len = sizeof(client_addr);
+    ASSERT_NO_THROW(get_sock_name(client, client_addr, client_len));
+
+    const auto expected = psb::get_socket_info(client_addr, client_len);
+    const auto actual   = psb::get_socket_info(accepted);
+    EXPECT_EQ(actual.address, expected.address);
+    EXPECT_EQ(actual.port, expected.port);
+}
+
+TEST(AcceptRawConnection, ErrorCode)
+{
+    std::error_code ec;
+    const auto accepted = psb::accept_raw_connection(-1, ec);
+    EXPECT_EQ(ec, std::errc::bad_file_descriptor);
+    EXPECT_EQ(accepted.sock, -1);
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <system_error>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "admission.h"
+#include "sockutils.h"
+#include "utils.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr psb::socket_options_t opts{
+    .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+};
+
+const psb::admission_controller::time_point t0{1h};
+
+std::vector<int> connect_clients(int listener, std::size_t n)
+{
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    get_sock_name(listener, ss, len);
+
+    std::vector<int> clients;
+    for (std::size_t i = 0; i < n; ++i) {
+        clients.push_back(connect_to(ss, len));
+    }
+
+    return clients;
+}
+
+}  // namespace
+
+TEST(Admission, RateLimit)
+{
+    psb::admission_controller controller({.rate = 1000, .burst = 10, .max_inflight = 0, .reset_on_overload = 0});
+
+    // The bucket starts full
+    EXPECT_EQ(controller.admit(20, t0), 10);
+    EXPECT_EQ(controller.admit(1, t0), 0);
+    EXPECT_EQ(controller.retry_after(t0), 1ms);
+
+    EXPECT_EQ(controller.admit(5, t0 + 1ms), 1);
+    EXPECT_EQ(controller.admit(10, t0 + 6ms), 5);
+    EXPECT_EQ(controller.retry_after(t0 + 6ms), 1ms);
+
+    // Unused admissions return their tokens
+    controller.cancel(3);
+    EXPECT_EQ(controller.retry_after(t0 + 6ms), 0ns);
+    EXPECT_EQ(controller.admit(10, t0 + 6ms), 3);
+}
+
+TEST(Admission, MaxInflight)
+{
+    psb::admission_controller controller({.rate = 0, .burst = 0, .max_inflight = 2, .reset_on_overload = 0});
+
+    EXPECT_EQ(controller.admit(5), 2);
+    EXPECT_EQ(controller.admit(1), 0);
+    EXPECT_EQ(controller.stats().inflight, 2);
+
+    controller.release();
+    EXPECT_EQ(controller.admit(3), 1);
+    controller.cancel(1);
+    EXPECT_EQ(controller.stats().inflight, 1);
+    EXPECT_EQ(controller.retry_after(), 0ns);
+}
+
+TEST(Admission, PauseLeavesConnectionsQueued)
+{
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    const auto clients = connect_clients(ls.sock, 3);
+    auto close_clients = gsl::finally([&clients]() {
+        for (const auto client : clients) {
+            close(client);
+        }
+    });
+
+    psb::admission_controller controller({.rate = 0, .burst = 0, .max_inflight = 1, .reset_on_overload = 0});
+    std::array<psb::accepted_socket_t, 8> sockets{};
+
+    auto result = controller.accept_connections(ls.sock, sockets, sockets.size());
+    EXPECT_FALSE(result.error);
+    ASSERT_EQ(result.count, 1);
+    close(sockets[0].sock);
+
+    result = controller.accept_connections(ls.sock, sockets, sockets.size());
+    EXPECT_EQ(result.error, std::errc::resource_unavailable_try_again);
+    EXPECT_EQ(result.count, 0);
+    EXPECT_EQ(psb::get_listen_queue(ls.sock).length, 2);
+
+    controller.release();
+    result = controller.accept_connections(ls.sock, sockets, sockets.size());
+    EXPECT_EQ(result.count, 1);
+    close(sockets[0].sock);
+
+    const auto stats = controller.stats();
+    EXPECT_EQ(stats.inflight, 1);
+    EXPECT_EQ(stats.paused, 1);
+    EXPECT_EQ(stats.reset, 0);
+}
+
+TEST(Admission, ResetOnOverload)
+{
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    const auto clients = connect_clients(ls.sock, 3);
+    auto close_clients = gsl::finally([&clients]() {
+        for (const auto client : clients) {
+            close(client);
+        }
+    });
+
+    psb::admission_controller controller({.rate = 0, .burst = 0, .max_inflight = 1, .reset_on_overload = 1});
+    std::array<psb::accepted_socket_t, 8> sockets{};
+
+    const auto result = controller.accept_connections(ls.sock, sockets, sockets.size());
+    EXPECT_FALSE(result.error);
+    ASSERT_EQ(result.count, 1);
+    auto close_accepted = gsl::finally([sock = sockets[0].sock]() { close(sock); });
+
+    EXPECT_EQ(controller.stats().reset, 2);
+    EXPECT_EQ(psb::get_listen_queue(ls.sock).length, 0);
+
+    // The shed clients see a reset rather than a timeout
+    std::size_t resets = 0;
+    for (const auto client : clients) {
+        char c{};
+        if (recv(client, &c, 1, MSG_DONTWAIT) == -1 && errno == ECONNRESET) {
+            ++resets;
+        }
+    }
+
+    EXPECT_EQ(resets, 2);
+}
@@ -1,9 +1,13 @@
 #include <gtest/gtest.h>
 
 #include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
+#include <format>
 #include <gsl/util>
 #include <stdexcept>
+#include <string>
 #include <system_error>
 
 #include "sockutils.h"
@@ -84,3 +88,50 @@ TEST(BindSocket, InvalidFDIPv6)
 
     EXPECT_THROW(psb::bind_socket(-1, "::1", 0), std::system_error);
 }
+
+TEST(BindSocket, ErrorCode)
+{
+    int sock{};
+    ASSERT_NO_THROW(sock = create_socket(AF_INET, SOCK_STREAM, 0));
+    auto close_socket = gsl::finally([sock]() { close(sock); });
+
+    std::error_code ec;
+    psb::bind_socket(sock, "256.0.0.1", 0, ec);
+    EXPECT_EQ(ec, std::errc::invalid_argument);
+
+    psb::bind_socket(-1, "127.0.0.1", 0, ec);
+    EXPECT_EQ(ec, std::errc::bad_file_descriptor);
+
+    psb::bind_socket(sock, "127.0.0.1", 0, ec);
+    EXPECT_FALSE(ec);
+}
+
+TEST(BindSocket, UnixAbstract)
+{
+    int sock{};
+    ASSERT_NO_THROW(sock = create_socket(AF_UNIX, SOCK_STREAM, 0));
+    auto close_socket = gsl::finally([sock]() { close(sock); });
+
+    const std::string expected_address = std::format("@psb-sockutils-bind-{}", getpid());
+
+    ASSERT_NO_THROW(psb::bind_socket(sock, expected_address, 0));
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(sock, ss, len));
+
+    const auto info = psb::get_socket_info(ss, len);
+    // The abstract name is reported without the leading NUL
+    EXPECT_EQ(info.address, expected_address.substr(1));
+}
+
+TEST(BindSocket, UnixPathTooLong)
+{
+    int sock{};
+    ASSERT_NO_THROW(sock = create_socket(AF_UNIX, SOCK_STREAM, 0));
+    auto close_socket = gsl::finally([sock]() { close(sock); });
+
+    std::error_code ec;
+    psb::bind_socket(sock, "/" + std::string(sizeof(sockaddr_un::sun_path), 'x'), 0, ec);
+    EXPECT_EQ(ec, std::errc::filename_too_long);
+}
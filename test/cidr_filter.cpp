@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "cidr_filter.h"
+#include "sockutils.h"
+#include "utils.h"
+
+namespace {
+
+constexpr psb::socket_options_t opts{
+    .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+};
+
+bool matches(const psb::cidr_set& set, std::string_view address)
+{
+    sockaddr_storage ss{};
+    socklen_t len = 0;
+    if (psb::make_socket_address(address, 0, ss, len) != std::errc{}) {
+        throw std::invalid_argument("bad address");
+    }
+
+    return set.contains(ss, len);
+}
+
+/**
+ * Connects to @a listener without blocking and tells whether the handshake completes within @a timeout_ms.
+ */
+bool handshake_completes(int listener, int timeout_ms)
+{
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    get_sock_name(listener, ss, len);
+
+    const auto sock  = create_socket(ss.ss_family, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    const auto guard = gsl::finally([sock] { close(sock); });
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (connect(sock, reinterpret_cast<const sockaddr*>(&ss), len) == 0) {
+        return true;
+    }
+
+    EXPECT_EQ(errno, EINPROGRESS);
+    pollfd pfd{.fd = sock, .events = POLLOUT, .revents = 0};
+    if (poll(&pfd, 1, timeout_ms) != 1) {
+        return false;
+    }
+
+    return get_socket_option(sock, SOL_SOCKET, SO_ERROR) == 0;
+}
+
+}  // namespace
+
+TEST(CidrSet, Empty)
+{
+    const psb::cidr_set set;
+    EXPECT_EQ(set.size(), 0);
+    EXPECT_FALSE(matches(set, "127.0.0.1"));
+    EXPECT_FALSE(matches(set, "::1"));
+    EXPECT_TRUE(set.minimal_prefixes().empty());
+}
+
+TEST(CidrSet, IPv4)
+{
+    psb::cidr_set set;
+    set.add("10.0.0.0/8");
+    set.add("192.168.1.0/24");
+    set.add("192.168.2.7");
+    set.add("172.16.0.0/12");
+
+    EXPECT_EQ(set.size(), 4);
+    EXPECT_TRUE(matches(set, "10.255.1.2"));
+    EXPECT_TRUE(matches(set, "192.168.1.200"));
+    EXPECT_TRUE(matches(set, "192.168.2.7"));
+    EXPECT_TRUE(matches(set, "172.31.255.255"));
+    EXPECT_FALSE(matches(set, "11.0.0.0"));
+    EXPECT_FALSE(matches(set, "192.168.2.8"));
+    EXPECT_FALSE(matches(set, "172.32.0.0"));
+    EXPECT_FALSE(matches(set, "::1"));
+}
+
+TEST(CidrSet, IPv6)
+{
+    psb::cidr_set set;
+    set.add("2001:db8::/32");
+    set.add("fe80::/10");
+    set.add("::1");
+
+    EXPECT_TRUE(matches(set, "2001:db8:1234::1"));
+    EXPECT_TRUE(matches(set, "febf::1"));
+    EXPECT_TRUE(matches(set, "::1"));
+    EXPECT_FALSE(matches(set, "2001:db9::1"));
+    EXPECT_FALSE(matches(set, "fec0::1"));
+    EXPECT_FALSE(matches(set, "::2"));
+    EXPECT_FALSE(matches(set, "127.0.0.1"));
+}
+
+TEST(CidrSet, IPv4Mapped)
+{
+    psb::cidr_set set;
+    set.add("127.0.0.0/8");
+    EXPECT_TRUE(matches(set, "::ffff:127.0.0.1"));
+    EXPECT_FALSE(matches(set, "::ffff:128.0.0.1"));
+
+    psb::cidr_set mapped;
+    mapped.add("::ffff:0:0/96");
+    EXPECT_TRUE(matches(mapped, "203.0.113.1"));
+    EXPECT_FALSE(matches(mapped, "::1"));
+}
+
+TEST(CidrSet, Overlapping)
+{
+    psb::cidr_set set;
+    set.add("10.1.2.0/24");
+    set.add("10.1.0.0/16");
+    set.add("10.1.0.0/16");
+    set.add("10.0.0.0/8");
+    set.add("0.0.0.0/1");
+    set.add("192.0.2.0/24");
+
+    EXPECT_EQ(set.size(), 5);
+    EXPECT_TRUE(matches(set, "10.200.0.1"));
+    EXPECT_TRUE(matches(set, "100.0.0.1"));
+    EXPECT_TRUE(matches(set, "192.0.2.1"));
+    EXPECT_FALSE(matches(set, "192.0.3.1"));
+
+    const auto prefixes = set.minimal_prefixes();
+    ASSERT_EQ(prefixes.size(), 2);
+    EXPECT_EQ(prefixes[0].second, 96 + 1);
+    EXPECT_EQ(prefixes[1].second, 96 + 24);
+}
+
+TEST(CidrSet, MatchAll)
+{
+    psb::cidr_set set;
+    set.add("::/0");
+    EXPECT_TRUE(matches(set, "127.0.0.1"));
+    EXPECT_TRUE(matches(set, "2001:db8::1"));
+}
+
+TEST(CidrSet, InvalidPrefix)
+{
+    psb::cidr_set set;
+    for (const auto* cidr : {"", "10.0.0.0/33", "::/129", "10.0.0.0/", "10.0.0.0/8x", "10.0.0/8", "zz::/8"}) {
+        std::error_code ec;
+        set.add(cidr, ec);
+        EXPECT_EQ(ec, std::errc::invalid_argument) << cidr;
+        EXPECT_THROW(set.add(cidr), std::invalid_argument) << cidr;
+    }
+
+    EXPECT_EQ(set.size(), 0);
+}
+
+TEST(AttachCidrFilter, Denylist)
+{
+    const auto ls    = psb::create_listening_socket("127.0.0.1", 0, opts);
+    const auto guard = gsl::finally([&ls] { close(ls.sock); });
+
+    psb::cidr_set set;
+    set.add("192.0.2.0/24");
+    psb::attach_cidr_filter(ls.sock, set, false);
+    EXPECT_TRUE(handshake_completes(ls.sock, 1000));
+
+    set.add("127.0.0.1/32");
+    psb::attach_cidr_filter(ls.sock, set, false);
+    EXPECT_FALSE(handshake_completes(ls.sock, 200));
+}
+
+TEST(AttachCidrFilter, Allowlist)
+{
+    const auto ls    = psb::create_listening_socket("127.0.0.1", 0, opts);
+    const auto guard = gsl::finally([&ls] { close(ls.sock); });
+
+    psb::cidr_set set;
+    set.add("10.0.0.0/8");
+    psb::attach_cidr_filter(ls.sock, set, true);
+    EXPECT_FALSE(handshake_completes(ls.sock, 200));
+
+    set.add("127.0.0.0/8");
+    psb::attach_cidr_filter(ls.sock, set, true);
+    EXPECT_TRUE(handshake_completes(ls.sock, 1000));
+}
+
+TEST(AttachCidrFilter, IPv6)
+{
+    if (!ipv6_supported()) {
+        GTEST_SKIP() << "IPv6 is not supported";
+    }
+
+    const auto ls    = psb::create_listening_socket("::1", 0, opts);
+    const auto guard = gsl::finally([&ls] { close(ls.sock); });
+
+    psb::cidr_set set;
+    set.add("2001:db8::/32");
+    set.add("127.0.0.0/8");
+    psb::attach_cidr_filter(ls.sock, set, false);
+    EXPECT_TRUE(handshake_completes(ls.sock, 1000));
+
+    set.add("::1/128");
+    psb::attach_cidr_filter(ls.sock, set, false);
+    EXPECT_FALSE(handshake_completes(ls.sock, 200));
+}
+
+TEST(AttachCidrFilter, TooManyPrefixes)
+{
+    const auto ls    = psb::create_listening_socket("127.0.0.1", 0, opts);
+    const auto guard = gsl::finally([&ls] { close(ls.sock); });
+
+    psb::cidr_set set;
+    for (std::uint32_t i = 0; i < 2048; ++i) {
+        set.add(in_addr{.s_addr = htonl(0x0A00'0000U | (i << 8U))}, 24);
+    }
+
+    std::error_code ec;
+    psb::attach_cidr_filter(ls.sock, set, false, ec);
+    EXPECT_EQ(ec, std::errc::argument_list_too_long);
+    EXPECT_THROW(psb::attach_cidr_filter(ls.sock, set, false), std::system_error);
+}
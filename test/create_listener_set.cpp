@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "sockutils.h"
+#include "utils.h"
+
+namespace {
+
+constexpr psb::socket_options_t opts{
+    .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+};
+
+std::uint16_t get_port(int sock)
+{
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    get_sock_name(sock, ss, len);
+    return psb::get_socket_info(ss, len).port;
+}
+
+/**
+ * Finds a port which is free on both the IPv4 and the IPv6 wildcard addresses.
+ */
+std::uint16_t find_free_port()
+{
+    auto dual_stack    = opts;
+    dual_stack.v6_only = -1;
+
+    const auto ls   = psb::create_listening_socket("::", 0, dual_stack);
+    const auto port = get_port(ls.sock);
+    close(ls.sock);
+    return port;
+}
+
+int connect_ipv4(std::uint16_t port)
+{
+    sockaddr_storage ss{};
+    auto& sin      = reinterpret_cast<sockaddr_in&>(ss);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    sin.sin_family = AF_INET;
+    sin.sin_port   = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &sin.sin_addr);
+    return connect_to(ss, sizeof(sockaddr_in));
+}
+
+void close_all(const std::vector<psb::set_listener_t>& sockets)
+{
+    for (const auto& s : sockets) {
+        close(s.listener.sock);
+    }
+}
+
+}  // namespace
+
+TEST(CreateListenerSet, DualStack)
+{
+    if (!ipv6_supported()) {
+        GTEST_SKIP() << "IPv6 not supported";
+    }
+
+    const auto port = find_free_port();
+    const std::array<psb::listen_address_t, 3> addresses{{{"0.0.0.0", port}, {"::", port}, {"127.0.0.1", 0}}};
+
+    const auto sockets = psb::create_listener_set(addresses, opts, true);
+    auto close_sockets = gsl::finally([&sockets]() { close_all(sockets); });
+
+    // 0.0.0.0 is served by the dual-stack socket
+    ASSERT_EQ(sockets.size(), 2);
+    EXPECT_EQ(sockets[0].index, 1);
+    EXPECT_STREQ(sockets[0].listener.type, "ipv6");
+    EXPECT_EQ(get_port(sockets[0].listener.sock), port);
+    EXPECT_EQ(get_socket_option(sockets[0].listener.sock, IPPROTO_IPV6, IPV6_V6ONLY), 0);
+    EXPECT_EQ(sockets[1].index, 2);
+    EXPECT_STREQ(sockets[1].listener.type, "ipv4");
+
+    // An IPv4 client of the dual-stack socket is reported with its IPv4 address
+    const int client  = connect_ipv4(port);
+    auto close_client = gsl::finally([client]() { close(client); });
+
+    const auto accepted = psb::accept_connection(sockets[0].listener.sock);
+    close(accepted.sock);
+    EXPECT_EQ(accepted.address, "127.0.0.1");
+}
+
+TEST(CreateListenerSet, SeparateSockets)
+{
+    if (!ipv6_supported()) {
+        GTEST_SKIP() << "IPv6 not supported";
+    }
+
+    const auto port = find_free_port();
+    const std::array<psb::listen_address_t, 2> addresses{{{"0.0.0.0", port}, {"::", port}}};
+
+    const auto sockets = psb::create_listener_set(addresses, opts, false);
+    auto close_sockets = gsl::finally([&sockets]() { close_all(sockets); });
+
+    ASSERT_EQ(sockets.size(), 2);
+    EXPECT_EQ(sockets[0].index, 0);
+    EXPECT_STREQ(sockets[0].listener.type, "ipv4");
+    EXPECT_EQ(sockets[1].index, 1);
+    EXPECT_STREQ(sockets[1].listener.type, "ipv6");
+    EXPECT_EQ(get_socket_option(sockets[1].listener.sock, IPPROTO_IPV6, IPV6_V6ONLY), 1);
+}
+
+TEST(CreateListenerSet, AllOrNothing)
+{
+    const auto taken = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_taken = gsl::finally([sock = taken.sock]() { close(sock); });
+    const auto port  = get_port(taken.sock);
+
+    auto no_reuse       = opts;
+    no_reuse.reuse_addr = 0;
+
+    const std::array<psb::listen_address_t, 2> addresses{{{"127.0.0.1", 0}, {"127.0.0.1", port}}};
+
+    std::error_code ec;
+    const auto sockets = psb::create_listener_set(addresses, no_reuse, false, ec);
+    EXPECT_EQ(ec, std::errc::address_in_use);
+    EXPECT_TRUE(sockets.empty());
+    EXPECT_THROW(psb::create_listener_set(addresses, no_reuse, false), std::system_error);
+
+    // Addresses are checked before any socket is created
+    const std::array<psb::listen_address_t, 2> invalid{{{"127.0.0.1", 0}, {"localhost", port}}};
+    psb::create_listener_set(invalid, opts, false, ec);
+    EXPECT_EQ(ec, std::errc::invalid_argument);
+    try {
+        psb::create_listener_set(invalid, opts, false);
+        ADD_FAILURE() << "std::invalid_argument not thrown";
+    }
+    catch (const std::invalid_argument& e) {
+        EXPECT_STREQ(e.what(), "Invalid address: localhost");
+    }
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "sockutils.h"
+#include "utils.h"
+
+namespace {
+
+constexpr psb::socket_options_t opts{
+    .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+};
+
+void close_group(const std::vector<psb::listening_socket_t>& group)
+{
+    for (const auto& ls : group) {
+        close(ls.sock);
+    }
+}
+
+/**
+ * Opens @a connections connections to the group and returns how many of them every socket of the group has accepted.
+ */
+std::vector<std::size_t> distribute(const std::vector<psb::listening_socket_t>& group, std::size_t connections)
+{
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    get_sock_name(group.front().sock, ss, len);
+
+    std::vector<int> clients;
+    auto close_clients = gsl::finally([&clients]() {
+        for (const auto sock : clients) {
+            close(sock);
+        }
+    });
+
+    for (std::size_t i = 0; i < connections; ++i) {
+        clients.push_back(connect_to(ss, len));
+    }
+
+    std::vector<std::size_t> accepted;
+    std::array<psb::raw_accepted_socket_t, 64U> sockets{};
+    for (const auto& ls : group) {
+        const auto result = psb::accept_connections(ls.sock, sockets, sockets.size());
+        EXPECT_FALSE(result.error);
+        for (std::size_t i = 0; i < result.count; ++i) {
+            close(sockets.at(i).sock);
+        }
+
+        accepted.push_back(result.count);
+    }
+
+    return accepted;
+}
+
+}  // namespace
+
+TEST(CreateListeningGroup, SharedPort)
+{
+    const auto group = psb::create_listening_group("127.0.0.1", 0, opts, 4, false);
+    auto close_sockets = gsl::finally([&group]() { close_group(group); });
+
+    ASSERT_EQ(group.size(), 4);
+
+    std::uint16_t port = 0;
+    for (const auto& ls : group) {
+        sockaddr_storage ss{};
+        socklen_t len = sizeof(ss);
+        ASSERT_NO_THROW(get_sock_name(ls.sock, ss, len));
+
+        const auto info = psb::get_socket_info(ss, len);
+        EXPECT_NE(info.port, 0);
+        if (port == 0) {
+            port = info.port;
+        }
+
+        EXPECT_EQ(info.port, port);
+        EXPECT_EQ(get_socket_option(ls.sock, SOL_SOCKET, SO_REUSEPORT), 1);
+    }
+}
+
+TEST(CreateListeningGroup, Distribution)
+{
+    constexpr std::size_t connections = 64;
+
+    const auto group = psb::create_listening_group("127.0.0.1", 0, opts, 2, false);
+    auto close_sockets = gsl::finally([&group]() { close_group(group); });
+
+    const auto accepted = distribute(group, connections);
+
+    // Connections are spread by the hash of the 4-tuple: with 64 connections, an idle shard is practically impossible
+    EXPECT_EQ(accepted.at(0) + accepted.at(1), connections);
+    EXPECT_GT(accepted.at(0), 0);
+    EXPECT_GT(accepted.at(1), 0);
+}
+
+TEST(CreateListeningGroup, CpuSteering)
+{
+    constexpr std::size_t connections = 16;
+    constexpr std::size_t count       = 4;
+
+    std::vector<psb::listening_socket_t> group;
+    ASSERT_NO_THROW(group = psb::create_listening_group("127.0.0.1", 0, opts, count, true));
+    auto close_sockets = gsl::finally([&group]() { close_group(group); });
+
+    cpu_set_t saved;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(saved), &saved), 0);
+    auto restore_affinity = gsl::finally([&saved]() { sched_setaffinity(0, sizeof(saved), &saved); });
+
+    // Over loopback, the SYN is processed on the CPU of the connecting thread; pin it to a few CPUs in turn and expect
+    // every connection on the shard `cpu % count`. Without the program, the 4-tuple hash would spread them.
+    std::size_t tested = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE && tested < count; ++cpu) {
+        if (!CPU_ISSET(cpu, &saved)) {
+            continue;
+        }
+
+        cpu_set_t pinned;
+        CPU_ZERO(&pinned);
+        CPU_SET(cpu, &pinned);
+        ASSERT_EQ(sched_setaffinity(0, sizeof(pinned), &pinned), 0);
+
+        const auto accepted = distribute(group, connections);
+        std::vector<std::size_t> expected(count);
+        expected.at(static_cast<std::size_t>(cpu) % count) = connections;
+        EXPECT_EQ(accepted, expected) << "CPU " << cpu;
+        ++tested;
+    }
+
+    EXPECT_GT(tested, 0);
+}
+
+TEST(CreateListeningGroup, InvalidAddress)
+{
+    EXPECT_THROW(psb::create_listening_group("::G", 0, opts, 2, false), std::invalid_argument);
+}
@@ -1,10 +1,18 @@
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <system_error>
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <gsl/util>
 #include <opentelemetry/semconv/incubating/network_attributes.h>
@@ -104,3 +112,323 @@ TEST(CreateListeningSocket, Exception)
 
     EXPECT_THROW(psb::create_listening_socket("127.0.0.1", info.port, opts), std::system_error);
 }
+
+TEST(CreateListeningSocket, ExceptionNamesFailedCall)
+{
+    const auto what = [](const psb::socket_options_t& opts, std::string_view address, std::uint16_t port) {
+        try {
+            const auto result = psb::create_listening_socket(address, port, opts);
+            close(result.sock);
+        }
+        catch (const std::system_error& e) {
+            return std::string(e.what());
+        }
+
+        return std::string();
+    };
+
+    psb::socket_options_t opts{
+        .close_on_exec        = 1,
+        .reuse_addr           = 0,
+        .free_bind            = 0,
+        .defer_accept_timeout = 0,
+        .listen_backlog       = SOMAXCONN,
+    };
+
+    const auto result = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_socket = gsl::finally([sock = result.sock]() { close(sock); });
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(result.sock, ss, len));
+    const auto info = psb::get_socket_info(ss, len);
+
+    EXPECT_TRUE(what(opts, "127.0.0.1", info.port).starts_with(std::format("bind({}) failed", info)));
+
+    opts.user_timeout = -1;
+    EXPECT_TRUE(what(opts, "127.0.0.1", 0).starts_with("setsockopt(TCP_USER_TIMEOUT) failed"));
+
+    opts.user_timeout   = 0;
+    opts.listen_backlog = psb::get_max_listen_backlog() + 1;
+    opts.strict_backlog = 1;
+    EXPECT_TRUE(what(opts, "127.0.0.1", 0).starts_with("listen() failed"));
+}
+
+TEST(CreateListeningSocket, CompileTimeAddress)
+{
+    const psb::socket_options_t opts{
+        .close_on_exec        = 1,
+        .reuse_addr           = 0,
+        .free_bind            = 0,
+        .defer_accept_timeout = 0,
+        .listen_backlog       = SOMAXCONN,
+    };
+
+    constexpr auto addr = psb::make_sockaddr_in("127.0.0.1", 0);
+
+    const auto result = psb::create_listening_socket(addr, opts);
+    auto close_socket = gsl::finally([sock = result.sock]() { close(sock); });
+
+    ASSERT_GE(result.sock, 0);
+    EXPECT_STREQ(result.type, opentelemetry::semconv::network::NetworkTypeValues::kIpv4);
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(result.sock, ss, len));
+    EXPECT_EQ(psb::get_socket_info(ss, len).address, "127.0.0.1");
+}
+
+TEST(CreateListeningSocket, InvalidAddress)
+{
+    const psb::socket_options_t opts{
+        .close_on_exec        = 0,
+        .reuse_addr           = 0,
+        .free_bind            = 0,
+        .defer_accept_timeout = 0,
+        .listen_backlog       = SOMAXCONN,
+    };
+
+    EXPECT_THROW(psb::create_listening_socket("127.0.0.256", 0, opts), std::invalid_argument);
+}
+
+TEST(CreateListeningSocket, ErrorCode)
+{
+    const psb::socket_options_t opts{
+        .close_on_exec        = 1,
+        .reuse_addr           = 0,
+        .free_bind            = 0,
+        .defer_accept_timeout = 0,
+        .listen_backlog       = SOMAXCONN,
+    };
+
+    std::error_code ec;
+    const auto result = psb::create_listening_socket("127.0.0.1", 0, opts, ec);
+    ASSERT_FALSE(ec);
+    auto close_socket = gsl::finally([sock = result.sock]() { close(sock); });
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(result.sock, ss, len));
+
+    const auto failed = psb::create_listening_socket(ss, len, opts, ec);
+    EXPECT_EQ(ec, std::errc::address_in_use);
+    EXPECT_EQ(failed.sock, -1);
+
+    psb::create_listening_socket("localhost", 0, opts, ec);
+    EXPECT_EQ(ec, std::errc::invalid_argument);
+}
+
+TEST(CreateListeningSocket, InheritedOptions)
+{
+    const psb::socket_options_t opts{
+        .close_on_exec        = 1,
+        .reuse_addr           = 0,
+        .free_bind            = 0,
+        .defer_accept_timeout = 0,
+        .listen_backlog       = SOMAXCONN,
+        .no_delay             = 1,
+        .keep_alive           = 1,
+        .keep_idle            = 30,     // NOLINT(readability-magic-numbers)
+        .keep_interval        = 5,      // NOLINT(readability-magic-numbers)
+        .keep_count           = 3,      // NOLINT(readability-magic-numbers)
+        .user_timeout         = 10000,  // NOLINT(readability-magic-numbers)
+        .notsent_lowat        = 16384,  // NOLINT(readability-magic-numbers)
+        .fastopen_queue       = 16,     // NOLINT(readability-magic-numbers)
+    };
+
+    const auto result = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_socket = gsl::finally([sock = result.sock]() { close(sock); });
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(result.sock, ss, len));
+
+    int client{};
+    ASSERT_NO_THROW(client = connect_to(ss, len));
+    auto close_client = gsl::finally([client]() { close(client); });
+
+    psb::raw_accepted_socket_t accepted{};
+    ASSERT_NO_THROW(accepted = psb::accept_raw_connection(result.sock));
+    auto close_accepted = gsl::finally([sock = accepted.sock]() { close(sock); });
+
+    // The accepted socket gets the options without any further system calls
+    EXPECT_NE(get_socket_option(accepted.sock, IPPROTO_TCP, TCP_NODELAY), 0);
+    EXPECT_NE(get_socket_option(accepted.sock, SOL_SOCKET, SO_KEEPALIVE), 0);
+    EXPECT_EQ(get_socket_option(accepted.sock, IPPROTO_TCP, TCP_KEEPIDLE), opts.keep_idle);
+    EXPECT_EQ(get_socket_option(accepted.sock, IPPROTO_TCP, TCP_KEEPINTVL), opts.keep_interval);
+    EXPECT_EQ(get_socket_option(accepted.sock, IPPROTO_TCP, TCP_KEEPCNT), opts.keep_count);
+    EXPECT_EQ(get_socket_option(accepted.sock, IPPROTO_TCP, TCP_USER_TIMEOUT), opts.user_timeout);
+    EXPECT_EQ(get_socket_option(accepted.sock, IPPROTO_TCP, TCP_NOTSENT_LOWAT), opts.notsent_lowat);
+}
+
+TEST(CreateListeningSocket, BufferSizes)
+{
+    const psb::socket_options_t opts{
+        .close_on_exec        = 1,
+        .reuse_addr           = 0,
+        .free_bind            = 0,
+        .defer_accept_timeout = 0,
+        .listen_backlog       = SOMAXCONN,
+        .receive_buffer       = 65536,  // NOLINT(readability-magic-numbers)
+        .send_buffer          = 65536,  // NOLINT(readability-magic-numbers)
+    };
+
+    const auto result = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_socket = gsl::finally([sock = result.sock]() { close(sock); });
+
+    // Linux doubles the requested size to account for bookkeeping overhead (and caps it at net.core.[rw]mem_max)
+    EXPECT_GT(get_socket_option(result.sock, SOL_SOCKET, SO_RCVBUF), 0);
+    EXPECT_GT(get_socket_option(result.sock, SOL_SOCKET, SO_SNDBUF), 0);
+}
+
+TEST(CreateListeningSocket, AutoBacklog)
+{
+    const psb::socket_options_t opts{
+        .close_on_exec        = 1,
+        .reuse_addr           = 0,
+        .free_bind            = 0,
+        .defer_accept_timeout = 0,
+        .listen_backlog       = psb::listen_backlog_auto,
+    };
+
+    const auto result = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_socket = gsl::finally([sock = result.sock]() { close(sock); });
+
+    const auto queue = psb::get_listen_queue(result.sock);
+    EXPECT_EQ(queue.max_length, static_cast<std::uint32_t>(psb::get_max_listen_backlog()));
+}
+
+TEST(CreateListeningSocket, StrictBacklog)
+{
+    const auto max_backlog = psb::get_max_listen_backlog();
+
+    psb::socket_options_t opts{
+        .close_on_exec        = 1,
+        .reuse_addr           = 0,
+        .free_bind            = 0,
+        .defer_accept_timeout = 0,
+        .listen_backlog       = max_backlog + 1,
+        .strict_backlog       = 1,
+    };
+
+    std::error_code ec;
+    auto result = psb::create_listening_socket("127.0.0.1", 0, opts, ec);
+    EXPECT_EQ(result.sock, -1);
+    EXPECT_EQ(ec, std::errc::invalid_argument);
+
+    opts.listen_backlog = max_backlog;
+    result              = psb::create_listening_socket("127.0.0.1", 0, opts, ec);
+    auto close_socket   = gsl::finally([sock = result.sock]() { close(sock); });
+    EXPECT_FALSE(ec);
+    EXPECT_GE(result.sock, 0);
+}
+
+namespace {
+
+std::string temp_socket_path(std::string_view name)
+{
+    return (std::filesystem::temp_directory_path() / std::format("psb-sockutils-{}-{}.sock", name, getpid())).string();
+}
+
+}  // namespace
+
+TEST(CreateListeningSocket, UnixPath)
+{
+    const auto path = temp_socket_path("path");
+    const psb::socket_options_t opts{
+        .close_on_exec        = 1,
+        .reuse_addr           = 0,
+        .free_bind            = 1,  // Ignored for UNIX sockets
+        .defer_accept_timeout = 0,
+        .listen_backlog       = SOMAXCONN,
+        .no_delay             = 1,  // Ignored for UNIX sockets
+        .unix_mode            = 0600,
+    };
+
+    const auto result = psb::create_listening_socket(path, 0, opts);
+    auto cleanup      = gsl::finally([sock = result.sock, &path]() {
+        close(sock);
+        unlink(path.c_str());
+    });
+
+    ASSERT_GE(result.sock, 0);
+    EXPECT_STREQ(result.transport, opentelemetry::semconv::network::NetworkTransportValues::kUnix);
+    EXPECT_EQ(result.type, nullptr);
+    EXPECT_EQ(get_socket_option(result.sock, SOL_SOCKET, SO_TYPE), SOCK_STREAM);
+
+    struct stat st{};
+    ASSERT_EQ(stat(path.c_str(), &st), 0);
+    EXPECT_TRUE(S_ISSOCK(st.st_mode));
+    EXPECT_EQ(st.st_mode & 0777U, 0600U);
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(result.sock, ss, len));
+    EXPECT_EQ(psb::get_socket_info(ss, len).address, path);
+
+    int client{};
+    ASSERT_NO_THROW(client = connect_to(ss, len));
+    auto close_client = gsl::finally([client]() { close(client); });
+
+    psb::raw_accepted_socket_t accepted{};
+    ASSERT_NO_THROW(accepted = psb::accept_raw_connection(result.sock));
+    EXPECT_GE(accepted.sock, 0);
+    close(accepted.sock);
+}
+
+TEST(CreateListeningSocket, UnixAbstractSeqpacket)
+{
+    const auto address = std::format("@psb-sockutils-listen-{}", getpid());
+    const psb::socket_options_t opts{
+        .close_on_exec        = 1,
+        .reuse_addr           = 0,
+        .free_bind            = 0,
+        .defer_accept_timeout = 0,
+        .listen_backlog       = SOMAXCONN,
+        .seqpacket            = 1,
+    };
+
+    const auto result = psb::create_listening_socket(address, 0, opts);
+    auto close_socket = gsl::finally([sock = result.sock]() { close(sock); });
+
+    ASSERT_GE(result.sock, 0);
+    EXPECT_EQ(get_socket_option(result.sock, SOL_SOCKET, SO_TYPE), SOCK_SEQPACKET);
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(result.sock, ss, len));
+    EXPECT_EQ(psb::get_socket_info(ss, len).address, address.substr(1));
+}
+
+TEST(CreateListeningSocket, UnixStalePath)
+{
+    const auto path = temp_socket_path("stale");
+    psb::socket_options_t opts{
+        .close_on_exec        = 1,
+        .reuse_addr           = 0,
+        .free_bind            = 0,
+        .defer_accept_timeout = 0,
+        .listen_backlog       = SOMAXCONN,
+        .unlink_stale         = 1,
+    };
+
+    auto cleanup = gsl::finally([&path]() { unlink(path.c_str()); });
+
+    // The socket file outlives the listener
+    close(psb::create_listening_socket(path, 0, opts).sock);
+
+    const auto result = psb::create_listening_socket(path, 0, opts);
+    auto close_socket = gsl::finally([sock = result.sock]() { close(sock); });
+    ASSERT_GE(result.sock, 0);
+
+    // A live listener is not removed
+    std::error_code ec;
+    const auto second = psb::create_listening_socket(path, 0, opts, ec);
+    EXPECT_EQ(second.sock, -1);
+    EXPECT_EQ(ec, std::errc::address_in_use);
+
+    opts.unlink_stale = 0;
+    close(result.sock);
+    psb::create_listening_socket(path, 0, opts, ec);
+    EXPECT_EQ(ec, std::errc::address_in_use);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+#include <opentelemetry/semconv/incubating/network_attributes.h>
+
+#include "sockutils.h"
+#include "utils.h"
+
+namespace {
+
+constexpr psb::socket_options_t opts{
+    .close_on_exec        = 1,
+    .reuse_addr           = 1,
+    .free_bind            = 0,
+    .defer_accept_timeout = 1,  // TCP only; ignored
+    .listen_backlog       = 0,
+    .no_delay             = 1,  // TCP only; ignored
+};
+
+}  // namespace
+
+TEST(CreateUdpSocket, IPv4)
+{
+    const auto result = psb::create_udp_socket("127.0.0.1", 0, opts);
+    auto close_socket = gsl::finally([sock = result.sock]() { close(sock); });
+
+    ASSERT_GE(result.sock, 0);
+    EXPECT_STREQ(result.transport, opentelemetry::semconv::network::NetworkTransportValues::kUdp);
+    EXPECT_STREQ(result.type, opentelemetry::semconv::network::NetworkTypeValues::kIpv4);
+    EXPECT_EQ(get_socket_option(result.sock, SOL_SOCKET, SO_TYPE), SOCK_DGRAM);
+    EXPECT_NE(get_status_flags(result.sock) & O_NONBLOCK, 0);
+    EXPECT_NE(get_fd_flags(result.sock) & FD_CLOEXEC, 0);
+    EXPECT_NE(get_socket_option(result.sock, SOL_SOCKET, SO_REUSEADDR), 0);
+}
+
+TEST(CreateUdpSocket, IPv6)
+{
+    if (!ipv6_supported()) {
+        GTEST_SKIP() << "IPv6 not supported";
+    }
+
+    const auto result = psb::create_udp_socket("::1", 0, opts);
+    auto close_socket = gsl::finally([sock = result.sock]() { close(sock); });
+
+    ASSERT_GE(result.sock, 0);
+    EXPECT_STREQ(result.type, opentelemetry::semconv::network::NetworkTypeValues::kIpv6);
+}
+
+TEST(CreateUdpSocket, Errors)
+{
+    EXPECT_THROW(psb::create_udp_socket("localhost", 0, opts), std::invalid_argument);
+
+    std::error_code ec;
+    auto result = psb::create_udp_socket("/tmp/psb-sockutils.sock", 0, opts, ec);
+    EXPECT_EQ(result.sock, -1);
+    EXPECT_EQ(ec, std::errc::address_family_not_supported);
+
+    result            = psb::create_udp_socket("127.0.0.1", 0, opts);
+    auto close_socket = gsl::finally([sock = result.sock]() { close(sock); });
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(result.sock, ss, len));
+
+    const auto info = psb::get_socket_info(ss, len);
+    auto exclusive       = opts;
+    exclusive.reuse_addr = 0;
+    EXPECT_THROW(psb::create_udp_socket(info.address, info.port, exclusive), std::system_error);
+}
@@ -0,0 +1,253 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <format>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "admission.h"
+#include "epoll_acceptor.h"
+#include "sockutils.h"
+#include "utils.h"
+
+namespace {
+
+constexpr psb::socket_options_t listener_options{
+    .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+};
+
+void connect_clients(int listener, std::size_t n, std::vector<int>& clients)
+{
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    get_sock_name(listener, ss, len);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        clients.push_back(connect_to(ss, len));
+    }
+}
+
+}  // namespace
+
+TEST(EpollAcceptor, Functional)
+{
+    const auto ls1   = psb::create_listening_socket("127.0.0.1", 0, listener_options);
+    auto close_sock1 = gsl::finally([sock = ls1.sock]() { close(sock); });
+    const auto ls2   = psb::create_listening_socket("127.0.0.1", 0, listener_options);
+    auto close_sock2 = gsl::finally([sock = ls2.sock]() { close(sock); });
+    const std::array listeners{ls1.sock, ls2.sock};
+
+    constexpr std::size_t per_listener = 16;
+    std::vector<int> clients;
+    auto close_clients = gsl::finally([&clients]() {
+        for (const auto client : clients) {
+            close(client);
+        }
+    });
+
+    std::mutex mutex;
+    std::array<std::size_t, 2> counts{};
+
+    psb::epoll_acceptor* self = nullptr;
+    psb::epoll_acceptor acceptor(
+        listeners, {.accept_budget = 4}, [&](int listener, const psb::accepted_socket_t& sock) {
+            EXPECT_EQ(sock.address, "127.0.0.1");
+            EXPECT_EQ(get_status_flags(sock.sock) & O_NONBLOCK, O_NONBLOCK);
+            close(sock.sock);
+
+            const std::lock_guard lock(mutex);
+            ++counts.at(listener == ls1.sock ? 0 : 1);
+            if (counts.at(0) + counts.at(1) == 2 * per_listener) {
+                self->stop();
+            }
+        }
+    );
+    self = &acceptor;
+
+    std::thread t1([&acceptor]() { acceptor.run(); });
+    std::thread t2([&acceptor]() { acceptor.run(); });
+
+    connect_clients(ls1.sock, per_listener, clients);
+    connect_clients(ls2.sock, per_listener, clients);
+
+    t1.join();
+    t2.join();
+
+    EXPECT_EQ(counts.at(0), per_listener);
+    EXPECT_EQ(counts.at(1), per_listener);
+}
+
+TEST(EpollAcceptor, Budget)
+{
+    const auto busy  = psb::create_listening_socket("127.0.0.1", 0, listener_options);
+    auto close_busy  = gsl::finally([sock = busy.sock]() { close(sock); });
+    const auto quiet = psb::create_listening_socket("127.0.0.1", 0, listener_options);
+    auto close_quiet = gsl::finally([sock = quiet.sock]() { close(sock); });
+    const std::array listeners{busy.sock, quiet.sock};
+
+    std::vector<int> clients;
+    auto close_clients = gsl::finally([&clients]() {
+        for (const auto client : clients) {
+            close(client);
+        }
+    });
+
+    connect_clients(busy.sock, 32, clients);
+    connect_clients(quiet.sock, 1, clients);
+
+    std::size_t busy_accepted = 0;
+    psb::epoll_acceptor* self = nullptr;
+    psb::epoll_acceptor acceptor(
+        listeners, {.accept_budget = 2}, [&](int listener, const psb::accepted_socket_t& sock) {
+            close(sock.sock);
+            if (listener == busy.sock) {
+                ++busy_accepted;
+            }
+            else {
+                self->stop();
+            }
+        }
+    );
+    self = &acceptor;
+
+    acceptor.run();
+
+    // The quiet listener is served within the first wakeup, before the busy one is drained
+    EXPECT_LE(busy_accepted, 2);
+}
+
+TEST(EpollAcceptor, Admission)
+{
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, listener_options);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+    const std::array listeners{ls.sock};
+
+    constexpr std::size_t total = 8;
+    std::vector<int> clients;
+    auto close_clients = gsl::finally([&clients]() {
+        for (const auto client : clients) {
+            close(client);
+        }
+    });
+
+    connect_clients(ls.sock, total, clients);
+
+    // Two connections at once, then one per millisecond: accepting has to pause a few times
+    psb::admission_controller admission({.rate = 1000, .burst = 2, .max_inflight = 0, .reset_on_overload = 0});
+
+    std::size_t accepted      = 0;
+    psb::epoll_acceptor* self = nullptr;
+    psb::epoll_acceptor acceptor(
+        listeners, {.accept_budget = 0, .admission = &admission}, [&](int, const psb::accepted_socket_t& sock) {
+            close(sock.sock);
+            admission.release();
+            if (++accepted == total) {
+                self->stop();
+            }
+        }
+    );
+    self = &acceptor;
+
+    acceptor.run();
+
+    EXPECT_EQ(accepted, total);
+    EXPECT_GT(admission.stats().paused, 0);
+}
+
+TEST(EpollAcceptor, QuickAck)
+{
+    // TCP_QUICKACK is not supported on UNIX sockets, so the failure shows that it is set on every accepted socket
+    psb::socket_options_t opts = listener_options;
+    opts.quick_ack             = 1;
+
+    const auto ls   = psb::create_listening_socket(std::format("@psb-sockutils-epoll-{}", getpid()), 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+    const std::array listeners{ls.sock};
+
+    std::vector<int> clients;
+    auto close_clients = gsl::finally([&clients]() {
+        for (const auto client : clients) {
+            close(client);
+        }
+    });
+
+    constexpr std::size_t total = 4;
+    connect_clients(ls.sock, total, clients);
+
+    std::size_t accepted = 0;
+    std::size_t failures = 0;
+    std::error_code error;
+    psb::epoll_acceptor* self = nullptr;
+    psb::epoll_acceptor acceptor(
+        listeners, {.accept_budget = 0, .socket_options = &opts},
+        [&](int, const psb::accepted_socket_t& sock) {
+            close(sock.sock);
+            if (++accepted == total) {
+                self->stop();
+            }
+        },
+        [&](int, const std::error_code& ec) {
+            error = ec;
+            ++failures;
+        }
+    );
+    self = &acceptor;
+
+    acceptor.run();
+    EXPECT_EQ(accepted, total);
+    EXPECT_GE(failures, 1);
+    EXPECT_EQ(error, std::errc::operation_not_supported);
+}
+
+TEST(EpollAcceptor, StopBeforeRun)
+{
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, listener_options);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+    const std::array listeners{ls.sock};
+
+    psb::epoll_acceptor acceptor(listeners, {.accept_budget = 0}, [](int, const psb::accepted_socket_t&) {});
+    acceptor.stop();
+    EXPECT_NO_THROW(acceptor.run());
+}
+
+TEST(EpollAcceptor, Error)
+{
+    // A socket which is not listening is reported by epoll (EPOLLHUP), and accept() fails on it with EINVAL
+    const auto sock = create_socket(AF_INET, SOCK_STREAM, 0);
+    auto close_sock = gsl::finally([sock]() { close(sock); });
+    const std::array listeners{sock};
+
+    std::error_code error;
+    psb::epoll_acceptor* self = nullptr;
+    psb::epoll_acceptor acceptor(
+        listeners, {.accept_budget = 0}, [](int, const psb::accepted_socket_t&) {},
+        [&error, &self](int, const std::error_code& ec) {
+            error = ec;
+            self->stop();
+        }
+    );
+    self = &acceptor;
+
+    acceptor.run();
+    EXPECT_EQ(error, std::errc::invalid_argument);
+}
+
+TEST(EpollAcceptor, ErrorThrows)
+{
+    const auto sock = create_socket(AF_INET, SOCK_STREAM, 0);
+    auto close_sock = gsl::finally([sock]() { close(sock); });
+    const std::array listeners{sock};
+
+    psb::epoll_acceptor acceptor(listeners, {.accept_budget = 0}, [](int, const psb::accepted_socket_t&) {});
+    EXPECT_THROW(acceptor.run(), std::system_error);
+}
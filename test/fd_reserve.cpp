@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "epoll_acceptor.h"
+#include "fd_reserve.h"
+#include "sockutils.h"
+#include "utils.h"
+
+// The tests lower RLIMIT_NOFILE to run out of descriptors, so they run in child processes
+
+namespace {
+
+constexpr psb::socket_options_t opts{
+    .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+};
+
+std::vector<int> connect_clients(int listener, std::size_t n)
+{
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    get_sock_name(listener, ss, len);
+
+    std::vector<int> clients;
+    for (std::size_t i = 0; i < n; ++i) {
+        clients.push_back(connect_to(ss, len));
+    }
+
+    return clients;
+}
+
+/**
+ * Lowers the soft descriptor limit so that only @a spare more descriptors can be opened.
+ */
+void limit_descriptors(int spare)
+{
+    const int fd = dup(0);
+    close(fd);
+
+    rlimit lim{};
+    getrlimit(RLIMIT_NOFILE, &lim);
+    lim.rlim_cur = static_cast<rlim_t>(fd + spare);
+    setrlimit(RLIMIT_NOFILE, &lim);
+}
+
+std::size_t count_resets(const std::vector<int>& clients)
+{
+    std::size_t resets = 0;
+    for (const auto client : clients) {
+        char c{};
+        if (recv(client, &c, 1, MSG_DONTWAIT) == -1 && errno == ECONNRESET) {
+            ++resets;
+        }
+    }
+
+    return resets;
+}
+
+}  // namespace
+
+TEST(FdReserveDeathTest, Drain)
+{
+    EXPECT_EXIT(
+        {
+            const auto ls      = psb::create_listening_socket("127.0.0.1", 0, opts);
+            const auto clients = connect_clients(ls.sock, 3);
+            psb::fd_reserve reserve;
+            limit_descriptors(0);
+
+            std::error_code ec;
+            const auto sock      = psb::accept_raw_connection(ls.sock, ec);
+            const bool exhausted = sock.sock == -1 && ec == std::errc::too_many_files_open;
+
+            const auto dropped = reserve.drain(ls.sock);
+            const bool drained = dropped == 3 && reserve.dropped() == 3 && reserve.armed() &&
+                                 psb::get_listen_queue(ls.sock).length == 0 && count_resets(clients) == 3;
+
+            std::exit(exhausted && drained ? 0 : 1);  // NOLINT(concurrency-mt-unsafe)
+        },
+        ::testing::ExitedWithCode(0), ""
+    );
+}
+
+TEST(FdReserveDeathTest, EpollAcceptor)
+{
+    EXPECT_EXIT(
+        {
+            const auto ls = psb::create_listening_socket("127.0.0.1", 0, opts);
+            const std::array listeners{ls.sock};
+            const auto clients = connect_clients(ls.sock, 3);
+            psb::fd_reserve reserve;
+
+            std::atomic<std::size_t> accepted{0};
+            psb::epoll_acceptor acceptor(
+                listeners, {.accept_budget = 0, .admission = nullptr, .reserve = &reserve},
+                [&accepted](int, const psb::accepted_socket_t& sock) {
+                    close(sock.sock);
+                    ++accepted;
+                }
+            );
+
+            std::thread stopper([&acceptor, &reserve]() {
+                while (reserve.dropped() < 3) {
+                    std::this_thread::yield();
+                }
+
+                acceptor.stop();
+            });
+
+            // Room for the epoll instance only: every accept fails with EMFILE, which must not end run()
+            limit_descriptors(1);
+            acceptor.run();
+            stopper.join();
+
+            std::exit(accepted == 0 && count_resets(clients) == 3 ? 0 : 1);  // NOLINT(concurrency-mt-unsafe)
+        },
+        ::testing::ExitedWithCode(0), ""
+    );
+}
+
+TEST(FdReserveDeathTest, EpollAcceptorWithoutSpare)
+{
+    EXPECT_EXIT(
+        {
+            const auto ls = psb::create_listening_socket("127.0.0.1", 0, opts);
+            const std::array listeners{ls.sock};
+            const auto clients = connect_clients(ls.sock, 1);
+
+            // Keeps room for the epoll instance below the spare descriptor
+            const int placeholder = dup(0);
+            psb::fd_reserve reserve;
+            psb::epoll_acceptor acceptor(
+                listeners, {.accept_budget = 0, .admission = nullptr, .reserve = &reserve},
+                [](int, const psb::accepted_socket_t& sock) { close(sock.sock); }
+            );
+
+            std::thread stopper([&acceptor]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));  // NOLINT(readability-magic-numbers)
+                acceptor.stop();
+            });
+
+            // The spare descriptor is above the limit: once given up, neither it nor a connection can be opened, and
+            // every drain() drops nothing
+            close(placeholder);
+            rlimit lim{};
+            getrlimit(RLIMIT_NOFILE, &lim);
+            lim.rlim_cur = static_cast<rlim_t>(placeholder + 1);
+            setrlimit(RLIMIT_NOFILE, &lim);
+
+            rusage before{};
+            getrusage(RUSAGE_SELF, &before);
+            acceptor.run();
+            stopper.join();
+            rusage after{};
+            getrusage(RUSAGE_SELF, &after);
+
+            // Spinning on the readable listener would take the whole 200 ms
+            const auto cpu_us = [](const rusage& usage) {
+                return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 + usage.ru_utime.tv_usec +
+                       usage.ru_stime.tv_usec;
+            };
+
+            const bool idle = cpu_us(after) - cpu_us(before) < 50000;  // NOLINT(readability-magic-numbers)
+            std::exit(!reserve.armed() && idle ? 0 : 1);               // NOLINT(concurrency-mt-unsafe)
+        },
+        ::testing::ExitedWithCode(0), ""
+    );
+}
+
+TEST(FdReserveDeathTest, RaiseFdLimit)
+{
+    EXPECT_EXIT(
+        {
+            rlimit lim{};
+            getrlimit(RLIMIT_NOFILE, &lim);
+            const auto hard = lim.rlim_max;
+            lim.rlim_cur    = std::min<rlim_t>(hard, 256);
+            setrlimit(RLIMIT_NOFILE, &lim);
+
+            const auto raised = psb::raise_fd_limit();
+            getrlimit(RLIMIT_NOFILE, &lim);
+
+            std::exit(raised == hard && lim.rlim_cur == hard ? 0 : 1);  // NOLINT(concurrency-mt-unsafe)
+        },
+        ::testing::ExitedWithCode(0), ""
+    );
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string_view>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "sockutils.h"
+
+namespace {
+
+std::string_view expected_ipv4(const in_addr& addr, std::array<char, INET_ADDRSTRLEN>& buf)
+{
+    return inet_ntop(AF_INET, &addr, buf.data(), buf.size());
+}
+
+std::string_view expected_ipv6(const in6_addr& addr, std::array<char, INET6_ADDRSTRLEN>& buf)
+{
+    return inet_ntop(AF_INET6, &addr, buf.data(), buf.size());
+}
+
+std::string_view actual_ipv4(const in_addr& addr, psb::address_buffer_t& buf)
+{
+    sockaddr_storage ss{};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto& sin      = reinterpret_cast<sockaddr_in&>(ss);
+    sin.sin_family = AF_INET;
+    sin.sin_addr   = addr;
+    return psb::format_address(ss, sizeof(sockaddr_in), buf);
+}
+
+std::string_view actual_ipv6(const in6_addr& addr, psb::address_buffer_t& buf)
+{
+    sockaddr_storage ss{};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto& sin6       = reinterpret_cast<sockaddr_in6&>(ss);
+    sin6.sin6_family = AF_INET6;
+    sin6.sin6_addr   = addr;
+    return psb::format_address(ss, sizeof(sockaddr_in6), buf);
+}
+
+void check_ipv4(std::uint32_t value)
+{
+    const in_addr addr{.s_addr = htonl(value)};
+    std::array<char, INET_ADDRSTRLEN> expected{};
+    psb::address_buffer_t actual{};
+    ASSERT_EQ(actual_ipv4(addr, actual), expected_ipv4(addr, expected));
+}
+
+void check_ipv6(const std::array<std::uint16_t, 8>& words)
+{
+    in6_addr addr{};
+    for (std::size_t i = 0; i < words.size(); ++i) {
+        addr.s6_addr[2 * i]     = static_cast<std::uint8_t>(words.at(i) >> 8U);
+        addr.s6_addr[2 * i + 1] = static_cast<std::uint8_t>(words.at(i) & 0xFFU);
+    }
+
+    std::array<char, INET6_ADDRSTRLEN> expected{};
+    psb::address_buffer_t actual{};
+    ASSERT_EQ(actual_ipv6(addr, actual), expected_ipv6(addr, expected));
+}
+
+}  // namespace
+
+TEST(FormatAddress, IPv4EveryOctet)
+{
+    for (std::uint32_t octet = 0; octet < 256; ++octet) {
+        for (std::uint32_t shift = 0; shift < 32; shift += 8) {
+            check_ipv4(octet << shift);
+            check_ipv4((octet << shift) | 0x01010101U);
+        }
+    }
+}
+
+TEST(FormatAddress, IPv4Random)
+{
+    std::mt19937 gen(0x50C4U);  // NOLINT(cert-msc32-c,cert-msc51-cpp)
+    std::uniform_int_distribution<std::uint32_t> dist;
+    for (int i = 0; i < 100'000; ++i) {
+        check_ipv4(dist(gen));
+    }
+}
+
+TEST(FormatAddress, IPv6ZeroRuns)
+{
+    // Every combination of zero / non-zero groups, with non-zero groups of every width
+    constexpr std::array<std::uint16_t, 5> values{0x1, 0x2a, 0xbcd, 0xffff, 0x8000};
+    for (unsigned int mask = 0; mask < 256; ++mask) {
+        for (const auto value : values) {
+            std::array<std::uint16_t, 8> words{};
+            for (std::size_t i = 0; i < words.size(); ++i) {
+                words.at(i) = ((mask >> i) & 1U) != 0 ? value : 0;
+            }
+
+            check_ipv6(words);
+        }
+    }
+}
+
+TEST(FormatAddress, IPv6EmbeddedIPv4)
+{
+    check_ipv6({0, 0, 0, 0, 0, 0xffff, 0x7f00, 0x1});  // ::ffff:127.0.0.1
+    check_ipv6({0, 0, 0, 0, 0, 0xffff, 0, 0});         // ::ffff:0.0.0.0
+    check_ipv6({0, 0, 0, 0, 0, 0, 0x102, 0x304});      // ::1.2.3.4
+    check_ipv6({0, 0, 0, 0, 0, 0, 0x1, 0});            // ::0.1.0.0
+    check_ipv6({0, 0, 0, 0, 0, 0, 0, 0x1});            // ::1
+    check_ipv6({0, 0, 0, 0, 0, 0xfffe, 0x7f00, 0x1});  // not mapped
+    check_ipv6({0, 0, 0, 0, 0x1, 0xffff, 0x7f00, 0x1});
+    check_ipv6({0x64, 0xff9b, 0, 0, 0, 0, 0xc000, 0x221});
+}
+
+TEST(FormatAddress, IPv6Random)
+{
+    std::mt19937 gen(0x50C6U);  // NOLINT(cert-msc32-c,cert-msc51-cpp)
+    std::uniform_int_distribution<unsigned int> word_dist(0, 0xFFFF);
+    std::uniform_int_distribution<unsigned int> zero_dist(0, 2);
+    for (int i = 0; i < 100'000; ++i) {
+        std::array<std::uint16_t, 8> words{};
+        for (auto& word : words) {
+            // Bias towards zero groups to exercise the compression logic
+            word = zero_dist(gen) == 0 ? 0 : static_cast<std::uint16_t>(word_dist(gen) >> (word_dist(gen) % 16));
+        }
+
+        check_ipv6(words);
+    }
+}
+
+TEST(FormatAddress, UnsupportedFamily)
+{
+    sockaddr_storage ss{};
+    ss.ss_family = AF_UNSPEC;
+
+    psb::address_buffer_t buf{};
+    EXPECT_TRUE(psb::format_address(ss, sizeof(ss), buf).empty());
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <format>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "sockutils.h"
+
+TEST(FormatPeer, IPv4)
+{
+    const psb::socket_info_t info{.address = "127.0.0.1", .port = 8080};
+    EXPECT_EQ(std::format("{}", info), "127.0.0.1:8080");
+}
+
+TEST(FormatPeer, IPv6)
+{
+    const psb::socket_info_t info{.address = "::1", .port = 443};
+    EXPECT_EQ(std::format("{}", info), "[::1]:443");
+}
+
+TEST(FormatPeer, Local)
+{
+    const psb::socket_info_t info{.address = "/run/app.sock", .port = 0};
+    EXPECT_EQ(std::format("{}", info), "/run/app.sock");
+}
+
+TEST(FormatPeer, FormatSpec)
+{
+    const psb::socket_info_t info{.address = "10.0.0.1", .port = 80};
+    EXPECT_EQ(std::format("<{:>14}>", info), "<   10.0.0.1:80>");
+}
+
+TEST(FormatPeer, Raw)
+{
+    psb::raw_accepted_socket_t sock{};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto& sin6       = reinterpret_cast<sockaddr_in6&>(sock.addr);
+    sin6.sin6_family = AF_INET6;
+    sin6.sin6_port   = htons(12345);
+    ASSERT_EQ(inet_pton(AF_INET6, "2001:db8::1", &sin6.sin6_addr), 1);
+    sock.addr_len = sizeof(sin6);
+
+    EXPECT_EQ(std::format("{}", sock), "[2001:db8::1]:12345");
+
+    psb::peer_buffer_t buf{};
+    EXPECT_EQ(psb::format_peer(sock, buf), "[2001:db8::1]:12345");
+}
+
+TEST(FormatPeer, Truncated)
+{
+    const psb::socket_info_t info{.address = std::string(psb::max_peer_length, 'x'), .port = 1};
+
+    psb::peer_buffer_t buf{};
+    EXPECT_EQ(psb::format_peer(info, buf), std::string(psb::max_peer_length, 'x'));
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cerrno>
+#include <system_error>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "sockutils.h"
+#include "utils.h"
+
+namespace {
+
+constexpr int backlog = 8;
+
+constexpr psb::socket_options_t opts{
+    .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = backlog
+};
+
+}  // namespace
+
+TEST(GetListenQueue, QueueLength)
+{
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    auto queue = psb::get_listen_queue(ls.sock);
+    EXPECT_EQ(queue.length, 0);
+    EXPECT_EQ(queue.max_length, backlog);
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(ls.sock, ss, len));
+
+    std::array<int, 3> clients{};
+    auto close_clients = gsl::finally([&clients]() {
+        for (const auto sock : clients) {
+            close(sock);
+        }
+    });
+
+    for (auto& sock : clients) {
+        ASSERT_NO_THROW(sock = connect_to(ss, len));
+    }
+
+    queue = psb::get_listen_queue(ls.sock);
+    EXPECT_EQ(queue.length, clients.size());
+}
+
+TEST(GetListenQueue, NotListening)
+{
+    int sock{};
+    ASSERT_NO_THROW(sock = create_socket(AF_INET, SOCK_STREAM, 0));
+    auto close_socket = gsl::finally([sock]() { close(sock); });
+
+    std::error_code ec;
+    const auto queue = psb::get_listen_queue(sock, ec);
+    EXPECT_EQ(ec, std::errc::invalid_argument);
+    EXPECT_EQ(queue.max_length, 0);
+
+    EXPECT_THROW(psb::get_listen_queue(sock), std::system_error);
+}
+
+TEST(GetListenQueue, BadFD)
+{
+    std::error_code ec;
+    psb::get_listen_queue(-1, ec);
+    EXPECT_EQ(ec, std::errc::bad_file_descriptor);
+}
@@ -0,0 +1,14 @@
+#include <gtest/gtest.h>
+
+#include <system_error>
+
+#include "sockutils.h"
+
+TEST(GetMaxListenBacklog, HappyPath)
+{
+    std::error_code ec;
+    const auto backlog = psb::get_max_listen_backlog(ec);
+    ASSERT_FALSE(ec);
+    EXPECT_GT(backlog, 0);
+    EXPECT_EQ(psb::get_max_listen_backlog(), backlog);
+}
@@ -1,9 +1,11 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <format>
 #include <string>
 
 #include <gsl/util>
+#include <arpa/inet.h>
 #include <fcntl.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
@@ -149,3 +151,27 @@ TEST(GetSocketInfo, RegularLocalSocket)
     EXPECT_EQ(actual.address, std::string(name.data(), name.size()));
     EXPECT_EQ(actual.port, 0);
 }
+
+TEST(GetSocketInfo, IPv4MappedIPv6)
+{
+    sockaddr_storage ss{};
+    auto& sin6       = reinterpret_cast<sockaddr_in6&>(ss);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    sin6.sin6_family = AF_INET6;
+    sin6.sin6_port   = htons(8080);  // NOLINT(readability-magic-numbers)
+    ASSERT_EQ(inet_pton(AF_INET6, "::ffff:192.0.2.1", &sin6.sin6_addr), 1);
+
+    const auto actual = psb::get_socket_info(ss, sizeof(sockaddr_in6));
+    EXPECT_EQ(actual.address, "192.0.2.1");
+    EXPECT_EQ(actual.port, 8080);
+
+    // format_address() keeps the inet_ntop() form
+    psb::address_buffer_t buf{};
+    EXPECT_EQ(psb::format_address(ss, sizeof(sockaddr_in6), buf), "::ffff:192.0.2.1");
+
+    // The peer of an accepted socket is formatted like get_socket_info() reports it
+    const psb::raw_accepted_socket_t sock{.sock = -1, .addr = ss, .addr_len = sizeof(sockaddr_in6)};
+    psb::peer_buffer_t peer{};
+    EXPECT_EQ(psb::format_peer(sock, peer), "192.0.2.1:8080");
+    EXPECT_EQ(std::format("{}", sock), "192.0.2.1:8080");
+    EXPECT_EQ(std::format("{}", actual), "192.0.2.1:8080");
+}
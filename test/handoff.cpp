@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "handoff.h"
+#include "sockutils.h"
+#include "utils.h"
+
+namespace {
+
+constexpr psb::socket_options_t opts{
+    .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+};
+
+std::uint16_t get_port(int sock)
+{
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    get_sock_name(sock, ss, len);
+    return psb::get_socket_info(ss, len).port;
+}
+
+}  // namespace
+
+TEST(Handoff, SendReceive)
+{
+    std::array<int, 2> pair{};
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+    auto close_pair = gsl::finally([&pair]() {
+        close(pair[0]);
+        close(pair[1]);
+    });
+
+    const std::vector<psb::listening_socket_t> listeners = {
+        psb::create_listening_socket("127.0.0.1", 0, opts), psb::create_udp_socket("127.0.0.1", 0, opts)
+    };
+    auto close_listeners = gsl::finally([&listeners]() {
+        for (const auto& s : listeners) {
+            close(s.sock);
+        }
+    });
+
+    ASSERT_NO_THROW(psb::send_listeners(pair[0], listeners));
+
+    std::vector<psb::listening_socket_t> received;
+    ASSERT_NO_THROW(received = psb::receive_listeners(pair[1]));
+    auto close_received = gsl::finally([&received]() {
+        for (const auto& s : received) {
+            close(s.sock);
+        }
+    });
+
+    ASSERT_EQ(received.size(), listeners.size());
+    for (std::size_t i = 0; i < received.size(); ++i) {
+        EXPECT_NE(received[i].sock, listeners[i].sock);
+        EXPECT_EQ(received[i].transport, listeners[i].transport);
+        EXPECT_EQ(received[i].type, listeners[i].type);
+        EXPECT_EQ(get_port(received[i].sock), get_port(listeners[i].sock));
+        EXPECT_NE(get_fd_flags(static_cast<unsigned int>(received[i].sock)) & FD_CLOEXEC, 0U);
+        EXPECT_NE(get_status_flags(received[i].sock) & O_NONBLOCK, 0U);
+    }
+
+    // The received socket shares the accept queue with the original one
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    get_sock_name(listeners[0].sock, ss, len);
+    const int client = connect_to(ss, len);
+    auto close_client = gsl::finally([client]() { close(client); });
+
+    psb::accepted_socket_t accepted;
+    ASSERT_NO_THROW(accepted = psb::accept_connection(received[0].sock));
+    close(accepted.sock);
+}
+
+TEST(Handoff, InvalidMessage)
+{
+    std::array<int, 2> pair{};
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()), 0);
+    auto close_pair = gsl::finally([&pair]() {
+        close(pair[0]);
+        close(pair[1]);
+    });
+
+    std::error_code ec;
+    psb::send_listeners(pair[0], {}, ec);
+    EXPECT_EQ(ec, std::errc::invalid_argument);
+
+    constexpr std::string_view garbage = "hello\n";
+    ASSERT_EQ(send(pair[0], garbage.data(), garbage.size(), 0), static_cast<ssize_t>(garbage.size()));
+
+    const auto received = psb::receive_listeners(pair[1], ec);
+    EXPECT_EQ(ec, std::errc::protocol_error);
+    EXPECT_TRUE(received.empty());
+    EXPECT_THROW(psb::receive_listeners(-1), std::system_error);
+}
+
+TEST(Handoff, InheritedListenersIgnoresOtherProcess)
+{
+    ASSERT_EQ(setenv("LISTEN_PID", std::to_string(getpid() + 1).c_str(), 1), 0);
+    ASSERT_EQ(setenv("LISTEN_FDS", "1", 1), 0);
+    auto unset = gsl::finally([]() {
+        unsetenv("LISTEN_PID");
+        unsetenv("LISTEN_FDS");
+    });
+
+    EXPECT_TRUE(psb::inherited_listeners().empty());
+    EXPECT_NE(std::getenv("LISTEN_FDS"), nullptr);
+}
+
+TEST(HandoffDeathTest, InheritedListeners)
+{
+    // The sockets must be at descriptors 3 and 4, so this runs in a child process
+    EXPECT_EXIT(
+        {
+            const auto tcp = psb::create_listening_socket("127.0.0.1", 0, opts);
+            const auto udp = psb::create_udp_socket("127.0.0.1", 0, opts);
+            const auto port = get_port(tcp.sock);
+
+            const int tcp_fd = fcntl(tcp.sock, F_DUPFD, 100);
+            const int udp_fd = fcntl(udp.sock, F_DUPFD, 100);
+            close(tcp.sock);
+            close(udp.sock);
+            dup2(tcp_fd, 3);
+            dup2(udp_fd, 4);
+
+            setenv("LISTEN_PID", std::to_string(getpid()).c_str(), 1);
+            setenv("LISTEN_FDS", "2", 1);
+
+            auto inherited = psb::inherited_listeners();
+            const bool described = inherited.size() == 2 && inherited[0].sock == 3 &&
+                                   std::string_view(inherited[0].transport) == "tcp" &&
+                                   std::string_view(inherited[1].transport) == "udp" &&
+                                   (get_status_flags(3) & O_NONBLOCK) != 0 && std::getenv("LISTEN_FDS") == nullptr;
+
+            const auto adopted = psb::adopt_listening_socket(inherited, "127.0.0.1", port, opts);
+            const bool taken   = adopted.sock == 3 && inherited.size() == 1 && inherited[0].sock == 4;
+
+            std::exit(described && taken ? 0 : 1);  // NOLINT(concurrency-mt-unsafe)
+        },
+        ::testing::ExitedWithCode(0), ""
+    );
+}
+
+TEST(HandoffDeathTest, InheritedListenersFailure)
+{
+    // Descriptor 4 is not a socket: the sockets before and after it must not leak
+    EXPECT_EXIT(
+        {
+            const auto first  = psb::create_listening_socket("127.0.0.1", 0, opts);
+            const auto second = psb::create_listening_socket("127.0.0.1", 0, opts);
+            const int file    = open("/dev/null", O_RDONLY | O_CLOEXEC);  // NOLINT(cppcoreguidelines-pro-type-vararg)
+
+            const int first_fd  = fcntl(first.sock, F_DUPFD, 100);
+            const int file_fd   = fcntl(file, F_DUPFD, 100);
+            const int second_fd = fcntl(second.sock, F_DUPFD, 100);
+            close(first.sock);
+            close(second.sock);
+            close(file);
+            dup2(first_fd, 3);
+            dup2(file_fd, 4);
+            dup2(second_fd, 5);
+            close(first_fd);
+            close(file_fd);
+            close(second_fd);
+
+            setenv("LISTEN_PID", std::to_string(getpid()).c_str(), 1);
+            setenv("LISTEN_FDS", "3", 1);
+
+            std::error_code ec;
+            const auto inherited = psb::inherited_listeners(ec);
+            const bool failed    = inherited.empty() && ec == std::errc::not_a_socket;
+
+            bool closed = true;
+            for (int fd = 3; fd <= 5; ++fd) {
+                closed = closed && fcntl(fd, F_GETFD) == -1 && errno == EBADF;
+            }
+
+            std::exit(failed && closed ? 0 : 1);  // NOLINT(concurrency-mt-unsafe)
+        },
+        ::testing::ExitedWithCode(0), ""
+    );
+}
+
+TEST(Handoff, AdoptListeningSocket)
+{
+    std::vector<psb::listening_socket_t> inherited = {psb::create_listening_socket("127.0.0.1", 0, opts)};
+    const auto port                                = get_port(inherited[0].sock);
+    const int sock                                 = inherited[0].sock;
+
+    // Different address: a new socket
+    const auto other = psb::adopt_listening_socket(inherited, "127.0.0.2", port, opts);
+    auto close_other = gsl::finally([sock = other.sock]() { close(sock); });
+    EXPECT_NE(other.sock, sock);
+    EXPECT_EQ(inherited.size(), 1);
+
+    std::error_code ec;
+    const auto invalid = psb::adopt_listening_socket(inherited, "localhost", port, opts, ec);
+    EXPECT_EQ(ec, std::errc::invalid_argument);
+    EXPECT_EQ(invalid.sock, -1);
+    EXPECT_THROW(psb::adopt_listening_socket(inherited, "localhost", port, opts), std::invalid_argument);
+
+    const auto adopted = psb::adopt_listening_socket(inherited, "127.0.0.1", port, opts, ec);
+    auto close_adopted = gsl::finally([sock = adopted.sock]() { close(sock); });
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(adopted.sock, sock);
+    EXPECT_TRUE(inherited.empty());
+}
@@ -26,3 +26,18 @@ TEST(MakeCloseOnExec, BadFD)
 {
     EXPECT_THROW(psb::make_close_on_exec(-1), std::system_error);
 }
+
+TEST(MakeCloseOnExec, ErrorCode)
+{
+    std::error_code ec;
+    psb::make_close_on_exec(-1, ec);
+    EXPECT_EQ(ec, std::errc::bad_file_descriptor);
+
+    int sock{};
+    ASSERT_NO_THROW(sock = create_socket(AF_INET, SOCK_STREAM, 0));
+    auto close_socket = gsl::finally([sock]() { close(sock); });
+
+    psb::make_close_on_exec(sock, ec);
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(get_fd_flags(sock) & FD_CLOEXEC, FD_CLOEXEC);
+}
@@ -43,3 +43,18 @@ TEST(MakeNonblockingTest, Functional)
     EXPECT_EQ(actual_res, -1);
     EXPECT_TRUE(actual_errno == EAGAIN || actual_errno == EWOULDBLOCK);
 }
+
+TEST(MakeNonblockingTest, ErrorCode)
+{
+    std::error_code ec;
+    psb::make_nonblocking(-1, ec);
+    EXPECT_EQ(ec, std::errc::bad_file_descriptor);
+
+    int sock{};
+    ASSERT_NO_THROW(sock = create_socket(AF_INET, SOCK_STREAM, 0));
+    auto close_socket = gsl::finally([sock]() { close(sock); });
+
+    psb::make_nonblocking(sock, ec);
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(get_status_flags(sock) & O_NONBLOCK, O_NONBLOCK);
+}
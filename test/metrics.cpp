@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+#include <opentelemetry/metrics/noop.h>
+#include <opentelemetry/metrics/provider.h>
+
+#include "metrics.h"
+#include "sockutils.h"
+#include "utils.h"
+
+namespace {
+
+namespace otel_metrics = opentelemetry::metrics;
+namespace nostd        = opentelemetry::nostd;
+
+constexpr psb::socket_options_t opts{
+    .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+};
+
+// Any provider other than the no-op one enables the metrics
+class test_meter_provider final : public otel_metrics::MeterProvider {
+public:
+#if defined(OPENTELEMETRY_ABI_VERSION_NO) && OPENTELEMETRY_ABI_VERSION_NO >= 2
+    nostd::shared_ptr<otel_metrics::Meter> GetMeter(
+        nostd::string_view /*name*/, nostd::string_view /*version*/, nostd::string_view /*schema_url*/,
+        const opentelemetry::common::KeyValueIterable* /*attributes*/
+    ) noexcept override
+#else
+    nostd::shared_ptr<otel_metrics::Meter> GetMeter(
+        nostd::string_view /*name*/, nostd::string_view /*version*/, nostd::string_view /*schema_url*/
+    ) noexcept override
+#endif
+    {
+        return nostd::shared_ptr<otel_metrics::Meter>(std::make_shared<otel_metrics::NoopMeter>());
+    }
+};
+
+}  // namespace
+
+TEST(Metrics, NoopProvider)
+{
+    otel_metrics::Provider::SetMeterProvider(
+        nostd::shared_ptr<otel_metrics::MeterProvider>(std::make_shared<otel_metrics::NoopMeterProvider>())
+    );
+
+    EXPECT_FALSE(psb::enable_metrics());
+}
+
+TEST(Metrics, AcceptPath)
+{
+    otel_metrics::Provider::SetMeterProvider(
+        nostd::shared_ptr<otel_metrics::MeterProvider>(std::make_shared<test_meter_provider>())
+    );
+
+    auto restore = gsl::finally([]() {
+        psb::disable_metrics();
+        otel_metrics::Provider::SetMeterProvider(
+            nostd::shared_ptr<otel_metrics::MeterProvider>(std::make_shared<otel_metrics::NoopMeterProvider>())
+        );
+    });
+
+    ASSERT_TRUE(psb::enable_metrics());
+
+    const auto before = psb::get_accept_metrics();
+
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(ls.sock, ss, len));
+
+    constexpr std::size_t connections = 2;
+    std::array<int, connections> clients{};
+    auto close_clients = gsl::finally([&clients]() {
+        for (const auto sock : clients) {
+            close(sock);
+        }
+    });
+
+    for (auto& sock : clients) {
+        ASSERT_NO_THROW(sock = connect_to(ss, len));
+    }
+
+    std::array<psb::accepted_socket_t, connections + 1> sockets{};
+    const auto result = psb::accept_connections(ls.sock, sockets, sockets.size());
+    ASSERT_EQ(result.count, connections);
+    EXPECT_FALSE(result.error);
+
+    close(sockets[0].sock);
+    psb::record_socket_closed();
+    close(sockets[1].sock);
+
+    const auto after = psb::get_accept_metrics();
+    EXPECT_EQ(after.accepted - before.accepted, connections);
+    EXPECT_EQ(after.eagain - before.eagain, 1);
+    EXPECT_EQ(after.closed - before.closed, 1);
+    EXPECT_EQ(after.listeners - before.listeners, 1);
+    EXPECT_EQ(after.econnaborted, before.econnaborted);
+    EXPECT_EQ(after.other_errors, before.other_errors);
+}
+
+TEST(Metrics, Disabled)
+{
+    psb::disable_metrics();
+
+    const auto before = psb::get_accept_metrics();
+    const auto ls     = psb::create_listening_socket("127.0.0.1", 0, opts);
+    close(ls.sock);
+    psb::record_socket_closed();
+
+    const auto after = psb::get_accept_metrics();
+    EXPECT_EQ(after.listeners, before.listeners);
+    EXPECT_EQ(after.closed, before.closed);
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <system_error>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include "parse_address.h"
+#include "sockutils.h"
+
+namespace {
+
+constexpr auto compile_time_ipv4 = psb::make_sockaddr_in("192.168.1.2", 8080);
+static_assert(compile_time_ipv4.sin_family == AF_INET);
+
+constexpr auto compile_time_ipv6 = psb::make_sockaddr_in6("2001:db8::ffff:1.2.3.4", 443);
+static_assert(compile_time_ipv6.sin6_family == AF_INET6);
+static_assert(compile_time_ipv6.sin6_addr.s6_addr[0] == 0x20 && compile_time_ipv6.sin6_addr.s6_addr[15] == 4);
+
+// Inputs on which hand-written parsers tend to disagree with inet_pton()
+constexpr std::array tricky_inputs{
+    "",
+    "0.0.0.0",
+    "255.255.255.255",
+    "256.0.0.1",
+    "01.2.3.4",
+    "1.2.3.04",
+    "0.0.0.00",
+    "1.2.3",
+    "1.2.3.4.",
+    ".1.2.3.4",
+    "1..2.3",
+    "1.2.3.4 ",
+    "0x1.2.3.4",
+    ":",
+    "::",
+    ":::",
+    ":1::",
+    "1:",
+    "1::",
+    "::1",
+    "1::2::3",
+    "1:::2",
+    "1:2:3:4:5:6:7:8",
+    "1:2:3:4:5:6:7:8:9",
+    "1:2:3:4:5:6:7::",
+    "::1:2:3:4:5:6:7",
+    "1:2:3:4::5:6:7:8",
+    "12345::",
+    "0000:0000::",
+    "00000::",
+    "AbCd::eF",
+    "::G",
+    "::ffff:1.2.3.4",
+    "::1.2.3.4.5",
+    "::01.2.3.4",
+    "::1.2.3",
+    "::1.2.3.4:5",
+    "1:2:3:4:5:6:1.2.3.4",
+    "1:2:3:4:5:6:7:1.2.3.4",
+    "1:2:3:4:5::1.2.3.4",
+    "1.2.3.4::",
+};
+
+}  // namespace
+
+TEST(ParseAddress, CompileTime)
+{
+    sockaddr_in expected{};
+    ASSERT_EQ(inet_pton(AF_INET, "192.168.1.2", &expected.sin_addr), 1);
+    EXPECT_EQ(compile_time_ipv4.sin_addr.s_addr, expected.sin_addr.s_addr);
+    EXPECT_EQ(compile_time_ipv4.sin_port, htons(8080));
+    EXPECT_EQ(compile_time_ipv6.sin6_port, htons(443));
+}
+
+TEST(ParseAddress, MatchesInetPton)
+{
+    for (const std::string input : tricky_inputs) {
+        in_addr expected4{};
+        in_addr actual4{};
+        const auto res4 = inet_pton(AF_INET, input.c_str(), &expected4);
+        EXPECT_EQ(psb::parse_ipv4(input, actual4) == std::errc{}, res4 == 1) << input;
+        if (res4 == 1) {
+            EXPECT_EQ(actual4.s_addr, expected4.s_addr) << input;
+        }
+
+        in6_addr expected6{};
+        in6_addr actual6{};
+        const auto res6 = inet_pton(AF_INET6, input.c_str(), &expected6);
+        EXPECT_EQ(psb::parse_ipv6(input, actual6) == std::errc{}, res6 == 1) << input;
+        if (res6 == 1) {
+            EXPECT_EQ(std::memcmp(&actual6, &expected6, sizeof(in6_addr)), 0) << input;
+        }
+    }
+}
+
+TEST(ParseAddress, NotNulTerminated)
+{
+    constexpr std::string_view input = "10.0.0.1234";
+
+    in_addr addr{};
+    ASSERT_EQ(psb::parse_ipv4(input.substr(0, 8), addr), std::errc{});
+    EXPECT_EQ(addr.s_addr, htonl(0x0A000001));
+}
+
+TEST(ParseAddress, MakeSocketAddress)
+{
+    sockaddr_storage ss{};
+    socklen_t len{};
+
+    ASSERT_EQ(psb::make_socket_address("127.0.0.1", 80, ss, len), std::errc{});
+    EXPECT_EQ(ss.ss_family, AF_INET);
+    EXPECT_EQ(len, sizeof(sockaddr_in));
+
+    ASSERT_EQ(psb::make_socket_address("::1", 80, ss, len), std::errc{});
+    EXPECT_EQ(ss.ss_family, AF_INET6);
+    EXPECT_EQ(len, sizeof(sockaddr_in6));
+
+    const auto info = psb::get_socket_info(ss, len);
+    EXPECT_EQ(info.address, "::1");
+    EXPECT_EQ(info.port, 80);
+
+    EXPECT_EQ(psb::make_socket_address("localhost", 80, ss, len), std::errc::invalid_argument);
+}
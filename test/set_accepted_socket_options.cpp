@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <system_error>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "sockutils.h"
+#include "utils.h"
+
+TEST(SetAcceptedSocketOptions, QuickAck)
+{
+    const psb::socket_options_t opts{
+        .close_on_exec        = 1,
+        .reuse_addr           = 0,
+        .free_bind            = 0,
+        .defer_accept_timeout = 0,
+        .listen_backlog       = SOMAXCONN,
+        .quick_ack            = 1,
+    };
+
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(ls.sock, ss, len));
+
+    int client{};
+    ASSERT_NO_THROW(client = connect_to(ss, len));
+    auto close_client = gsl::finally([client]() { close(client); });
+
+    psb::raw_accepted_socket_t accepted{};
+    ASSERT_NO_THROW(accepted = psb::accept_raw_connection(ls.sock));
+    auto close_accepted = gsl::finally([sock = accepted.sock]() { close(sock); });
+
+    EXPECT_NO_THROW(psb::set_accepted_socket_options(accepted.sock, opts));
+    EXPECT_NE(get_socket_option(accepted.sock, IPPROTO_TCP, TCP_QUICKACK), 0);
+}
+
+TEST(SetAcceptedSocketOptions, NothingToDo)
+{
+    const psb::socket_options_t opts{
+        .close_on_exec = 1, .reuse_addr = 0, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+    };
+
+    // No system calls are made, so even an invalid descriptor is fine
+    std::error_code ec;
+    psb::set_accepted_socket_options(-1, opts, ec);
+    EXPECT_FALSE(ec);
+}
+
+TEST(SetAcceptedSocketOptions, ErrorCode)
+{
+    const psb::socket_options_t opts{
+        .close_on_exec        = 1,
+        .reuse_addr           = 0,
+        .free_bind            = 0,
+        .defer_accept_timeout = 0,
+        .listen_backlog       = SOMAXCONN,
+        .quick_ack            = 1,
+    };
+
+    std::error_code ec;
+    psb::set_accepted_socket_options(-1, opts, ec);
+    EXPECT_EQ(ec, std::errc::bad_file_descriptor);
+    EXPECT_THROW(psb::set_accepted_socket_options(-1, opts), std::system_error);
+}
@@ -28,3 +28,10 @@ TEST(SetSocketOption, BadFD)
 {
     EXPECT_THROW(psb::set_socket_option(-1, SOL_SOCKET, SO_REUSEADDR, 1, "SO_REUSEADDR"), std::system_error);
 }
+
+TEST(SetSocketOption, ErrorCode)
+{
+    std::error_code ec;
+    psb::set_socket_option(-1, SOL_SOCKET, SO_REUSEADDR, 1, ec);
+    EXPECT_EQ(ec, std::errc::bad_file_descriptor);
+}
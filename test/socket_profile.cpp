@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "socket_profile.h"
+#include "sockutils.h"
+#include "utils.h"
+
+namespace {
+
+constexpr psb::socket_options_t minimal_opts{
+    .close_on_exec = 0, .reuse_addr = 0, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+};
+
+constexpr psb::socket_options_t full_opts{
+    .close_on_exec        = 1,
+    .reuse_addr           = 1,
+    .free_bind            = 1,
+    .defer_accept_timeout = 5,
+    .listen_backlog       = psb::listen_backlog_auto,
+    .no_delay             = 1,
+    .keep_alive           = 1,
+    .keep_idle            = 30,
+    .keep_interval        = 5,
+    .keep_count           = 3,
+    .user_timeout         = 10000,
+    .notsent_lowat        = 16384,
+    .quick_ack            = 1,
+    .v6_only              = 1,
+};
+
+using minimal_profile = psb::socket_profile<minimal_opts>;
+using full_profile    = psb::socket_profile<full_opts>;
+
+static_assert(!minimal_profile::sets_accepted_options);
+static_assert(full_profile::sets_accepted_options);
+static_assert(full_profile::options.keep_idle == 30);
+
+std::uint16_t get_port(int sock)
+{
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    get_sock_name(sock, ss, len);
+    return psb::get_socket_info(ss, len).port;
+}
+
+}  // namespace
+
+TEST(SocketProfile, Minimal)
+{
+    const auto ls    = minimal_profile::create_listening_socket("127.0.0.1", 0);
+    const auto guard = gsl::finally([&ls] { close(ls.sock); });
+
+    EXPECT_STREQ(ls.transport, "tcp");
+    EXPECT_STREQ(ls.type, "ipv4");
+    EXPECT_NE(get_status_flags(ls.sock) & O_NONBLOCK, 0);
+    EXPECT_EQ(get_fd_flags(ls.sock) & FD_CLOEXEC, 0);
+    EXPECT_EQ(get_socket_option(ls.sock, SOL_SOCKET, SO_REUSEADDR), 0);
+    EXPECT_EQ(get_socket_option(ls.sock, SOL_SOCKET, SO_ACCEPTCONN), 1);
+    EXPECT_NE(get_port(ls.sock), 0);
+}
+
+TEST(SocketProfile, AllOptions)
+{
+    const auto ls    = full_profile::create_listening_socket("127.0.0.1", 0);
+    const auto guard = gsl::finally([&ls] { close(ls.sock); });
+
+    EXPECT_NE(get_fd_flags(ls.sock) & FD_CLOEXEC, 0);
+    EXPECT_NE(get_status_flags(ls.sock) & O_NONBLOCK, 0);
+    EXPECT_EQ(get_socket_option(ls.sock, SOL_SOCKET, SO_REUSEADDR), 1);
+    EXPECT_EQ(get_socket_option(ls.sock, IPPROTO_IP, IP_FREEBIND), 1);
+    EXPECT_NE(get_socket_option(ls.sock, IPPROTO_TCP, TCP_DEFER_ACCEPT), 0);
+    EXPECT_EQ(get_socket_option(ls.sock, IPPROTO_TCP, TCP_NODELAY), 1);
+    EXPECT_EQ(get_socket_option(ls.sock, SOL_SOCKET, SO_KEEPALIVE), 1);
+    EXPECT_EQ(get_socket_option(ls.sock, IPPROTO_TCP, TCP_KEEPIDLE), 30);
+    EXPECT_EQ(get_socket_option(ls.sock, IPPROTO_TCP, TCP_KEEPINTVL), 5);
+    EXPECT_EQ(get_socket_option(ls.sock, IPPROTO_TCP, TCP_KEEPCNT), 3);
+    EXPECT_EQ(get_socket_option(ls.sock, IPPROTO_TCP, TCP_USER_TIMEOUT), 10000);
+    EXPECT_EQ(get_socket_option(ls.sock, IPPROTO_TCP, TCP_NOTSENT_LOWAT), 16384);
+}
+
+TEST(SocketProfile, IPv6)
+{
+    if (!ipv6_supported()) {
+        GTEST_SKIP() << "IPv6 is not supported";
+    }
+
+    const auto ls    = full_profile::create_listening_socket(psb::make_sockaddr_in6("::1", 0));
+    const auto guard = gsl::finally([&ls] { close(ls.sock); });
+
+    EXPECT_STREQ(ls.type, "ipv6");
+    EXPECT_EQ(get_socket_option(ls.sock, IPPROTO_IPV6, IPV6_V6ONLY), 1);
+}
+
+TEST(SocketProfile, SameAsRuntimeOptions)
+{
+    const auto profile = full_profile::create_listening_socket(psb::make_sockaddr_in("127.0.0.1", 0));
+    const auto runtime = psb::create_listening_socket("127.0.0.1", 0, full_opts);
+    const auto guard   = gsl::finally([&profile, &runtime] {
+        close(profile.sock);
+        close(runtime.sock);
+    });
+
+    constexpr std::array<std::array<int, 2>, 8> options{{
+        {SOL_SOCKET, SO_REUSEADDR},
+        {SOL_SOCKET, SO_KEEPALIVE},
+        {SOL_SOCKET, SO_RCVBUF},
+        {IPPROTO_TCP, TCP_DEFER_ACCEPT},
+        {IPPROTO_TCP, TCP_NODELAY},
+        {IPPROTO_TCP, TCP_KEEPIDLE},
+        {IPPROTO_TCP, TCP_USER_TIMEOUT},
+        {IPPROTO_TCP, TCP_NOTSENT_LOWAT},
+    }};
+
+    for (const auto& [level, name] : options) {
+        EXPECT_EQ(get_socket_option(profile.sock, level, name), get_socket_option(runtime.sock, level, name)) << name;
+    }
+
+    EXPECT_EQ(get_fd_flags(profile.sock), get_fd_flags(runtime.sock));
+    EXPECT_EQ(get_status_flags(profile.sock), get_status_flags(runtime.sock));
+}
+
+TEST(SocketProfile, AcceptedSocketOptions)
+{
+    const auto ls    = full_profile::create_listening_socket("127.0.0.1", 0);
+    const auto guard = gsl::finally([&ls] { close(ls.sock); });
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    get_sock_name(ls.sock, ss, len);
+
+    // TCP_DEFER_ACCEPT holds the connection back until data arrives
+    const auto client       = connect_to(ss, len);
+    const auto close_client = gsl::finally([client] { close(client); });
+    ASSERT_EQ(send(client, "x", 1, 0), 1);
+
+    std::array<psb::raw_accepted_socket_t, 4> sockets{};
+    psb::accept_batch_result_t result;
+    for (int i = 0; i < 100 && result.count == 0; ++i) {
+        result = full_profile::accept_connections(ls.sock, sockets, sockets.size());
+        if (result.count == 0) {
+            usleep(10'000);
+        }
+    }
+
+    ASSERT_EQ(result.count, 1);
+    const auto close_accepted = gsl::finally([&sockets] { close(sockets[0].sock); });
+    EXPECT_NE(get_socket_option(sockets[0].sock, IPPROTO_TCP, TCP_QUICKACK), 0);
+    EXPECT_NO_THROW(full_profile::set_accepted_socket_options(sockets[0].sock));
+}
+
+TEST(SocketProfile, Errors)
+{
+    std::error_code ec;
+    sockaddr_storage ss{};
+    socklen_t len{};
+    ASSERT_EQ(psb::make_socket_address("/tmp/socket_profile.sock", 0, ss, len), std::errc{});
+
+    const auto ls = minimal_profile::create_listening_socket(ss, len, ec);
+    EXPECT_EQ(ls.sock, -1);
+    EXPECT_TRUE(ec);
+
+    EXPECT_THROW(minimal_profile::create_listening_socket("not an address", 0), std::invalid_argument);
+    EXPECT_THROW(minimal_profile::create_listening_socket("/tmp/socket_profile.sock", 0), std::invalid_argument);
+
+    const auto first = minimal_profile::create_listening_socket("127.0.0.1", 0);
+    const auto guard = gsl::finally([&first] { close(first.sock); });
+    EXPECT_THROW(minimal_profile::create_listening_socket("127.0.0.1", get_port(first.sock)), std::system_error);
+}
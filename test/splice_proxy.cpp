@@ -0,0 +1,263 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "sockutils.h"
+#include "splice_proxy.h"
+#include "utils.h"
+
+namespace {
+
+constexpr psb::socket_options_t opts{
+    .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+};
+
+/**
+ * Connects to the listening socket @a ls and accepts the connection; both sockets are non-blocking.
+ */
+std::array<int, 2> connected_pair(int ls)
+{
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    get_sock_name(ls, ss, len);
+
+    const auto client = connect_to(ss, len);
+    psb::make_nonblocking(client);
+    return {client, psb::accept_connection(ls).sock};
+}
+
+/**
+ * Waits for the events in @a interest (or 10 ms) and pumps the proxy.
+ */
+psb::splice_interest_t step(psb::splice_proxy& proxy, int client, int upstream, const psb::splice_interest_t& interest)
+{
+    const auto events = [](bool read, bool write) {
+        return static_cast<short>((read ? POLLIN : 0) | (write ? POLLOUT : 0));
+    };
+
+    std::array<pollfd, 2> fds{{
+        {.fd = client, .events = events(interest.client_read, interest.client_write), .revents = 0},
+        {.fd = upstream, .events = events(interest.upstream_read, interest.upstream_write), .revents = 0},
+    }};
+
+    poll(fds.data(), fds.size(), 10);  // NOLINT(readability-magic-numbers)
+    return proxy.pump();
+}
+
+std::atomic<int> sigpipe_count{0};
+
+void count_sigpipe(int)
+{
+    ++sigpipe_count;
+}
+
+/**
+ * Reads what @a sock has received into @a out; returns false at end of stream.
+ */
+bool read_some(int sock, std::string& out)
+{
+    std::array<char, 65536> buf{};  // NOLINT(readability-magic-numbers)
+    for (;;) {
+        const auto res = recv(sock, buf.data(), buf.size(), MSG_DONTWAIT);
+        if (res == 0) {
+            return false;
+        }
+
+        if (res < 0) {
+            return true;
+        }
+
+        out.append(buf.data(), static_cast<std::size_t>(res));
+    }
+}
+
+}  // namespace
+
+TEST(PipePool, Reuse)
+{
+    psb::pipe_pool pool(1);
+
+    const auto first = pool.acquire();
+    EXPECT_GT(pool.pipe_size(), 0);
+
+    pool.release(first, true);
+    EXPECT_EQ(pool.idle(), 1);
+
+    const auto second = pool.acquire();
+    EXPECT_EQ(second.read_fd, first.read_fd);
+    EXPECT_EQ(second.write_fd, first.write_fd);
+    EXPECT_EQ(pool.idle(), 0);
+
+    // A pipe with data in it is closed rather than reused
+    pool.release(second, false);
+    EXPECT_EQ(pool.idle(), 0);
+    EXPECT_EQ(write(second.write_fd, "x", 1), -1);
+}
+
+TEST(PipePool, SigpipeDisposition)
+{
+    struct sigaction ignore{};
+    ignore.sa_handler = SIG_IGN;
+    sigemptyset(&ignore.sa_mask);
+    struct sigaction old_action{};
+    ASSERT_EQ(sigaction(SIGPIPE, &ignore, &old_action), 0);
+    auto restore_action = gsl::finally([&old_action]() { sigaction(SIGPIPE, &old_action, nullptr); });
+
+    EXPECT_TRUE(psb::pipe_pool(1).sigpipe_ignored());
+
+    struct sigaction count{};
+    count.sa_handler = count_sigpipe;
+    sigemptyset(&count.sa_mask);
+    ASSERT_EQ(sigaction(SIGPIPE, &count, nullptr), 0);
+    EXPECT_FALSE(psb::pipe_pool(1).sigpipe_ignored());
+}
+
+TEST(SpliceProxy, BothDirectionsWithHalfClose)
+{
+    const auto front = psb::create_listening_socket("127.0.0.1", 0, opts);
+    const auto back  = psb::create_listening_socket("127.0.0.1", 0, opts);
+
+    const auto [client, accepted]   = connected_pair(front.sock);
+    const auto [upstream, upserver] = connected_pair(back.sock);
+    psb::make_nonblocking(upserver);
+
+    auto close_all = gsl::finally([&]() {
+        for (const auto fd : {front.sock, back.sock, client, accepted, upstream, upserver}) {
+            close(fd);
+        }
+    });
+
+    psb::pipe_pool pool(4);  // NOLINT(readability-magic-numbers)
+    {
+        psb::splice_proxy proxy(accepted, upstream, pool);
+
+        // More than the socket and pipe buffers hold, so that the proxy has to wait for the receiver
+        const std::string request(4U << 20U, 'q');
+        std::string_view unsent = request;
+        std::string received;
+        bool upstream_open = true;
+
+        auto interest = proxy.pump();
+        for (int i = 0; i < 10000 && upstream_open; ++i) {  // NOLINT(readability-magic-numbers)
+            if (!unsent.empty()) {
+                if (const auto res = send(client, unsent.data(), unsent.size(), MSG_DONTWAIT); res > 0) {
+                    unsent.remove_prefix(static_cast<std::size_t>(res));
+                    if (unsent.empty()) {
+                        shutdown(client, SHUT_WR);
+                    }
+                }
+            }
+
+            interest      = step(proxy, accepted, upstream, interest);
+            upstream_open = read_some(upserver, received);
+        }
+
+        // The upstream has seen the end of the request, but can still respond
+        EXPECT_FALSE(upstream_open);
+        EXPECT_EQ(received.size(), request.size());
+        EXPECT_EQ(received, request);
+        EXPECT_FALSE(interest.done);
+
+        constexpr std::string_view response = "response";
+        ASSERT_EQ(send(upserver, response.data(), response.size(), 0), static_cast<ssize_t>(response.size()));
+        shutdown(upserver, SHUT_WR);
+
+        std::string reply;
+        bool client_open = true;
+        for (int i = 0; i < 1000 && (client_open || !interest.done); ++i) {  // NOLINT(readability-magic-numbers)
+            interest    = step(proxy, accepted, upstream, interest);
+            client_open = read_some(client, reply);
+        }
+
+        EXPECT_EQ(reply, response);
+        EXPECT_TRUE(interest.done);
+        EXPECT_EQ(proxy.bytes_to_upstream(), request.size());
+        EXPECT_EQ(proxy.bytes_to_client(), response.size());
+    }
+
+    EXPECT_EQ(pool.idle(), 2);
+}
+
+TEST(SpliceProxy, Reset)
+{
+    const auto front = psb::create_listening_socket("127.0.0.1", 0, opts);
+    const auto back  = psb::create_listening_socket("127.0.0.1", 0, opts);
+
+    const auto [client, accepted]   = connected_pair(front.sock);
+    const auto [upstream, upserver] = connected_pair(back.sock);
+
+    auto close_all = gsl::finally([&]() {
+        for (const auto fd : {front.sock, back.sock, accepted, upstream, upserver}) {
+            close(fd);
+        }
+    });
+
+    psb::pipe_pool pool(4);  // NOLINT(readability-magic-numbers)
+    psb::splice_proxy proxy(accepted, upstream, pool);
+
+    // Closing with unread data makes the kernel send a reset
+    constexpr linger no_linger{.l_onoff = 1, .l_linger = 0};
+    setsockopt(client, SOL_SOCKET, SO_LINGER, &no_linger, sizeof(no_linger));
+    close(client);
+
+    std::error_code ec;
+    proxy.pump(ec);
+    EXPECT_EQ(ec, std::errc::connection_reset);
+}
+
+TEST(SpliceProxy, DestinationResetDoesNotRaiseSigpipe)
+{
+    struct sigaction action{};
+    action.sa_handler = count_sigpipe;
+    sigemptyset(&action.sa_mask);
+    struct sigaction old_action{};
+    ASSERT_EQ(sigaction(SIGPIPE, &action, &old_action), 0);
+    auto restore_action = gsl::finally([&old_action]() { sigaction(SIGPIPE, &old_action, nullptr); });
+    sigpipe_count = 0;
+
+    const auto front = psb::create_listening_socket("127.0.0.1", 0, opts);
+    const auto back  = psb::create_listening_socket("127.0.0.1", 0, opts);
+
+    const auto [client, accepted]   = connected_pair(front.sock);
+    const auto [upstream, upserver] = connected_pair(back.sock);
+
+    auto close_all = gsl::finally([&]() {
+        for (const auto fd : {front.sock, back.sock, client, accepted, upstream}) {
+            close(fd);
+        }
+    });
+
+    psb::pipe_pool pool(4);  // NOLINT(readability-magic-numbers)
+    psb::splice_proxy proxy(accepted, upstream, pool);
+
+    constexpr linger no_linger{.l_onoff = 1, .l_linger = 0};
+    setsockopt(upserver, SOL_SOCKET, SO_LINGER, &no_linger, sizeof(no_linger));
+    close(upserver);
+
+    // The first write after the reset reports ECONNRESET, the next ones EPIPE (which raises SIGPIPE in the kernel)
+    std::error_code ec;
+    for (int i = 0; i < 100 && ec != std::errc::broken_pipe; ++i) {  // NOLINT(readability-magic-numbers)
+        ASSERT_EQ(send(client, "x", 1, MSG_NOSIGNAL), 1);
+        poll(nullptr, 0, 1);
+        proxy.pump(ec);
+    }
+
+    EXPECT_EQ(ec, std::errc::broken_pipe);
+    EXPECT_EQ(sigpipe_count, 0);
+
+    sigset_t pending;
+    sigemptyset(&pending);
+    sigpending(&pending);
+    EXPECT_EQ(sigismember(&pending, SIGPIPE), 0);
+}
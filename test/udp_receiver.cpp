@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "sockutils.h"
+#include "udp_receiver.h"
+#include "utils.h"
+
+namespace {
+
+constexpr psb::socket_options_t opts{
+    .close_on_exec = 1, .reuse_addr = 0, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = 0
+};
+
+int connect_udp(int server)
+{
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    get_sock_name(server, ss, len);
+
+    const auto sock = create_socket(ss.ss_family, SOCK_DGRAM, 0);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (connect(sock, reinterpret_cast<const sockaddr*>(&ss), len) == -1) {
+        const auto err = errno;
+        close(sock);
+        throw std::system_error(err, std::system_category(), "connect");
+    }
+
+    return sock;
+}
+
+std::string_view as_string(const psb::udp_datagram_t& datagram)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return {reinterpret_cast<const char*>(datagram.data.data()), datagram.data.size()};
+}
+
+}  // namespace
+
+TEST(UdpReceiver, Batch)
+{
+    const auto server = psb::create_udp_socket("127.0.0.1", 0, opts);
+    auto close_server = gsl::finally([sock = server.sock]() { close(sock); });
+
+    int client{};
+    ASSERT_NO_THROW(client = connect_udp(server.sock));
+    auto close_client = gsl::finally([client]() { close(client); });
+
+    psb::udp_receiver receiver(server.sock, {.batch_size = 2, .buffer_size = 8, .gro = false});
+    EXPECT_TRUE(receiver.receive().empty());
+
+    constexpr std::array<std::string_view, 3> messages{"one", "", "too long to fit"};
+    for (const auto message : messages) {
+        ASSERT_EQ(send(client, message.data(), message.size(), 0), static_cast<ssize_t>(message.size()));
+    }
+
+    auto datagrams = receiver.receive();
+    ASSERT_EQ(datagrams.size(), 2);
+    EXPECT_EQ(as_string(datagrams[0]), "one");
+    EXPECT_FALSE(datagrams[0].truncated);
+    EXPECT_EQ(as_string(datagrams[1]), "");
+
+    sockaddr_storage client_addr{};
+    socklen_t client_len = sizeof(client_addr);
+    ASSERT_NO_THROW(get_sock_name(client, client_addr, client_len));
+    const auto peer     = psb::get_socket_info(*datagrams[0].addr, datagrams[0].addr_len);
+    const auto expected = psb::get_socket_info(client_addr, client_len);
+    EXPECT_EQ(peer.address, expected.address);
+    EXPECT_EQ(peer.port, expected.port);
+
+    datagrams = receiver.receive();
+    ASSERT_EQ(datagrams.size(), 1);
+    EXPECT_EQ(as_string(datagrams[0]), "too long");
+    EXPECT_TRUE(datagrams[0].truncated);
+
+    EXPECT_TRUE(receiver.receive().empty());
+}
+
+TEST(UdpReceiver, GroSplitsSegments)
+{
+    const auto server = psb::create_udp_socket("127.0.0.1", 0, opts);
+    auto close_server = gsl::finally([sock = server.sock]() { close(sock); });
+
+    std::unique_ptr<psb::udp_receiver> receiver;
+    try {
+        receiver = std::make_unique<psb::udp_receiver>(
+            server.sock, psb::udp_receiver_options_t{.batch_size = 4, .buffer_size = 0, .gro = true}
+        );
+    }
+    catch (const std::system_error& e) {
+        GTEST_SKIP() << "UDP_GRO not supported: " << e.what();
+    }
+
+    int client{};
+    ASSERT_NO_THROW(client = connect_udp(server.sock));
+    auto close_client = gsl::finally([client]() { close(client); });
+
+    // One send() with UDP_SEGMENT produces several datagrams, which loopback delivers coalesced to a GRO socket
+    constexpr int segment = 100;
+    if (setsockopt(client, SOL_UDP, UDP_SEGMENT, &segment, sizeof(segment)) == -1) {
+        GTEST_SKIP() << "UDP_SEGMENT not supported";
+    }
+
+    const std::string payload = std::string(segment, 'a') + std::string(segment, 'b') + std::string(segment / 2, 'c');
+    ASSERT_EQ(send(client, payload.data(), payload.size(), 0), static_cast<ssize_t>(payload.size()));
+
+    std::string received;
+    std::vector<std::size_t> sizes;
+    for (auto datagrams = receiver->receive(); !datagrams.empty(); datagrams = receiver->receive()) {
+        for (const auto& datagram : datagrams) {
+            received += as_string(datagram);
+            sizes.push_back(datagram.data.size());
+        }
+    }
+
+    EXPECT_EQ(received, payload);
+    EXPECT_EQ(sizes, (std::vector<std::size_t>{segment, segment, segment / 2}));
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "sockutils.h"
+#include "udp_receiver.h"
+#include "udp_sender.h"
+#include "utils.h"
+
+namespace {
+
+constexpr psb::socket_options_t opts{
+    .close_on_exec = 1, .reuse_addr = 0, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = 0
+};
+
+std::span<const std::byte> as_bytes(std::string_view s)
+{
+    return std::as_bytes(std::span(s));
+}
+
+std::string_view as_string(const psb::udp_datagram_t& datagram)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return {reinterpret_cast<const char*>(datagram.data.data()), datagram.data.size()};
+}
+
+}  // namespace
+
+TEST(UdpSender, FanOut)
+{
+    const auto sender_sock = psb::create_udp_socket("127.0.0.1", 0, opts);
+    const auto first       = psb::create_udp_socket("127.0.0.1", 0, opts);
+    const auto second      = psb::create_udp_socket("127.0.0.1", 0, opts);
+    auto close_sockets     = gsl::finally([&]() {
+        close(sender_sock.sock);
+        close(first.sock);
+        close(second.sock);
+    });
+
+    std::array<sockaddr_storage, 2> addrs{};
+    std::array<socklen_t, 2> lens{sizeof(sockaddr_storage), sizeof(sockaddr_storage)};
+    ASSERT_NO_THROW(get_sock_name(first.sock, addrs[0], lens[0]));
+    ASSERT_NO_THROW(get_sock_name(second.sock, addrs[1], lens[1]));
+
+    psb::udp_sender sender(sender_sock.sock, {.batch_size = 3});
+
+    // The same payload, gathered from two buffers, to both peers
+    constexpr std::string_view head = "hello, ";
+    constexpr std::string_view tail = "world";
+    const std::array<iovec, 2> iov{{
+        // NOLINTBEGIN(cppcoreguidelines-pro-type-const-cast)
+        {.iov_base = const_cast<char*>(head.data()), .iov_len = head.size()},
+        {.iov_base = const_cast<char*>(tail.data()), .iov_len = tail.size()},
+        // NOLINTEND(cppcoreguidelines-pro-type-const-cast)
+    }};
+
+    EXPECT_TRUE(sender.add(addrs[0], lens[0], iov));
+    EXPECT_TRUE(sender.add(addrs[1], lens[1], iov));
+    EXPECT_TRUE(sender.add(addrs[0], lens[0], as_bytes("bye")));
+    EXPECT_FALSE(sender.add(addrs[1], lens[1], as_bytes("no room")));
+    EXPECT_EQ(sender.pending(), 3);
+
+    const auto results = sender.flush();
+    ASSERT_EQ(results.size(), 3);
+    EXPECT_EQ(results[0].bytes, head.size() + tail.size());
+    EXPECT_FALSE(results[0].error);
+    EXPECT_EQ(results[1].bytes, head.size() + tail.size());
+    EXPECT_EQ(results[2].bytes, 3);
+    EXPECT_EQ(sender.pending(), 0);
+
+    psb::udp_receiver first_receiver(first.sock, {.batch_size = 0, .buffer_size = 0, .gro = false});
+    auto datagrams = first_receiver.receive();
+    ASSERT_EQ(datagrams.size(), 2);
+    EXPECT_EQ(as_string(datagrams[0]), "hello, world");
+    EXPECT_EQ(as_string(datagrams[1]), "bye");
+
+    psb::udp_receiver second_receiver(second.sock, {.batch_size = 0, .buffer_size = 0, .gro = false});
+    datagrams = second_receiver.receive();
+    ASSERT_EQ(datagrams.size(), 1);
+    EXPECT_EQ(as_string(datagrams[0]), "hello, world");
+}
+
+TEST(UdpSender, PartialFailure)
+{
+    const auto sender_sock = psb::create_udp_socket("127.0.0.1", 0, opts);
+    const auto peer        = psb::create_udp_socket("127.0.0.1", 0, opts);
+    auto close_sockets     = gsl::finally([&]() {
+        close(sender_sock.sock);
+        close(peer.sock);
+    });
+
+    sockaddr_storage good{};
+    socklen_t good_len = sizeof(good);
+    ASSERT_NO_THROW(get_sock_name(peer.sock, good, good_len));
+
+    // An IPv6 destination cannot be reached from an IPv4 socket
+    sockaddr_storage bad{};
+    socklen_t bad_len{};
+    ASSERT_EQ(psb::make_socket_address("::1", 9, bad, bad_len), std::errc{});
+
+    psb::udp_sender sender(sender_sock.sock, {.batch_size = 0});
+    sender.add(good, good_len, as_bytes("first"));
+    sender.add(bad, bad_len, as_bytes("lost"));
+    sender.add(good, good_len, as_bytes("third"));
+
+    const auto results = sender.flush();
+    ASSERT_EQ(results.size(), 3);
+    EXPECT_FALSE(results[0].error);
+    EXPECT_TRUE(results[1].error);
+    EXPECT_EQ(results[1].bytes, 0);
+    EXPECT_FALSE(results[2].error);
+    EXPECT_EQ(results[2].bytes, 5);
+
+    psb::udp_receiver receiver(peer.sock, {.batch_size = 0, .buffer_size = 0, .gro = false});
+    const auto datagrams = receiver.receive();
+    ASSERT_EQ(datagrams.size(), 2);
+    EXPECT_EQ(as_string(datagrams[1]), "third");
+}
+
+TEST(UdpSender, Segmented)
+{
+    const auto sender_sock = psb::create_udp_socket("127.0.0.1", 0, opts);
+    const auto peer        = psb::create_udp_socket("127.0.0.1", 0, opts);
+    auto close_sockets     = gsl::finally([&]() {
+        close(sender_sock.sock);
+        close(peer.sock);
+    });
+
+    sockaddr_storage addr{};
+    socklen_t len = sizeof(addr);
+    ASSERT_NO_THROW(get_sock_name(peer.sock, addr, len));
+
+    const std::string payload = std::string(100, 'a') + std::string(100, 'b') + std::string(10, 'c');
+
+    psb::udp_sender sender(sender_sock.sock, {.batch_size = 0});
+    sender.add_segmented(addr, len, as_bytes(payload), 100);  // NOLINT(readability-magic-numbers)
+
+    const auto results = sender.flush();
+    ASSERT_EQ(results.size(), 1);
+    if (results[0].error == std::errc::invalid_argument || results[0].error == std::errc::no_protocol_option) {
+        GTEST_SKIP() << "UDP_SEGMENT not supported";
+    }
+
+    EXPECT_FALSE(results[0].error);
+    EXPECT_EQ(results[0].bytes, payload.size());
+
+    // Without GRO, the receiver gets the individual datagrams
+    psb::udp_receiver receiver(peer.sock, {.batch_size = 0, .buffer_size = 0, .gro = false});
+    const auto datagrams = receiver.receive();
+    ASSERT_EQ(datagrams.size(), 3);
+    EXPECT_EQ(as_string(datagrams[0]), payload.substr(0, 100));
+    EXPECT_EQ(as_string(datagrams[1]), payload.substr(100, 100));
+    EXPECT_EQ(as_string(datagrams[2]), payload.substr(200));
+}
@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <format>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "sockutils.h"
+#include "uring_acceptor.h"
+#include "utils.h"
+
+TEST(UringAcceptor, Functional)
+{
+    const psb::socket_options_t opts{
+        .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+    };
+
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    psb::uring_acceptor acceptor(ls.sock, {.queue_depth = 0, .direct_descriptors = 0, .peer_address = 1});
+    EXPECT_EQ(acceptor.ring_fd() != -1, acceptor.is_multishot());
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(ls.sock, ss, len));
+
+    constexpr std::size_t client_count = 4;
+    std::vector<int> clients;
+    auto close_clients = gsl::finally([&clients]() {
+        for (const auto client : clients) {
+            close(client);
+        }
+    });
+
+    for (std::size_t i = 0; i < client_count; ++i) {
+        ASSERT_NO_THROW(clients.push_back(connect_to(ss, len)));
+    }
+
+    std::array<psb::raw_accepted_socket_t, client_count> accepted{};
+    std::size_t count = 0;
+    auto close_accepted = gsl::finally([&accepted, &count]() {
+        for (std::size_t i = 0; i < count; ++i) {
+            close(accepted.at(i).sock);
+        }
+    });
+
+    for (int attempt = 0; attempt < 10 && count < client_count; ++attempt) {
+        const auto result = acceptor.accept_connections(std::span(accepted).subspan(count), 1000);
+        ASSERT_FALSE(result.error) << result.error.message();
+        count += result.count;
+    }
+
+    ASSERT_EQ(count, client_count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& sock = accepted.at(i);
+        EXPECT_EQ(get_status_flags(sock.sock) & O_NONBLOCK, O_NONBLOCK);
+        EXPECT_EQ(get_fd_flags(sock.sock) & FD_CLOEXEC, FD_CLOEXEC);
+
+        const auto peer = psb::get_socket_info(sock);
+        EXPECT_EQ(peer.address, "127.0.0.1");
+        EXPECT_NE(peer.port, 0);
+    }
+}
+
+TEST(UringAcceptor, QuickAck)
+{
+    // TCP_QUICKACK is not supported on UNIX sockets, so the failure shows that it is set on the accepted socket
+    const psb::socket_options_t opts{
+        .close_on_exec        = 1,
+        .reuse_addr           = 0,
+        .free_bind            = 0,
+        .defer_accept_timeout = 0,
+        .listen_backlog       = SOMAXCONN,
+        .quick_ack            = 1,
+    };
+
+    const auto ls   = psb::create_listening_socket(std::format("@psb-sockutils-uring-{}", getpid()), 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    psb::uring_acceptor acceptor(
+        ls.sock, {.queue_depth = 0, .direct_descriptors = 0, .peer_address = 0, .socket_options = &opts}
+    );
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(ls.sock, ss, len));
+
+    int client{};
+    ASSERT_NO_THROW(client = connect_to(ss, len));
+    auto close_client = gsl::finally([client]() { close(client); });
+
+    std::array<psb::raw_accepted_socket_t, 1> accepted{};
+    psb::accept_batch_result_t result{};
+    for (int attempt = 0; attempt < 10 && result.count == 0; ++attempt) {
+        result = acceptor.accept_connections(accepted, 1000);
+    }
+
+    ASSERT_EQ(result.count, 1);
+    close(accepted.at(0).sock);
+    EXPECT_EQ(result.error, std::errc::operation_not_supported);
+}
+
+TEST(UringAcceptor, Timeout)
+{
+    const psb::socket_options_t opts{
+        .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+    };
+
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    psb::uring_acceptor acceptor(ls.sock, {.queue_depth = 0, .direct_descriptors = 0, .peer_address = 0});
+
+    std::array<psb::raw_accepted_socket_t, 4> accepted{};
+    const auto result = acceptor.accept_connections(accepted, 10);
+    EXPECT_EQ(result.count, 0);
+    EXPECT_FALSE(result.error);
+}
+
+TEST(UringAcceptor, DirectDescriptors)
+{
+    const psb::socket_options_t opts{
+        .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+    };
+
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    psb::uring_acceptor acceptor(ls.sock, {.queue_depth = 0, .direct_descriptors = 16, .peer_address = 1});
+    if (!acceptor.is_multishot()) {
+        GTEST_SKIP() << "io_uring multishot accept is not available";
+    }
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(ls.sock, ss, len));
+
+    int client{};
+    ASSERT_NO_THROW(client = connect_to(ss, len));
+    auto close_client = gsl::finally([client]() { close(client); });
+
+    std::array<psb::raw_accepted_socket_t, 1> accepted{};
+    const auto result = acceptor.accept_connections(accepted, 1000);
+    ASSERT_FALSE(result.error) << result.error.message();
+    ASSERT_EQ(result.count, 1);
+
+    // The socket lives in the registered file table, which is released together with the ring
+    EXPECT_GE(accepted[0].sock, 0);
+    EXPECT_LT(accepted[0].sock, 16);
+    EXPECT_EQ(accepted[0].addr_len, 0);
+}
+
+TEST(UringAcceptor, DestroyWithPendingConnections)
+{
+    const psb::socket_options_t opts{
+        .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+    };
+
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(ls.sock, ss, len));
+
+    constexpr std::size_t client_count = 4;
+    std::vector<int> clients;
+    auto close_clients = gsl::finally([&clients]() {
+        for (const auto client : clients) {
+            close(client);
+        }
+    });
+
+    const auto fds_before = count_open_fds();
+    {
+        psb::uring_acceptor acceptor(ls.sock, {.queue_depth = 0, .direct_descriptors = 0, .peer_address = 0});
+        if (!acceptor.is_multishot()) {
+            GTEST_SKIP() << "io_uring multishot accept is not available";
+        }
+
+        for (std::size_t i = 0; i < client_count; ++i) {
+            ASSERT_NO_THROW(clients.push_back(connect_to(ss, len)));
+        }
+
+        // The kernel installs the accepted sockets whether or not they are reaped
+        pollfd pfd{.fd = acceptor.ring_fd(), .events = POLLIN, .revents = 0};
+        ASSERT_EQ(poll(&pfd, 1, 1000), 1);
+        EXPECT_GT(count_open_fds(), fds_before + client_count);
+    }
+
+    EXPECT_EQ(count_open_fds(), fds_before + client_count);
+}
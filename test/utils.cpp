@@ -1,7 +1,10 @@
 #include "utils.h"
 
 #include <cerrno>
+#include <cstddef>
 #include <cstring>
+#include <filesystem>
+#include <iterator>
 
 #include <fcntl.h>
 #include <sys/socket.h>
@@ -78,3 +81,23 @@ int create_socket(int domain, int type, int protocol)
     syscall_succeeded(sock, "socket");
     return sock;
 }
+
+int connect_to(const sockaddr_storage& ss, socklen_t len)
+{
+    const auto sock = create_socket(ss.ss_family, SOCK_STREAM, 0);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (connect(sock, reinterpret_cast<const sockaddr*>(&ss), len) == -1) {
+        const auto err = errno;
+        close(sock);
+        throw std::system_error(err, std::system_category(), "connect");
+    }
+
+    return sock;
+}
+
+std::size_t count_open_fds()
+{
+    const std::filesystem::directory_iterator fds("/proc/self/fd");
+    // The iterator holds one descriptor of its own
+    return static_cast<std::size_t>(std::distance(begin(fds), end(fds))) - 1;
+}
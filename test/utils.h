@@ -1,6 +1,8 @@
 #ifndef D29F38ED_C6ED_40D1_8D66_70D5BD215292
 #define D29F38ED_C6ED_40D1_8D66_70D5BD215292
 
+#include <cstddef>
+
 #include <sys/socket.h>
 
 bool ipv6_supported();
@@ -9,5 +11,7 @@ int get_socket_option(int sock, int level, int optname);
 unsigned int get_fd_flags(int fd);
 unsigned int get_status_flags(int fd);
 int create_socket(int domain, int type, int protocol);
+int connect_to(const sockaddr_storage& ss, socklen_t len);
+std::size_t count_open_fds();
 
 #endif /* D29F38ED_C6ED_40D1_8D66_70D5BD215292 */
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "sockutils.h"
+#include "utils.h"
+#include "zerocopy_receiver.h"
+
+namespace {
+
+constexpr psb::socket_options_t opts{
+    .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+};
+
+/**
+ * Receives from @a receiver until @a expected bytes have arrived or the peer has closed the connection.
+ */
+std::vector<std::byte> receive_all(psb::zerocopy_receiver& receiver, int sock, std::size_t expected, bool& eof)
+{
+    std::vector<std::byte> data;
+    eof = false;
+    while (data.size() < expected || expected == 0) {
+        pollfd pfd{.fd = sock, .events = POLLIN, .revents = 0};
+        if (poll(&pfd, 1, 1000) <= 0) {  // NOLINT(readability-magic-numbers)
+            break;
+        }
+
+        const auto result = receiver.receive();
+        data.insert(data.end(), result.mapped.begin(), result.mapped.end());
+        data.insert(data.end(), result.copied.begin(), result.copied.end());
+        if (result.eof) {
+            eof = true;
+            break;
+        }
+    }
+
+    return data;
+}
+
+}  // namespace
+
+TEST(ZerocopyReceiver, ReceivesStream)
+{
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(ls.sock, ss, len));
+
+    int client{};
+    ASSERT_NO_THROW(client = connect_to(ss, len));
+    auto close_client = gsl::finally([&client]() {
+        if (client != -1) {
+            close(client);
+        }
+    });
+
+    const auto server = psb::accept_connection(ls.sock);
+    auto close_server = gsl::finally([sock = server.sock]() { close(sock); });
+
+    psb::zerocopy_receiver receiver(server.sock, {.map_size = 0, .copy_size = 0});
+
+    // Nothing to read yet
+    std::error_code ec;
+    auto result = receiver.receive(ec);
+    EXPECT_FALSE(ec);
+    EXPECT_TRUE(result.mapped.empty());
+    EXPECT_TRUE(result.copied.empty());
+    EXPECT_FALSE(result.eof);
+
+    // Whatever the kernel maps or copies, the bytes must arrive intact and in order
+    std::vector<std::byte> sent(100000);  // NOLINT(readability-magic-numbers)
+    for (std::size_t i = 0; i < sent.size(); ++i) {
+        sent[i] = static_cast<std::byte>(i % 251);  // NOLINT(readability-magic-numbers)
+    }
+
+    ASSERT_EQ(send(client, sent.data(), sent.size(), 0), static_cast<ssize_t>(sent.size()));
+
+    bool eof{};
+    const auto received = receive_all(receiver, server.sock, sent.size(), eof);
+    EXPECT_EQ(received, sent);
+    EXPECT_FALSE(eof);
+
+    close(client);
+    client = -1;
+    EXPECT_TRUE(receive_all(receiver, server.sock, 0, eof).empty());
+    EXPECT_TRUE(eof);
+}
+
+TEST(ZerocopyReceiver, FallsBackForNonTcpSockets)
+{
+    std::array<int, 2> fds{};
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()), 0);
+    auto close_fds = gsl::finally([&fds]() {
+        close(fds[0]);
+        close(fds[1]);
+    });
+
+    psb::zerocopy_receiver receiver(fds[0], {.map_size = 0, .copy_size = 0});
+    EXPECT_FALSE(receiver.is_zerocopy());
+
+    constexpr std::string_view message = "hello";
+    ASSERT_EQ(send(fds[1], message.data(), message.size(), 0), static_cast<ssize_t>(message.size()));
+
+    bool eof{};
+    const auto received = receive_all(receiver, fds[0], message.size(), eof);
+    EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(received.data()), received.size()), message);  // NOLINT
+}
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <system_error>
+#include <vector>
+
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+#include <poll.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <gsl/util>
+
+#include "sockutils.h"
+#include "utils.h"
+#include "zerocopy_sender.h"
+
+namespace {
+
+constexpr psb::socket_options_t opts{
+    .close_on_exec = 1, .reuse_addr = 1, .free_bind = 0, .defer_accept_timeout = 0, .listen_backlog = SOMAXCONN
+};
+
+constexpr std::size_t threshold = 4096;
+
+/**
+ * Reads and discards everything @a sock has received.
+ */
+std::size_t drain(int sock)
+{
+    std::vector<char> buf(65536);  // NOLINT(readability-magic-numbers)
+    std::size_t total = 0;
+    for (;;) {
+        const auto res = recv(sock, buf.data(), buf.size(), MSG_DONTWAIT);
+        if (res <= 0) {
+            return total;
+        }
+
+        total += static_cast<std::size_t>(res);
+    }
+}
+
+/**
+ * A connected loopback pair: `client` and the accepted `server`.
+ */
+struct connection_t {
+    int listener;
+    int client;
+    int server;
+};
+
+connection_t connect_loopback()
+{
+    const auto ls = psb::create_listening_socket("127.0.0.1", 0, opts);
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    get_sock_name(ls.sock, ss, len);
+
+    const auto client = connect_to(ss, len);
+    return {.listener = ls.sock, .client = client, .server = psb::accept_connection(ls.sock).sock};
+}
+
+/**
+ * Makes `setsockopt(SO_ZEROCOPY)` fail with `ENOPROTOOPT`, as on kernels before 4.14, for the rest of the process.
+ */
+bool hide_so_zerocopy()
+{
+    // NOLINTBEGIN(hicpp-signed-bitwise)
+    std::array<sock_filter, 6> filter{{
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(seccomp_data, nr)),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, SYS_setsockopt, 0, 3),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(seccomp_data, args) + 2 * sizeof(std::uint64_t)),  // optname
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, SO_ZEROCOPY, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | ENOPROTOOPT),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW),
+    }};
+    // NOLINTEND(hicpp-signed-bitwise)
+
+    const sock_fprog prog{.len = static_cast<unsigned short>(filter.size()), .filter = filter.data()};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    return prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) == 0 && prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &prog) == 0;
+}
+
+}  // namespace
+
+TEST(ZerocopySender, CompletionAccounting)
+{
+    const auto ls   = psb::create_listening_socket("127.0.0.1", 0, opts);
+    auto close_sock = gsl::finally([sock = ls.sock]() { close(sock); });
+
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    ASSERT_NO_THROW(get_sock_name(ls.sock, ss, len));
+
+    int client{};
+    ASSERT_NO_THROW(client = connect_to(ss, len));
+    auto close_client = gsl::finally([client]() { close(client); });
+
+    const auto server = psb::accept_connection(ls.sock);
+    auto close_server = gsl::finally([sock = server.sock]() { close(sock); });
+
+    psb::zerocopy_sender sender(server.sock, {.copy_threshold = threshold});
+
+    // Short writes are copied and complete immediately
+    const std::vector<std::byte> small(threshold - 1, std::byte{'s'});
+    auto result = sender.send(small, 0);
+    EXPECT_EQ(result.bytes, small.size());
+    EXPECT_FALSE(result.zerocopy);
+    EXPECT_EQ(sender.pending(), 0);
+
+    const std::vector<std::byte> large(threshold * 4, std::byte{'l'});
+    std::size_t sent = small.size();
+    for (std::uint64_t tag = 1; tag <= 3; ++tag) {
+        result = sender.send(large, tag);
+        EXPECT_EQ(result.bytes, large.size());
+        EXPECT_TRUE(result.zerocopy);
+        sent += result.bytes;
+    }
+
+    EXPECT_EQ(sender.pending(), 3);
+
+    std::size_t received = 0;
+    std::vector<std::uint64_t> completed;
+    const auto on_complete = [&completed](std::uint64_t tag, bool /*copied*/) { completed.push_back(tag); };
+    for (int attempt = 0; attempt < 100 && completed.size() < 3; ++attempt) {  // NOLINT(readability-magic-numbers)
+        received += drain(client);
+
+        pollfd pfd{.fd = server.sock, .events = 0, .revents = 0};
+        poll(&pfd, 1, 10);  // NOLINT(readability-magic-numbers)
+        sender.process_completions(on_complete);
+    }
+
+    received += drain(client);
+    EXPECT_EQ(received, sent);
+    EXPECT_EQ(completed, (std::vector<std::uint64_t>{1, 2, 3}));
+    EXPECT_EQ(sender.pending(), 0);
+}
+
+TEST(ZerocopySender, UnsupportedSocket)
+{
+    int sock{};
+    ASSERT_NO_THROW(sock = create_socket(AF_UNIX, SOCK_STREAM, 0));
+    auto close_socket = gsl::finally([sock]() { close(sock); });
+
+    EXPECT_THROW(psb::zerocopy_sender(sock, {.copy_threshold = 0}), std::system_error);
+}
+
+TEST(ZerocopySender, PendingLimit)
+{
+    const auto conn = connect_loopback();
+    auto close_all  = gsl::finally([&conn]() {
+        for (const auto fd : {conn.listener, conn.client, conn.server}) {
+            close(fd);
+        }
+    });
+
+    psb::zerocopy_sender sender(conn.server, {.copy_threshold = threshold, .max_pending = 2});
+
+    // Past the limit, writes are copied until completions make room
+    const std::vector<std::byte> large(threshold, std::byte{'l'});
+    EXPECT_TRUE(sender.send(large, 1).zerocopy);
+    EXPECT_TRUE(sender.send(large, 2).zerocopy);
+    EXPECT_FALSE(sender.send(large, 3).zerocopy);
+    EXPECT_EQ(sender.pending(), 2);
+
+    std::vector<std::uint64_t> completed;
+    const auto on_complete = [&completed](std::uint64_t tag, bool /*copied*/) { completed.push_back(tag); };
+    for (int attempt = 0; attempt < 100 && completed.size() < 2; ++attempt) {  // NOLINT(readability-magic-numbers)
+        drain(conn.client);
+
+        pollfd pfd{.fd = conn.server, .events = 0, .revents = 0};
+        poll(&pfd, 1, 10);  // NOLINT(readability-magic-numbers)
+        sender.process_completions(on_complete);
+    }
+
+    EXPECT_EQ(completed, (std::vector<std::uint64_t>{1, 2}));
+    EXPECT_EQ(sender.pending(), 0);
+    EXPECT_TRUE(sender.send(large, 4).zerocopy);
+}
+
+TEST(ZerocopySenderDeathTest, KernelWithoutSoZerocopy)
+{
+    // The filter cannot be removed, so this runs in a child process
+    EXPECT_EXIT(
+        {
+            const auto conn = connect_loopback();
+            if (!hide_so_zerocopy()) {
+                std::exit(2);  // NOLINT(concurrency-mt-unsafe)
+            }
+
+            psb::zerocopy_sender sender(conn.server, {.copy_threshold = threshold});
+            const std::vector<std::byte> large(threshold * 4, std::byte{'l'});
+            const auto result = sender.send(large, 1);
+
+            const bool copied = !sender.is_zerocopy() && result.bytes == large.size() && !result.zerocopy &&
+                                sender.pending() == 0;
+            std::exit(copied ? 0 : 1);  // NOLINT(concurrency-mt-unsafe)
+        },
+        ::testing::ExitedWithCode(0), ""
+    );
+}